@@ -118,6 +118,7 @@ PGAPI_BindParameter(HSTMT hstmt,
 	{
 		free(pdata_info->pdata[ipar].EXEC_buffer);
 		pdata_info->pdata[ipar].EXEC_buffer = NULL;
+		pdata_info->pdata[ipar].EXEC_buflen = 0;
 	}
 
 	if (pcbValue && apdopts->param_offset_ptr)
@@ -480,6 +481,7 @@ create_empty_bindings(int num_columns)
 		new_bindings[i].buffer = NULL;
 		new_bindings[i].used =
 		new_bindings[i].indicator = NULL;
+		new_bindings[i].fetch_kernel = 0;
 	}
 
 	return new_bindings;
@@ -676,6 +678,7 @@ PDATA_free_params(PutDataInfo *pdata, char option)
 		{
 			free(pdata->pdata[i].EXEC_buffer);
 			pdata->pdata[i].EXEC_buffer = NULL;
+			pdata->pdata[i].EXEC_buflen = 0;
 		}
 	}
 
@@ -838,6 +841,8 @@ void GetDataInfoInitialize(GetDataInfo *gdata_info)
 	GETDATA_RESET(gdata_info->fdata);
 	gdata_info->fdata.ttlbuf = NULL;
 	gdata_info->fdata.ttlbuflen = gdata_info->fdata.ttlbufused = 0;
+	gdata_info->fdata.blob.buf = NULL;
+	gdata_info->fdata.blob.buflen = 0;
 	gdata_info->allocated = 0;
 	gdata_info->gdata = NULL;
 }
@@ -856,6 +861,8 @@ create_empty_gdata(int num_columns)
 		new_gdata[i].ttlbuf = NULL;
 		new_gdata[i].ttlbuflen = 0;
 		new_gdata[i].ttlbufused = 0;
+		new_gdata[i].blob.buf = NULL;
+		new_gdata[i].blob.buflen = 0;
 	}
 
 	return new_gdata;
@@ -931,6 +938,12 @@ void	reset_a_getdata_info(GetDataInfo *gdata_info, int icol)
 	}
 	gdata_info->gdata[icol].ttlbuflen =
 	gdata_info->gdata[icol].ttlbufused = 0;
+	if (gdata_info->gdata[icol].blob.buf)
+	{
+		free(gdata_info->gdata[icol].blob.buf);
+		gdata_info->gdata[icol].blob.buf = NULL;
+	}
+	gdata_info->gdata[icol].blob.buflen = 0;
 	GETDATA_RESET(gdata_info->gdata[icol]);
 }
 
@@ -1002,6 +1015,7 @@ void	reset_a_putdata_info(PutDataInfo *pdata_info, int ipar)
 	{
 		free(pdata_info->pdata[ipar].EXEC_buffer);
 		pdata_info->pdata[ipar].EXEC_buffer = NULL;
+		pdata_info->pdata[ipar].EXEC_buflen = 0;
 	}
 	pdata_info->pdata[ipar].lobj_oid = 0;
 }
@@ -29,6 +29,9 @@ struct BindInfoClass_
 	SQLSMALLINT	scale;		/* the scale for numeric type */
 	/* area for work variables */
 	char	dummy_data;		/* currently not used */
+	char	fetch_kernel;		/* the conversion of the column is
+					 * done per rowset (see
+					 * setup_columnar_fetch()) */
 };
 
 /* struct for SQLGetData */
@@ -38,6 +41,12 @@ typedef struct
 	struct GetBlobDataClass {
 		Int8	data_left64;	/* amount of large object data
 					   left to read before conversion */
+		Int8	read_offset;	/* offset of the next read from the
+					   large object */
+		char	*buf;		/* the data read ahead (LOReadAheadSize) */
+		Int4	buflen;		/* the buffer length */
+		Int4	bufused;	/* length of the data read ahead */
+		Int4	bufpos;		/* the data already returned */
 	} blob;
 	/* for non-BLOBs which hold the data in ttlbuf after conversion */
 	char	*ttlbuf;		/* to save the large result */
@@ -67,6 +76,7 @@ typedef struct
 {
 	SQLLEN	*EXEC_used;	/* amount of data */
 	char	*EXEC_buffer; 	/* the data */
+	SQLLEN	EXEC_buflen;	/* allocated length of EXEC_buffer */
 	OID	lobj_oid;
 }	PutDataClass;
 
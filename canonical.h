@@ -0,0 +1,210 @@
+/* File:			canonical.h
+ *
+ * Description:		Parsing of the canonical text output of the server
+ *					without sscanf() and atof(), used by convert.c. The
+ *					functions are static so that the regression tests can
+ *					compare them with the library functions.
+ *
+ * Comments:		See "readme.txt" for copyright and license information.
+ *
+ */
+
+#ifndef __CANONICAL_H__
+#define __CANONICAL_H__
+
+#include "psqlodbc.h"
+#include <ctype.h>
+#include <float.h>
+#include <string.h>
+
+typedef struct
+{
+	int		infinity;
+	int			m;
+	int			d;
+	int			y;
+	int			hh;
+	int			mm;
+	int			ss;
+	int			fr;
+} SIMPLE_TIME;
+
+/* the value of the 2 digits at s, FALSE unless both are digits */
+static BOOL
+get_2digits(const char *s, int *val)
+{
+	if (!isdigit((UCHAR) s[0]) || !isdigit((UCHAR) s[1]))
+		return FALSE;
+	*val = (s[0] - '0') * 10 + (s[1] - '0');
+	return TRUE;
+}
+
+/*
+ * Parse the canonical output of the server without sscanf(), i.e.
+ * "YYYY-MM-DD", "HH:MM:SS" or "YYYY-MM-DD HH:MM:SS" followed by the
+ * optional fraction, time zone and " BC".
+ * FALSE if str isn't of the form, and timestamp2stime() parses it then.
+ */
+static BOOL
+parse_canonical_timestamp(const char *str, SIMPLE_TIME *st, BOOL *bZone, int *zone)
+{
+	const char	*p = str;
+	int			y = 0, m = 0, d = 0, hh = 0, mm = 0, ss = 0, fr = 0;
+	int			yy, i, tz = 0;
+	BOOL		date, tzexist = FALSE, bc = FALSE;
+
+	date = (get_2digits(p, &y) && get_2digits(p + 2, &yy) &&
+			'-' == p[4] && get_2digits(p + 5, &m) &&
+			'-' == p[7] && get_2digits(p + 8, &d));
+	if (date)
+	{
+		y = y * 100 + yy;
+		p += 10;
+		if ('\0' == *p)
+			goto done;
+		if (' ' != *p)
+			return FALSE;
+		p++;
+	}
+	if (!get_2digits(p, &hh) || ':' != p[2] ||
+		!get_2digits(p + 3, &mm) || ':' != p[5] ||
+		!get_2digits(p + 6, &ss))
+		return FALSE;
+	p += 8;
+	if ('.' == *p)
+	{
+		/* in nanoseconds */
+		for (i = 0, p++; isdigit((UCHAR) *p); i++, p++)
+		{
+			if (i >= 9)
+				return FALSE;
+			fr = fr * 10 + (*p - '0');
+		}
+		if (0 == i)
+			return FALSE;
+		for (; i < 9; i++)
+			fr *= 10;
+	}
+	if ('+' == *p || '-' == *p)
+	{
+		/* only the hours as atoi() does */
+		BOOL	minus = ('-' == *p);
+
+		if (!isdigit((UCHAR) *(++p)))
+			return FALSE;
+		for (; isdigit((UCHAR) *p); p++)
+			tz = tz * 10 + (*p - '0');
+		while (':' == *p && isdigit((UCHAR) p[1]))
+			for (p++; isdigit((UCHAR) *p); p++)
+				;
+		tzexist = TRUE;
+		if (minus)
+			tz = -tz;
+	}
+	if (date && 0 == strcmp(p, " BC"))
+	{
+		bc = TRUE;
+		p += 3;
+	}
+	if ('\0' != *p)
+		return FALSE;
+done:
+	if (date)
+	{
+		st->y = bc ? -y : y;
+		st->m = m;
+		st->d = d;
+	}
+	st->hh = hh;
+	st->mm = mm;
+	st->ss = ss;
+	st->fr = fr;
+	*bZone = tzexist;
+	*zone = tz;
+	return TRUE;
+}
+
+/*
+ * Convert the canonical output of a float or numeric value, e.g.
+ * "-123.45" or "1.5e-07", without atof() and the locale.  Only the values
+ * of up to 15 significant digits with a power of 10 up to 22 are taken,
+ * so that a single multiplication or division rounds them correctly.
+ * FALSE for anything else, e.g. NaN or more digits.
+ */
+#if (defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD == 0) || defined(_M_X64) || defined(_M_ARM64)
+static BOOL
+parse_canonical_double(const char *str, double *val)
+{
+	static const double	pow10tbl[] = {
+		1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10,
+		1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20,
+		1e21, 1e22
+	};
+	const char	*p = str;
+	int			ndigits = 0, exp10 = 0, expval = 0;
+	BOOL		minus = FALSE, expminus = FALSE, digit_exist = FALSE;
+	double		dval = 0;
+
+	if ('-' == *p)
+	{
+		minus = TRUE;
+		p++;
+	}
+	for (;; p++)
+	{
+		if ('.' == *p)
+		{
+			if (exp10 < 0 || !isdigit((UCHAR) p[1]))
+				return FALSE;
+			exp10 = -1;
+			continue;
+		}
+		if (!isdigit((UCHAR) *p))
+			break;
+		digit_exist = TRUE;
+		if (exp10 < 0)
+			exp10--;
+		/* leading zeros aren't significant */
+		if (0 == ndigits && '0' == *p)
+			continue;
+		/* exact while less than 2^53 */
+		if (++ndigits > 15)
+			return FALSE;
+		dval = dval * 10 + (*p - '0');
+	}
+	if (!digit_exist)
+		return FALSE;
+	if (exp10 < 0)
+		exp10++;
+	if ('e' == *p || 'E' == *p)
+	{
+		p++;
+		if ('-' == *p || '+' == *p)
+			expminus = ('-' == *p++);
+		if (!isdigit((UCHAR) *p))
+			return FALSE;
+		for (; isdigit((UCHAR) *p); p++)
+		{
+			if ((expval = expval * 10 + (*p - '0')) > 400)
+				return FALSE;
+		}
+		exp10 += expminus ? -expval : expval;
+	}
+	if ('\0' != *p)
+		return FALSE;
+	if (0 == ndigits)
+		;
+	else if (exp10 < 0 && exp10 >= -22)
+		dval /= pow10tbl[-exp10];
+	else if (exp10 >= 0 && exp10 <= 22)
+		dval *= pow10tbl[exp10];
+	else
+		return FALSE;
+	*val = minus ? -dval : dval;
+	return TRUE;
+}
+#else
+#define	parse_canonical_double(str, val)	FALSE
+#endif /* FLT_EVAL_METHOD */
+
+#endif /* __CANONICAL_H__ */
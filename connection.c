@@ -51,7 +51,15 @@
 								 * at a time */
 
 static SQLRETURN CC_lookup_lo(ConnectionClass *self);
+static void CC_set_lo_type(ConnectionClass *self, const QResultClass *res);
+static const char *CC_isolation_query(UInt4 isolation);
 static int  CC_close_eof_cursors(ConnectionClass *self);
+static void add_metrics(PG_Metrics *to, const PG_Metrics *from);
+static void CC_clear_query_metrics(ConnectionClass *self);
+static void CC_clear_plan_cache(ConnectionClass *self);
+static void CC_clear_query_cache(ConnectionClass *self);
+static PGresult *async_next_result(ASYNC_QUERY *aq);
+static void CC_free_async_query(ConnectionClass *self);
 
 static void LIBPQ_update_transaction_status(ConnectionClass *self);
 
@@ -459,6 +467,7 @@ CSTR	rbkcmd = "ROLLBACK";
 CSTR	svpcmd = "SAVEPOINT";
 CSTR	per_query_svp = "_per_query_svp_";
 CSTR	rlscmd = "RELEASE";
+CSTR	prefetch_svpname = "_prefetch_svp_";
 
 /*
  *	Used to begin a transaction.
@@ -573,6 +582,155 @@ CC_clear_col_info(ConnectionClass *self, BOOL destroy)
 			self->coli_allocated = 0;
 		}
 	}
+	if (destroy)
+	{
+		if (self->coli_name_hash)
+			free(self->coli_name_hash);
+		self->coli_name_hash = NULL;
+		if (self->coli_oid_hash)
+			free(self->coli_oid_hash);
+		self->coli_oid_hash = NULL;
+	}
+	else
+		CC_index_col_info(self);
+}
+
+#define	COLI_HASH_SIZE	256
+
+/*
+ * (Re)build the hash tables of the cached table info. It's called
+ * whenever conn->col_info[] is changed.
+ */
+void
+CC_index_col_info(ConnectionClass *self)
+{
+	int		i;
+	COL_INFO	*coli;
+	UInt4		hval;
+
+	if (NULL == self->coli_name_hash)
+	{
+		if (0 == self->ntables)
+			return;
+		self->coli_name_hash = (COL_INFO **) malloc(sizeof(COL_INFO *) * COLI_HASH_SIZE);
+		self->coli_oid_hash = (COL_INFO **) malloc(sizeof(COL_INFO *) * COLI_HASH_SIZE);
+		if (NULL == self->coli_name_hash || NULL == self->coli_oid_hash)
+		{
+			/* fall back to the linear search */
+			if (self->coli_name_hash)
+				free(self->coli_name_hash);
+			self->coli_name_hash = NULL;
+			if (self->coli_oid_hash)
+				free(self->coli_oid_hash);
+			self->coli_oid_hash = NULL;
+			return;
+		}
+	}
+	memset(self->coli_name_hash, 0, sizeof(COL_INFO *) * COLI_HASH_SIZE);
+	memset(self->coli_oid_hash, 0, sizeof(COL_INFO *) * COLI_HASH_SIZE);
+	/* chain backwards so that the former entries are found first */
+	for (i = self->ntables - 1; i >= 0; i--)
+	{
+		coli = self->col_info[i];
+		coli->name_next = coli->oid_next = NULL;
+		if (NAME_IS_VALID(coli->table_name))
+		{
+			hval = hash_names_icase(SAFE_NAME(coli->schema_name), GET_NAME(coli->table_name)) % COLI_HASH_SIZE;
+			coli->name_next = self->coli_name_hash[hval];
+			self->coli_name_hash[hval] = coli;
+		}
+		if (0 != coli->table_oid)
+		{
+			hval = coli->table_oid % COLI_HASH_SIZE;
+			coli->oid_next = self->coli_oid_hash[hval];
+			self->coli_oid_hash[hval] = coli;
+		}
+	}
+}
+
+/* Look up the cached table info by the schema and table names */
+COL_INFO *
+CC_find_col_info(const ConnectionClass *self, const char *schema_name, const char *table_name)
+{
+	COL_INFO	*coli;
+	int		i;
+
+	if (NULL != self->coli_name_hash)
+	{
+		for (coli = self->coli_name_hash[hash_names_icase(schema_name, table_name) % COLI_HASH_SIZE]; NULL != coli; coli = coli->name_next)
+		{
+			if (!stricmp(SAFE_NAME(coli->table_name), table_name) &&
+			    !stricmp(SAFE_NAME(coli->schema_name), schema_name))
+				return coli;
+		}
+		return NULL;
+	}
+	for (i = 0; i < self->ntables; i++)
+	{
+		coli = self->col_info[i];
+		if (!stricmp(SAFE_NAME(coli->table_name), table_name) &&
+		    !stricmp(SAFE_NAME(coli->schema_name), schema_name))
+			return coli;
+	}
+	return NULL;
+}
+
+/* Look up the cached table info by the table oid */
+COL_INFO *
+CC_find_col_info_by_oid(const ConnectionClass *self, OID table_oid)
+{
+	COL_INFO	*coli;
+	int		i;
+
+	if (NULL != self->coli_oid_hash)
+	{
+		for (coli = self->coli_oid_hash[table_oid % COLI_HASH_SIZE]; NULL != coli; coli = coli->oid_next)
+		{
+			if (coli->table_oid == table_oid)
+				return coli;
+		}
+		return NULL;
+	}
+	for (i = 0; i < self->ntables; i++)
+	{
+		coli = self->col_info[i];
+		if (coli->table_oid == table_oid)
+			return coli;
+	}
+	return NULL;
+}
+
+/*
+ * Make the key of the column information shared among the connections,
+ * i.e. the database and the user connected to, and the options which
+ * change the types, sizes or columns PGAPI_Columns() returns. Returns
+ * FALSE if the column information isn't shared.
+ */
+BOOL
+CC_get_coli_share_key(const ConnectionClass *self, char *key, size_t keysize)
+{
+	const ConnInfo	*ci = &(self->connInfo);
+	const char	*host, *port, *db, *user;
+	int		len;
+
+	if (0 >= ci->coli_cache_ttl || NULL == self->pqconn)
+		return FALSE;
+	host = PQhost(self->pqconn);
+	port = PQport(self->pqconn);
+	db = PQdb(self->pqconn);
+	user = PQuser(self->pqconn);
+	len = snprintf(key, keysize, "%s:%s/%s/%s/%d,%d,%d,%d,%d,%d,%s,%s,%s",
+				   host ? host : NULL_STRING, port ? port : NULL_STRING,
+				   db ? db : NULL_STRING, user ? user : NULL_STRING,
+				   ci->drivers.unknown_sizes,
+				   ci->drivers.max_varchar_size,
+				   ci->drivers.max_longvarchar_size,
+				   ci->drivers.text_as_longvarchar,
+				   ci->drivers.unknowns_as_longvarchar,
+				   ci->drivers.bools_as_char,
+				   ci->show_oid_column, ci->fake_oid_index,
+				   ci->row_versioning);
+	return (len > 0 && len < (int) keysize);
 }
 
 static void
@@ -661,15 +819,43 @@ CC_cleanup(ConnectionClass *self, BOOL keepCommunication)
 	MYLOG(0, "entering self=%p\n", self);
 
 	ENTER_CONN_CS(self);
+	if (CC_collects_metrics(self) && get_mylog() > 0)
+	{
+		char	report[4096];
+
+		CC_metrics_report(self, report, sizeof(report));
+		MYLOG(0, "metrics:\n%s", report);
+	}
 	/* Cancel an ongoing transaction */
 	/* We are always in the middle of a transaction, */
 	/* even if we are in auto commit. */
+	CC_discard_async_query(self);
+	CC_finish_prefetch(self);
 	if (self->pqconn)
 	{
-		QLOG(0, "PQfinish: %p\n", self->pqconn);
-		PQfinish(self->pqconn);
+		/* park an idle connection in the connection pool */
+		if (!keepCommunication &&
+		    NULL != self->pool_key &&
+		    CONN_CONNECTED == self->status &&
+		    CONNECTION_OK == PQstatus(self->pqconn) &&
+		    PQTRANS_IDLE == PQtransactionStatus(self->pqconn) &&
+#ifdef	_HANDLE_ENLIST_IN_DTC_
+		    NULL == self->asdum &&
+#endif /* _HANDLE_ENLIST_IN_DTC_ */
+		    EN_park_pqconn(self->pool_key, self->pqconn, self->connInfo.pool_size))
+			QLOG(0, "parked: %p\n", self->pqconn);
+		else
+		{
+			QLOG(0, "PQfinish: %p\n", self->pqconn);
+			PQfinish(self->pqconn);
+		}
 		self->pqconn = NULL;
 	}
+	if (!keepCommunication && NULL != self->pool_key)
+	{
+		free(self->pool_key);
+		self->pool_key = NULL;
+	}
 
 	MYLOG(0, "after PQfinish\n");
 
@@ -713,6 +899,8 @@ CC_cleanup(ConnectionClass *self, BOOL keepCommunication)
 		self->status = CONN_NOT_CONNECTED;
 		self->transact_status = CONN_IN_AUTOCOMMIT;
 		self->unnamed_prepared_stmt = NULL;
+		memset(&self->metrics, 0, sizeof(self->metrics));
+		CC_clear_query_metrics(self);
 	}
 	if (!keepCommunication)
 	{
@@ -736,6 +924,9 @@ CC_cleanup(ConnectionClass *self, BOOL keepCommunication)
 	}
 	/* Free cached table info */
 	CC_clear_col_info(self, TRUE);
+	/* the plans were freed with the statements or the session */
+	CC_clear_plan_cache(self);
+	CC_clear_query_cache(self);
 	if (self->num_discardp > 0 && self->discardp)
 	{
 		for (i = 0; i < self->num_discardp; i++)
@@ -1069,31 +1260,109 @@ static int handle_show_results(const QResultClass *res);
 #define	TRANSACTION_ISOLATION "transaction_isolation"
 #define	ISOLATION_SHOW_QUERY "show " TRANSACTION_ISOLATION
 
+#define	INITIAL_SETTINGS_QUERY "SET DateStyle = 'ISO';SET extra_float_digits = 2;" ISOLATION_SHOW_QUERY
+#define	LO_LOOKUP_QUERY "select oid, typbasetype from pg_type where typname = '"  PG_TYPE_LO_NAME "'"
+
 static int LIBPQ_connect(ConnectionClass *self);
 static char
 LIBPQ_CC_connect(ConnectionClass *self, char *salt_para)
 {
-	int		ret;
 	CSTR		func = "LIBPQ_CC_connect";
-	QResultClass	*res;
 
 	MYLOG(0, "entering...\n");
 
 	if (0 == CC_initial_log(self, func))
 		return 0;
 
-	if (ret = LIBPQ_connect(self), ret <= 0)
-		return ret;
-	res = CC_send_query(self, "SET DateStyle = 'ISO';SET extra_float_digits = 2;" ISOLATION_SHOW_QUERY, NULL, READ_ONLY_QUERY, NULL);
-	if (QR_command_maybe_successful(res))
+	return LIBPQ_connect(self);
+}
+
+/*
+ *	Can the connect-time settings be sent in one query ?
+ *	ConnSettings is sent one statement by one as before, so that a failing
+ *	statement doesn't prevent the others and no statement is executed twice.
+ */
+static BOOL
+CC_can_send_initial_settings(const ConnectionClass *self)
+{
+	const char	*conn_settings = GET_NAME(self->connInfo.conn_settings);
+
+	if (NULL != conn_settings && '\0' != conn_settings[0])
+		return FALSE;
+	if (PG_VERSION_LT(self, 8.0) &&
+		(self->isolation == SQL_TXN_READ_UNCOMMITTED ||
+		 self->isolation == SQL_TXN_REPEATABLE_READ))
+		return FALSE;
+	return TRUE;
+}
+
+/*
+ *	Send all the connect-time settings in one multi-statement query.
+ *	The statements are
+ *		the DateStyle etc (INITIAL_SETTINGS_QUERY),
+ *		the large object type lookup,
+ *		SET client_encoding (only when it differs from the startup value),
+ *		the isolation level SET (only when it was requested).
+ *	The server executes them in an implicit transaction, so nothing
+ *	is left behind when one of them fails. Returns FALSE in that case.
+ */
+static BOOL
+CC_send_initial_settings(ConnectionClass *self, const char *encoding)
+{
+	const char	*dbencoding = PQparameterStatus(self->pqconn, "client_encoding");
+	const char	*isolation_query = NULL;
+	PQExpBufferData	query = {0};
+	QResultClass	*res, *qres;
+	BOOL		ret = FALSE;
+	int		i;
+
+	MYLOG(0, "entering...\n");
+
+	if (0 != self->isolation)
+		isolation_query = CC_isolation_query(self->isolation);
+
+	initPQExpBuffer(&query);
+	appendPQExpBufferStr(&query, INITIAL_SETTINGS_QUERY ";" LO_LOOKUP_QUERY);
+	if (encoding && (!dbencoding || stricmp(encoding, dbencoding)))
+		appendPQExpBuffer(&query, ";set client_encoding to '%s'", encoding);
+	if (NULL != isolation_query)
+		appendPQExpBuffer(&query, ";%s", isolation_query);
+	if (PQExpBufferDataBroken(query))
 	{
-		handle_show_results(res);
-		ret = 1;
+		CC_set_error(self, CONN_NO_MEMORY_ERROR, "Couldn't alloc buffer for query.", __FUNCTION__);
+		return FALSE;
 	}
-	else
-		ret = 0;
-	QR_Destructor(res);
 
+	res = CC_send_query(self, query.data, NULL, READ_ONLY_QUERY, NULL);
+	termPQExpBuffer(&query);
+	for (qres = res; qres; qres = QR_nextr(qres))
+	{
+		if (!QR_command_maybe_successful(qres))
+		{
+			if (CC_get_errornumber(self) <= 0)
+				CC_set_error(self, CONN_EXEC_ERROR, NULL != QR_get_message(qres) ? QR_get_message(qres) : "The initial settings failed", __FUNCTION__);
+			goto cleanup;
+		}
+	}
+	/* the lo lookup is the 4th statement */
+	for (i = 0, qres = res; i < 3 && NULL != qres; i++)
+		qres = QR_nextr(qres);
+	if (NULL == qres)
+	{
+		if (CC_get_errornumber(self) <= 0)
+			CC_set_error(self, CONN_EXEC_ERROR, "The initial settings returned too few results", __FUNCTION__);
+		goto cleanup;
+	}
+	handle_show_results(res);
+	CC_set_lo_type(self, qres);
+	CC_set_client_encoding(self, encoding);
+	if (NULL != isolation_query)
+		self->server_isolation = self->isolation;
+	ret = TRUE;
+
+cleanup:
+	QR_Destructor(res);
+	MYLOG(0, "leaving...%d\n", ret);
 	return ret;
 }
 
@@ -1103,19 +1372,66 @@ CC_connect(ConnectionClass *self, char *salt_para)
 	ConnInfo *ci = &(self->connInfo);
 	CSTR	func = "CC_connect";
 	char		ret, *saverr = NULL, retsend;
-	const char	*errmsg = NULL;
+	const char	*errmsg = NULL, *encoding;
+	QResultClass	*res;
+	BOOL		chunk_size_changed = FALSE;
 
 	MYLOG(0, "entering...sslmode=%s\n", self->connInfo.sslmode);
 
 	ret = LIBPQ_CC_connect(self, salt_para);
 	if (ret <= 0)
 		return ret;
+#ifndef	HAVE_PQSETCHUNKEDROWSMODE
+	/* libpq before 17 hands over the rows only one by one */
+	if (ci->result_chunk_size > 1)
+	{
+		MYLOG(0, "ResultChunkSize=%d needs libpq 17, changed to 1\n", ci->result_chunk_size);
+		ci->result_chunk_size = 1;
+		chunk_size_changed = TRUE;
+	}
+#endif /* HAVE_PQSETCHUNKEDROWSMODE */
 
 	CC_set_translation(self);
 
+	/*
+	 *		Multibyte handling
+	 *
+	 *	Send 'UTF8' when required Unicode behavior, otherwise send
+	 *	locale encodings.
+	 */
+	CC_determine_locale_encoding(self); /* determine the locale_encoding */
+#ifdef UNICODE_SUPPORT
+	if (CC_is_in_unicode_driver(self))
+		encoding = "UTF8";
+	else	/* for unicode drivers require ANSI behavior */
+#endif /* UNICODE_SUPPORT */
+		encoding = self->locale_encoding;
+
 	/*
 	 * Send any initial settings
 	 */
+	retsend = TRUE;
+	if (CC_can_send_initial_settings(self))
+	{
+		if (CC_send_initial_settings(self, encoding))
+			goto settings_sent;
+		ret = 0;
+		goto cleanup;
+	}
+
+	/*
+	 * Send them one by one so that the failure of a ConnSettings
+	 * statement doesn't prevent the others.
+	 */
+	res = CC_send_query(self, INITIAL_SETTINGS_QUERY, NULL, READ_ONLY_QUERY, NULL);
+	if (!QR_command_maybe_successful(res))
+	{
+		QR_Destructor(res);
+		ret = 0;
+		goto cleanup;
+	}
+	handle_show_results(res);
+	QR_Destructor(res);
 
 	/*
 	 * Since these functions allocate statements, and since the connection
@@ -1143,31 +1459,11 @@ CC_connect(ConnectionClass *self, char *salt_para)
 		goto cleanup;
 	}
 
-	/*
-	 *		Multibyte handling
-	 *
-	 *	Send 'UTF8' when required Unicode behavior, otherwise send
-	 *	locale encodings.
-	 */
 	CC_clear_error(self);
-	CC_determine_locale_encoding(self); /* determine the locale_encoding */
-#ifdef UNICODE_SUPPORT
-	if (CC_is_in_unicode_driver(self))
+	if (!SQL_SUCCEEDED(CC_send_client_encoding(self, encoding)))
 	{
-		if (!SQL_SUCCEEDED(CC_send_client_encoding(self, "UTF8")))
-		{
-			ret = 0;
-			goto cleanup;
-		}
-	}
-	else	/* for unicode drivers require ANSI behavior */
-#endif /* UNICODE_SUPPORT */
-	{
-		if (!SQL_SUCCEEDED(CC_send_client_encoding(self, self->locale_encoding)))
-		{
-			ret = 0;
-			goto cleanup;
-		}
+		ret = 0;
+		goto cleanup;
 	}
 
 	CC_clear_error(self);
@@ -1178,6 +1474,7 @@ CC_connect(ConnectionClass *self, char *salt_para)
 			goto cleanup;
 		}
 
+settings_sent:
 	ci_updatable_cursors_set(ci);
 
 	if (CC_get_errornumber(self) > 0)
@@ -1199,6 +1496,11 @@ cleanup:
 	}
 	if (1 == ret && FALSE == retsend)
 		ret = 2;
+	if (1 == ret && chunk_size_changed)
+	{
+		CC_set_error(self, CONN_OPTION_VALUE_CHANGED, "ResultChunkSize greater than 1 needs libpq 17 or later, the rows are read one by one", func);
+		ret = 2;
+	}
 
 	return ret;
 }
@@ -1289,6 +1591,182 @@ CC_remove_statement(ConnectionClass *self, StatementClass *stmt)
 	return ret;
 }
 
+static void
+add_metrics(PG_Metrics *to, const PG_Metrics *from)
+{
+	to->executes += from->executes;
+	to->exec_usec += from->exec_usec;
+	to->rows += from->rows;
+	to->bytes += from->bytes;
+	to->convert_usec += from->convert_usec;
+}
+
+/*
+ *	The caller must hold the connection lock.
+ */
+static void
+CC_clear_query_metrics(ConnectionClass *self)
+{
+	int	i;
+
+	for (i = 0; i < self->num_query_metrics; i++)
+		free(self->query_metrics[i].name);
+	if (self->query_metrics)
+		free(self->query_metrics);
+	self->query_metrics = NULL;
+	self->num_query_metrics = 0;
+	for (i = 0; i < self->num_stmts; i++)
+	{
+		if (self->stmts[i])
+			self->stmts[i]->metrics_idx = -1;
+	}
+}
+
+void
+CC_reset_metrics(ConnectionClass *self)
+{
+	CONNLOCK_ACQUIRE(self);
+	memset(&self->metrics, 0, sizeof(self->metrics));
+	CC_clear_query_metrics(self);
+	CONNLOCK_RELEASE(self);
+}
+
+#define	MAX_QUERY_METRICS	256	/* the other queries are put together */
+#define	MAX_METRICS_NAME_LEN	256
+
+/*
+ *	Normalize the query to name its metrics, i.e. fold the white spaces
+ *	and truncate it.
+ */
+static void
+metrics_name(const char *query, char *name, size_t namesize)
+{
+	size_t	len = 0;
+	BOOL	space = FALSE;
+
+	for (; NULL != query && '\0' != *query && len + 1 < namesize; query++)
+	{
+		if (isspace((UCHAR) *query))
+		{
+			space = TRUE;
+			continue;
+		}
+		if (space && len > 0)
+		{
+			name[len++] = ' ';
+			if (len + 1 >= namesize)
+				break;
+		}
+		space = FALSE;
+		name[len++] = *query;
+	}
+	name[len] = '\0';
+}
+
+/*
+ *	Count an execution of the query of stmt and remember its entry
+ *	for the metrics added until the next execution.
+ */
+void
+CC_count_execute(ConnectionClass *self, StatementClass *stmt)
+{
+	char		name[MAX_METRICS_NAME_LEN];
+	PG_QueryMetrics	*entry;
+	int		i;
+
+	metrics_name(stmt->statement, name, sizeof(name));
+	if ('\0' == name[0])
+		STRCPY_FIXED(name, "(unknown)");
+	CONNLOCK_ACQUIRE(self);
+	self->metrics.executes++;
+	stmt->metrics_idx = -1;
+	for (i = 0; i < self->num_query_metrics; i++)
+	{
+		if (strcmp(self->query_metrics[i].name, name) == 0)
+		{
+			stmt->metrics_idx = i;
+			break;
+		}
+	}
+	if (stmt->metrics_idx < 0)
+	{
+		if (self->num_query_metrics >= MAX_QUERY_METRICS)
+		{
+			/* the last entry holds the other queries */
+			char	*others;
+
+			i = MAX_QUERY_METRICS - 1;
+			if (strcmp(self->query_metrics[i].name, "(others)") != 0 &&
+			    (others = strdup("(others)"), NULL != others))
+			{
+				free(self->query_metrics[i].name);
+				self->query_metrics[i].name = others;
+			}
+			stmt->metrics_idx = i;
+		}
+		else if (entry = (PG_QueryMetrics *) realloc(self->query_metrics, sizeof(PG_QueryMetrics) * (self->num_query_metrics + 1)), NULL != entry)
+		{
+			self->query_metrics = entry;
+			entry += self->num_query_metrics;
+			memset(&entry->metrics, 0, sizeof(entry->metrics));
+			if (entry->name = strdup(name), NULL != entry->name)
+				stmt->metrics_idx = self->num_query_metrics++;
+		}
+	}
+	if (stmt->metrics_idx >= 0)
+		self->query_metrics[stmt->metrics_idx].metrics.executes++;
+	CONNLOCK_RELEASE(self);
+}
+
+/*
+ *	Add the metrics to the connection totals and to the query last
+ *	executed by stmt (if any).
+ */
+void
+CC_add_metrics(ConnectionClass *self, StatementClass *stmt, const PG_Metrics *metrics)
+{
+	CONNLOCK_ACQUIRE(self);
+	add_metrics(&self->metrics, metrics);
+	if (NULL != stmt && stmt->metrics_idx >= 0 &&
+	    stmt->metrics_idx < self->num_query_metrics)
+		add_metrics(&self->query_metrics[stmt->metrics_idx].metrics, metrics);
+	CONNLOCK_RELEASE(self);
+}
+
+#define	METRICS_FORMAT	"executes=" FORMATI64 " exec_usec=" FORMATI64 " rows=" FORMATI64 " bytes=" FORMATI64 " convert_usec=" FORMATI64 "\n"
+#define	METRICS_ITEMS(m)	(m).executes, (m).exec_usec, (m).rows, (m).bytes, (m).convert_usec
+
+/*
+ *	Write the metrics of the connection and its executed queries into
+ *	buf, one line each. The line of the connection comes first and
+ *	includes the queries. Returns the length of the whole report, which
+ *	may be greater than bufsize.
+ */
+size_t
+CC_metrics_report(ConnectionClass *self, char *buf, size_t bufsize)
+{
+	PQExpBufferData	report = {0};
+	PG_QueryMetrics	*entry;
+	size_t		len;
+	int		i;
+
+	initPQExpBuffer(&report);
+	CONNLOCK_ACQUIRE(self);
+	appendPQExpBuffer(&report, "connection " METRICS_FORMAT, METRICS_ITEMS(self->metrics));
+	for (i = 0, entry = self->query_metrics; i < self->num_query_metrics; i++, entry++)
+		appendPQExpBuffer(&report, "query \"%s\" " METRICS_FORMAT,
+				  entry->name, METRICS_ITEMS(entry->metrics));
+	CONNLOCK_RELEASE(self);
+	if (PQExpBufferDataBroken(report))
+		return 0;
+	len = report.len;
+	if (buf && bufsize > 0)
+		strncpy_null(buf, report.data, bufsize);
+	termPQExpBuffer(&report);
+
+	return len;
+}
+
 char CC_get_escape(const ConnectionClass *self)
 {
 	const char	   *scf;
@@ -1373,7 +1851,7 @@ static int handle_show_results(const QResultClass *res)
 }
 /*
  *	This function may not be called as long as ISOLATION_SHOW_QUERY is
- *	issued in LIBPQ_CC_connect.
+ *	issued in CC_connect.
  */
 SQLUINTEGER	CC_get_isolation(ConnectionClass *self)
 {
@@ -1692,6 +2170,7 @@ CC_internal_rollback(ConnectionClass *self, int rollback_type, BOOL ignore_abort
 	char		cmd[128];
 	PGresult   *pgres = NULL;
 
+	CC_finish_prefetch(self);
 	if (!CC_is_in_error_trans(self))
 		return 1;
 	switch (rollback_type)
@@ -1751,6 +2230,47 @@ CC_internal_rollback(ConnectionClass *self, int rollback_type, BOOL ignore_abort
 	return ret;
 }
 
+/*
+ *	Let libpq hand over the result rows piece by piece, so that
+ *	the whole result isn't kept by libpq as well as by the driver.
+ *	ResultChunkSize=0 means to receive the whole result at once.
+ */
+static void
+CC_set_row_retrieval_mode(ConnectionClass *self)
+{
+	int	chunk_size = self->connInfo.result_chunk_size;
+
+	if (0 == chunk_size)
+		return;
+#ifdef	HAVE_PQSETCHUNKEDROWSMODE
+	if (chunk_size > 1)
+	{
+		if (PQsetChunkedRowsMode(self->pqconn, chunk_size))
+			return;
+		MYLOG(0, "PQsetChunkedRowsMode(%d) failed\n", chunk_size);
+	}
+#endif /* HAVE_PQSETCHUNKEDROWSMODE */
+	PQsetSingleRowMode(self->pqconn);
+}
+
+/*
+ *	Nothing but the replay of the query sent asynchronously can be sent
+ *	until the replay processes its results, which change the transaction
+ *	state (the BEGIN issued, the internal savepoints, an abort etc).
+ */
+static BOOL
+CC_async_query_blocks(ConnectionClass *self, StatementClass *stmt, const char *func)
+{
+	if (NULL == self->async_query)
+		return FALSE;
+	MYLOG(0, "stmt=%p is executing asynchronously\n", self->async_query->stmt);
+	if (NULL != stmt)
+		SC_set_error(stmt, STMT_SEQUENCE_ERROR, "A query is executing asynchronously on the connection", func);
+	else
+		CC_set_error(self, CONN_SEQUENCE_ERROR, "A query is executing asynchronously on the connection", func);
+	return TRUE;
+}
+
 /*
  *	The "result_in" is only used by QR_next_tuple() to fetch another group of rows into
  *	the same existing QResultClass (this occurs when the tuple cache is depleted and
@@ -1794,11 +2314,14 @@ CC_send_query_append(ConnectionClass *self, const char *query, QueryInfo *qi, UD
 	int		func_cs_count = 0;
 	PQExpBufferData		query_buf = {0};
 	size_t		query_len;
+	Int8		start_usec = 0;
 
 	/* QR_set_command() dups this string so doesn't need static */
 	char	   *cmdbuffer;
 	PGresult   *pgres = NULL;
 	notice_receiver_arg nrarg;
+	ASYNC_QUERY	*aq = NULL;
+	BOOL		async_pending = FALSE;
 
 	if (appendq)
 	{
@@ -1820,6 +2343,16 @@ CC_send_query_append(ConnectionClass *self, const char *query, QueryInfo *qi, UD
 	}
 
 	ENTER_INNER_CONN_CS(self, func_cs_count);
+	if (NULL != self->async_query &&
+	    (stmt != self->async_query->stmt ||
+	     NULL != qi || NULL != appendq || NULL == query ||
+	     strcmp(query, self->async_query->query) != 0) &&
+	    CC_async_query_blocks(self, stmt, func))
+	{
+		CLEANUP_FUNC_CONN_CS(func_cs_count, self);
+		return rhold;
+	}
+	CC_finish_prefetch(self);
 /* Indicate that we are sending a query to the backend */
 	if ((NULL == query) || (query[0] == '\0'))
 	{
@@ -1856,6 +2389,20 @@ CC_send_query_append(ConnectionClass *self, const char *query, QueryInfo *qi, UD
 	end_with_commit = (flag & END_WITH_COMMIT) != 0;
 	read_only = (flag & READ_ONLY_QUERY) != 0;
 #define	return DONT_CALL_RETURN_FROM_HERE???
+	if (NULL != self->async_query &&
+	    stmt == self->async_query->stmt &&
+	    NULL == qi && NULL == appendq &&
+	    strcmp(query, self->async_query->query) == 0)
+	{
+		/*
+		 * The replayed execution of the query sent asynchronously.
+		 * CC_finish_prefetch() above has collected all its results.
+		 */
+		aq = self->async_query;
+		MYLOG(0, "receiving the results of the asynchronous query\n");
+		goto adopt_async_query;
+	}
+	start_usec = METRICS_START(self);
 	consider_rollback = (issue_begin || (CC_is_in_trans(self) && !CC_is_in_error_trans(self)) || strnicmp(query, "begin", 5) == 0);
 	if (rollback_on_error)
 		rollback_on_error = consider_rollback;
@@ -1932,15 +2479,49 @@ CC_send_query_append(ConnectionClass *self, const char *query, QueryInfo *qi, UD
 	nrarg.stmt = stmt;
 	PQsetNoticeReceiver(self->pqconn, receive_libpq_notice, &nrarg);
 
+	/*
+	 * Send the query on the non-blocking connection and return without
+	 * waiting for the results, if the statement executes asynchronously.
+	 */
+	if ((flag & SEND_ASYNCHRONOUSLY) != 0 && NULL != stmt &&
+	    NULL == qi && NULL == appendq && !create_keyset &&
+	    NULL == self->async_query &&
+	    NULL != (aq = (ASYNC_QUERY *) calloc(1, sizeof(ASYNC_QUERY))))
+	{
+		if (NULL == (aq->query = strdup(query)) ||
+		    PQsetnonblocking(self->pqconn, 1) != 0)
+		{
+			free(aq->query);
+			free(aq);
+			aq = NULL;
+		}
+	}
 	QLOG(0, "PQsendQuery: %p '%s'\n", self->pqconn, query_buf.data);
 	if (!PQsendQuery(self->pqconn, query_buf.data))
 	{
 		char *errmsg = PQerrorMessage(self->pqconn);
 		QLOG(0, "\nCommunication Error: %s\n", SAFE_STR(errmsg));
 		CC_set_error(self, CONNECTION_COMMUNICATION_ERROR, errmsg, func);
+		if (NULL != aq)
+		{
+			PQsetnonblocking(self->pqconn, 0);
+			free(aq->query);
+			free(aq);
+			aq = NULL;
+		}
 		goto cleanup;
 	}
-	PQsetSingleRowMode(self->pqconn);
+	/*
+	 *	The results of an asynchronous query are kept until they have all
+	 *	arrived, so it receives each of them whole rather than row by row.
+	 */
+	if (NULL == aq)
+		CC_set_row_retrieval_mode(self);
+	else
+	{
+		aq->stmt = stmt;
+		self->async_query = aq;
+	}
 
 	cmdres = qi ? qi->result_in : NULL;
 	if (cmdres)
@@ -1954,6 +2535,43 @@ CC_send_query_append(ConnectionClass *self, const char *query, QueryInfo *qi, UD
 			goto cleanup;
 		}
 	}
+	if (NULL != aq)
+	{
+		aq->rollback_on_error = rollback_on_error;
+		aq->query_rollback = query_rollback;
+		aq->discard_next_begin = discard_next_begin;
+		aq->discard_next_savepoint = discard_next_savepoint;
+		aq->start_usec = start_usec;
+		aq->cmdres = cmdres;
+		aq->nrarg = nrarg;
+		aq->nrarg.res = cmdres;
+		if (!CC_poll_async_query(self, FALSE))
+		{
+			MYLOG(0, "the query is in flight asynchronously\n");
+			async_pending = TRUE;
+			goto cleanup;
+		}
+		/* completed at once, so process the results now */
+	}
+adopt_async_query:
+	if (NULL != aq)
+	{
+		rollback_on_error = aq->rollback_on_error;
+		query_rollback = aq->query_rollback;
+		discard_next_begin = aq->discard_next_begin;
+		discard_next_savepoint = aq->discard_next_savepoint;
+		start_usec = aq->start_usec;
+		cmdres = aq->cmdres;
+		aq->cmdres = NULL;
+		nrarg = aq->nrarg;
+		if (aq->nomem)
+		{
+			CC_set_error(self, CONN_NO_MEMORY_ERROR, "Couldn't alloc buffer for the results.", func);
+			ReadyToReturn = TRUE;
+			retres = NULL;
+			goto cleanup;
+		}
+	}
 	res = cmdres;
 	if (qi)
 	{
@@ -1962,7 +2580,8 @@ CC_send_query_append(ConnectionClass *self, const char *query, QueryInfo *qi, UD
 	}
 	nrarg.res = res;
 
-	while (self->pqconn && (pgres = PQgetResult(self->pqconn)) != NULL)
+	while (self->pqconn &&
+	       (pgres = (NULL != aq ? async_next_result(aq) : PQgetResult(self->pqconn))) != NULL)
 	{
 		int status = PQresultStatus(pgres);
 
@@ -2054,7 +2673,13 @@ MYLOG(DETAIL_LOG_LEVEL, "Discarded a RELEASE result\n");
 				 */
 				else if (strnicmp(cmdbuffer, "DROP TABLE", 10) == 0 ||
 						 strnicmp(cmdbuffer, "ALTER TABLE", 11) == 0)
+				{
+					char	share_key[512];
+
 					CC_clear_col_info(self, FALSE);
+					if (CC_get_coli_share_key(self, share_key, sizeof(share_key)))
+						EN_clear_shared_col_info(share_key);
+				}
 				else
 				{
 					ptr = strrchr(cmdbuffer, ' ');
@@ -2099,6 +2724,9 @@ MYLOG(DETAIL_LOG_LEVEL, "Discarded a RELEASE result\n");
 			case PGRES_TUPLES_OK:
 				QLOG(0, "\tok: - 'T' - %s\n", PQcmdStatus(pgres));
 			case PGRES_SINGLE_TUPLE:
+#ifdef	HAVE_PQSETCHUNKEDROWSMODE
+			case PGRES_TUPLES_CHUNK:
+#endif /* HAVE_PQSETCHUNKEDROWSMODE */
 				if (query_completed)
 				{
 					QR_concat(res, QR_Constructor());
@@ -2230,6 +2858,10 @@ MYLOG(DETAIL_LOG_LEVEL, "Discarded a RELEASE result\n");
 	}
 
 cleanup:
+	if (async_pending)
+		goto leave;
+	if (NULL != aq)
+		CC_free_async_query(self);
 	if (self->pqconn)
 		PQsetNoticeReceiver(self->pqconn, receive_libpq_notice, NULL);
 	if (pgres != NULL)
@@ -2262,8 +2894,25 @@ MYLOG(DETAIL_LOG_LEVEL, " rollback_on_error=%d CC_is_in_trans=%d discard_next_sa
 		}
 	}
 
+	if (start_usec > 0)
+	{
+		PG_Metrics	metrics = {0};
+
+		metrics.exec_usec = get_clock_usec() - start_usec;
+		CC_add_metrics(self, stmt, &metrics);
+	}
+leave:
 	CLEANUP_FUNC_CONN_CS(func_cs_count, self);
 #undef	return
+	/*
+	 * The results of the query sent asynchronously are processed
+	 * when the execution is replayed.
+	 */
+	if (async_pending)
+	{
+		termPQExpBuffer(&query_buf);
+		return rhold;
+	}
 	/*
 	 * Break before being ready to return.
 	 */
@@ -2352,8 +3001,8 @@ static const char *func_param_str[MAX_SEND_FUNC_ARGS + 1] =
 	"($1, $2, $3)"
 };
 
-static
-Int8 odbc_hton64(Int8 h64)
+Int8
+odbc_hton64(Int8 h64)
 {
 	union {
 		Int8	n64;
@@ -2366,8 +3015,8 @@ Int8 odbc_hton64(Int8 h64)
 	return u.n64;
 }
 
-static
-Int8 odbc_ntoh64(Int8 n64)
+Int8
+odbc_ntoh64(Int8 n64)
 {
 	union {
 		Int8	h64;
@@ -2384,14 +3033,404 @@ Int8 odbc_ntoh64(Int8 n64)
 }
 
 
-int
-CC_send_function(ConnectionClass *self, const char *fn_name, void *result_buf, int *actual_result_len, int result_is_int, LO_ARG *args, int nargs)
+/*
+ *	Read-ahead of declare/fetch cursors (FetchAhead).
+ *
+ *	libpq allows only one query in flight outside of the pipeline mode,
+ *	so a connection reads ahead for one result at a time. The FETCH sent
+ *	by CC_prefetch() runs while the application processes the current
+ *	block, and the completed FETCH results are stashed in the result
+ *	until QR_next_tuple() consumes them via CC_receive_prefetched().
+ *	A completed FETCH is collected by the next call, which sends another
+ *	one until FetchAhead blocks are stashed.
+ *	Anything else which talks to the server must call CC_finish_prefetch()
+ *	first.
+ *
+ *	In a transaction block the FETCH runs in a savepoint. If it fails,
+ *	the savepoint is rolled back so that the transaction isn't aborted
+ *	before the application reaches the block, and the error is reported
+ *	then.
+ */
+void
+CC_prefetch(ConnectionClass *self, QResultClass *res, Int4 fetch_size)
+{
+	int		depth = self->connInfo.fetch_ahead;
+	int		func_cs_count = 0;
+	char		fetch[256];
+
+	if (depth <= 0 || res->prefetch_eof || NULL == QR_get_cursor(res))
+		return;
+#define	return DONT_CALL_RETURN_FROM_HERE???
+	ENTER_INNER_CONN_CS(self, func_cs_count);
+	if (NULL == self->pqconn || NULL != self->async_query)
+		goto cleanup;
+	if (NULL != self->prefetch_res)
+	{
+		/* another cursor is reading ahead */
+		if (res != self->prefetch_res)
+			goto cleanup;
+		/* collect the FETCH if it's already completed */
+		if (!PQconsumeInput(self->pqconn) || PQisBusy(self->pqconn))
+			goto cleanup;
+		CC_finish_prefetch(self);
+		if (res->prefetch_eof)
+			goto cleanup;
+	}
+	if (res->num_prefetched >= depth)
+		goto cleanup;
+	/* the stashed blocks must have the same size */
+	if (res->num_prefetched > 0 && fetch_size != res->prefetch_size)
+		goto cleanup;
+	if (NULL == res->prefetched &&
+	    (res->prefetched = (PGresult **) malloc(sizeof(PGresult *) * depth), NULL == res->prefetched))
+		goto cleanup;
+	switch (PQtransactionStatus(self->pqconn))
+	{
+		case PQTRANS_IDLE:
+			self->prefetch_svp = FALSE;
+			SPRINTF_FIXED(fetch, "fetch %d in \"%s\"", fetch_size, QR_get_cursor(res));
+			break;
+		case PQTRANS_INTRANS:
+			self->prefetch_svp = TRUE;
+			SPRINTF_FIXED(fetch, "%s %s;fetch %d in \"%s\";%s %s", svpcmd, prefetch_svpname, fetch_size, QR_get_cursor(res), rlscmd, prefetch_svpname);
+			break;
+		default:
+			goto cleanup;
+	}
+	QLOG(0, "PQsendQuery: %p '%s'\n", self->pqconn, fetch);
+	if (!PQsendQuery(self->pqconn, fetch))
+	{
+		MYLOG(0, "read-ahead failed: %s\n", PQerrorMessage(self->pqconn));
+		goto cleanup;
+	}
+	res->prefetch_size = fetch_size;
+	self->prefetch_res = res;
+cleanup:
+#undef	return
+	CLEANUP_FUNC_CONN_CS(func_cs_count, self);
+}
+
+/*
+ *	Wait for the FETCH in flight and stash its result.
+ *	The query sent asynchronously is also waited for.
+ */
+void
+CC_finish_prefetch(ConnectionClass *self)
+{
+	QResultClass	*res;
+	PGresult	*pgres;
+	BOOL		stashed = FALSE, failed = FALSE;
+	int		func_cs_count = 0;
+	char		cmd[128];
+
+#define	return DONT_CALL_RETURN_FROM_HERE???
+	ENTER_INNER_CONN_CS(self, func_cs_count);
+	CC_poll_async_query(self, TRUE);
+	if (res = self->prefetch_res, NULL == res)
+		goto cleanup;
+	self->prefetch_res = NULL;
+	if (NULL == self->pqconn)
+		goto cleanup;
+	while (pgres = PQgetResult(self->pqconn), NULL != pgres)
+	{
+		/* skip the results of SAVEPOINT and RELEASE */
+		if (stashed || PGRES_COMMAND_OK == PQresultStatus(pgres))
+		{
+			PQclear(pgres);
+			continue;
+		}
+		if (PGRES_TUPLES_OK != PQresultStatus(pgres))
+			failed = self->prefetch_svp;
+		if (PGRES_TUPLES_OK != PQresultStatus(pgres) ||
+		    PQntuples(pgres) < res->prefetch_size)
+			res->prefetch_eof = TRUE;
+		res->prefetched[res->num_prefetched++] = pgres;
+		stashed = TRUE;
+	}
+	if (failed)
+	{
+		/* the error is reported when the application reaches the block */
+		SPRINTF_FIXED(cmd, "%s TO %s;%s %s", rbkcmd, prefetch_svpname, rlscmd, prefetch_svpname);
+		QLOG(0, "PQexec: %p '%s'\n", self->pqconn, cmd);
+		pgres = PQexec(self->pqconn, cmd);
+		if (PGRES_COMMAND_OK == PQresultStatus(pgres))
+			res->prefetch_rolled_back = TRUE;
+		PQclear(pgres);
+	}
+	LIBPQ_update_transaction_status(self);
+cleanup:
+#undef	return
+	CLEANUP_FUNC_CONN_CS(func_cs_count, self);
+}
+
+/*
+ *	Fill the result of QR_next_tuple() with the next prefetched block
+ *	instead of sending a FETCH.
+ */
+QResultClass *
+CC_receive_prefetched(ConnectionClass *self, QueryInfo *qi, StatementClass *stmt)
+{
+	CSTR	func = "CC_receive_prefetched";
+	QResultClass	*res = qi->result_in;
+	PGresult	*pgres;
+	int		i, func_cs_count = 0;
+
+#define	return DONT_CALL_RETURN_FROM_HERE???
+	ENTER_INNER_CONN_CS(self, func_cs_count);
+	if (0 == res->num_prefetched)
+		CC_finish_prefetch(self);
+	if (0 == res->num_prefetched)
+	{
+		CC_set_error(self, CONNECTION_COULD_NOT_RECEIVE, "The prefetched result was lost", func);
+		res = NULL;
+		goto cleanup;
+	}
+	pgres = res->prefetched[0];
+	for (i = 1; i < res->num_prefetched; i++)
+		res->prefetched[i - 1] = res->prefetched[i];
+	res->num_prefetched--;
+
+	res->cmd_fetch_size = qi->fetch_size;
+	res->cache_size = qi->row_size;
+	switch (PQresultStatus(pgres))
+	{
+		case PGRES_TUPLES_OK:
+			QLOG(0, "\tok: - 'T' - %s\n", PQcmdStatus(pgres));
+			if (!CC_from_PGresult(res, stmt, NULL, res->cursor_name, &pgres))
+				res = NULL;
+			break;
+		default:
+			if (res->prefetch_rolled_back)
+			{
+				char		fetch[128];
+
+				/*
+				 * Fail the FETCH again, the cursor can't run any more,
+				 * to leave the transaction (and the statement rollback)
+				 * as the FETCH would have without the read-ahead.
+				 * The original error is reported.
+				 */
+				res->prefetch_rolled_back = FALSE;
+				SPRINTF_FIXED(fetch, "fetch %d in \"%s\"", res->prefetch_size, QR_get_cursor(res));
+				QR_Destructor(CC_send_query(self, fetch, NULL, READ_ONLY_QUERY, stmt));
+				CC_clear_error(self);
+			}
+			handle_pgres_error(self, pgres, "send_query", res, TRUE);
+			break;
+	}
+	if (NULL != pgres)
+		PQclear(pgres);
+cleanup:
+#undef	return
+	CLEANUP_FUNC_CONN_CS(func_cs_count, self);
+	return res;
+}
+
+/*
+ *	Asynchronous execution (SQL_ATTR_ASYNC_ENABLE).
+ *
+ *	CC_send_query_append() sends the query of the statement on the
+ *	non-blocking connection and returns at once. The application calls
+ *	the function again and again, and CC_poll_async_query() collects the
+ *	results which have arrived meanwhile. Once they are all there, the
+ *	execution is replayed and CC_send_query_append() processes them as
+ *	if they had just been received. So the results are processed in the
+ *	thread of the application and no thread waits for the query.
+ */
+#ifdef	USE_ASYNC_NOTIFICATION
+/*
+ *	ODBC 3.8 notification: the wait for the socket is left to the thread
+ *	pool of the system, which tells the driver manager to call again.
+ */
+typedef SQLRETURN (SQL_API *ASYNC_NOTIFY_FUNC)(SQLPOINTER context, BOOL last);
+
+static VOID CALLBACK
+async_socket_ready(PVOID arg, BOOLEAN timed_out)
+{
+	StatementClass	*stmt = (StatementClass *) arg;
+
+	((ASYNC_NOTIFY_FUNC) stmt->async_callback)(stmt->async_context, FALSE);
+}
+
+static void
+CC_unwatch_async_query(ASYNC_QUERY *aq)
+{
+	if (NULL != aq->waiter)
+	{
+		UnregisterWaitEx(aq->waiter, INVALID_HANDLE_VALUE);
+		aq->waiter = NULL;
+	}
+	if (NULL != aq->sockevent)
+		WSAResetEvent(aq->sockevent);
+}
+
+static void
+CC_watch_async_query(ConnectionClass *self, ASYNC_QUERY *aq, BOOL flushing)
+{
+	if (NULL == aq->stmt->async_callback)
+		return;
+	if (NULL == aq->sockevent &&
+	    WSA_INVALID_EVENT == (aq->sockevent = WSACreateEvent()))
+	{
+		aq->sockevent = NULL;
+		return;
+	}
+	if (0 != WSAEventSelect(PQsocket(self->pqconn), aq->sockevent, FD_READ | FD_CLOSE | (flushing ? FD_WRITE : 0)) ||
+	    !RegisterWaitForSingleObject(&aq->waiter, aq->sockevent, async_socket_ready, aq->stmt, INFINITE, WT_EXECUTEONLYONCE))
+	{
+		MYLOG(0, "couldn't watch the socket error=%d\n", WSAGetLastError());
+		aq->waiter = NULL;
+	}
+}
+#endif /* USE_ASYNC_NOTIFICATION */
+
+/*
+ *	Collect the results of the query sent asynchronously, without
+ *	blocking unless wait is specified. Returns TRUE when all of them
+ *	have been collected.
+ */
+BOOL
+CC_poll_async_query(ConnectionClass *self, BOOL wait)
+{
+	ASYNC_QUERY	*aq = self->async_query;
+	PGresult	*pgres;
+	BOOL		flushing = FALSE;
+
+	if (NULL == aq || aq->completed)
+		return TRUE;
+	if (NULL == self->pqconn)
+	{
+		aq->completed = TRUE;
+		return TRUE;
+	}
+#ifdef	USE_ASYNC_NOTIFICATION
+	CC_unwatch_async_query(aq);
+#endif /* USE_ASYNC_NOTIFICATION */
+	PQsetNoticeReceiver(self->pqconn, receive_libpq_notice, &aq->nrarg);
+	while (!aq->completed)
+	{
+		if (!wait)
+		{
+			/* send the rest of the query and read what has arrived */
+			if (PQflush(self->pqconn) > 0)
+			{
+				flushing = TRUE;
+				break;
+			}
+			if (PQconsumeInput(self->pqconn) &&
+			    PQisBusy(self->pqconn))
+				break;
+		}
+		if (pgres = PQgetResult(self->pqconn), NULL == pgres)
+		{
+			aq->completed = TRUE;
+			break;
+		}
+		if (aq->num_results >= aq->alloc_results)
+		{
+			int		alloc = aq->alloc_results > 0 ? aq->alloc_results * 2 : 8;
+			PGresult	**results;
+
+			if (results = (PGresult **) realloc(aq->results, sizeof(PGresult *) * alloc), NULL == results)
+			{
+				PQclear(pgres);
+				aq->nomem = TRUE;
+				continue;
+			}
+			aq->results = results;
+			aq->alloc_results = alloc;
+		}
+		aq->results[aq->num_results++] = pgres;
+	}
+	PQsetNoticeReceiver(self->pqconn, receive_libpq_notice, NULL);
+	if (aq->completed)
+	{
+		MYLOG(0, "the asynchronous query completed with %d results\n", aq->num_results);
+		PQsetnonblocking(self->pqconn, 0);
+	}
+	else
+	{
+		MYLOG(DETAIL_LOG_LEVEL, "the asynchronous query is still %s\n", flushing ? "being sent" : "executing");
+#ifdef	USE_ASYNC_NOTIFICATION
+		CC_watch_async_query(self, aq, flushing);
+#endif /* USE_ASYNC_NOTIFICATION */
+	}
+	return aq->completed;
+}
+
+static PGresult *
+async_next_result(ASYNC_QUERY *aq)
+{
+	if (aq->next_result >= aq->num_results)
+		return NULL;
+	return aq->results[aq->next_result++];
+}
+
+static void
+CC_free_async_query(ConnectionClass *self)
+{
+	ASYNC_QUERY	*aq = self->async_query;
+	PGresult	*pgres;
+
+	if (NULL == aq)
+		return;
+	self->async_query = NULL;
+#ifdef	USE_ASYNC_NOTIFICATION
+	CC_unwatch_async_query(aq);
+	if (NULL != aq->sockevent)
+	{
+		if (NULL != self->pqconn)
+			WSAEventSelect(PQsocket(self->pqconn), NULL, 0);
+		WSACloseEvent(aq->sockevent);
+	}
+#endif /* USE_ASYNC_NOTIFICATION */
+	while (pgres = async_next_result(aq), NULL != pgres)
+		PQclear(pgres);
+	if (NULL != self->pqconn)
+		PQsetnonblocking(self->pqconn, 0);
+	free(aq->results);
+	QR_Destructor(aq->cmdres);
+	free(aq->query);
+	free(aq);
+}
+
+/*
+ *	Cancel the query sent asynchronously and throw away its results,
+ *	when the statement is freed for example. As with SQLCancel(), a
+ *	cancelled query aborts the transaction it runs in.
+ */
+void
+CC_discard_async_query(ConnectionClass *self)
+{
+	PGcancel	*cancel;
+	char		errbuf[256];
+
+	if (NULL == self->async_query)
+		return;
+	MYLOG(0, "discarding the asynchronous query of stmt=%p\n", self->async_query->stmt);
+	/* don't wait for the rest of the query */
+	if (!self->async_query->completed &&
+	    NULL != self->pqconn &&
+	    NULL != (cancel = PQgetCancel(self->pqconn)))
+	{
+		if (!PQcancel(cancel, errbuf, sizeof(errbuf)))
+			MYLOG(0, "PQcancel failed: %s\n", errbuf);
+		PQfreeCancel(cancel);
+	}
+	CC_poll_async_query(self, TRUE);
+	CC_free_async_query(self);
+	LIBPQ_update_transaction_status(self);
+}
+
+/*
+ *	Send a query calling large object functions, the integer parameters
+ *	in binary.  The caller must hold the connection's critical section.
+ */
+static PGresult *
+send_function_query(ConnectionClass *self, const char *query, LO_ARG *args, int nargs)
 {
 	int			i;
-	int			ret = FALSE;
-	int			func_cs_count = 0;
-	char		sqlbuffer[1000];
-	PGresult   *pgres = NULL;
+	PGresult   *pgres;
 	Oid			paramTypes[MAX_SEND_FUNC_ARGS];
 	char	   *paramValues[MAX_SEND_FUNC_ARGS];
 	int			paramLengths[MAX_SEND_FUNC_ARGS];
@@ -2399,14 +3438,6 @@ CC_send_function(ConnectionClass *self, const char *fn_name, void *result_buf, i
 	Int4		intParamBufs[MAX_SEND_FUNC_ARGS];
 	Int8		int8ParamBufs[MAX_SEND_FUNC_ARGS];
 
-	MYLOG(0, "conn=%p, fn_name=%s, result_is_int=%d, nargs=%d\n", self, fn_name, result_is_int, nargs);
-
-	/* Finish the pending extended query first */
-#define	return DONT_CALL_RETURN_FROM_HERE???
-	ENTER_INNER_CONN_CS(self, func_cs_count);
-
-	SPRINTF_FIXED(sqlbuffer, "SELECT pg_catalog.%s%s", fn_name,
-			 func_param_str[nargs]);
 	for (i = 0; i < nargs; ++i)
 	{
 		MYLOG(0, "  arg[%d]: len = %d, isint = %d, integer = " FORMATI64 ", ptr = %p\n", i, args[i].len, args[i].isint, args[i].isint == 2 ? args[i].u.integer64 : args[i].u.integer, args[i].u.ptr);
@@ -2436,8 +3467,8 @@ CC_send_function(ConnectionClass *self, const char *fn_name, void *result_buf, i
 		}
 	}
 
-	QLOG(0, "PQexecParams: %p '%s' nargs=%d\n", self->pqconn, sqlbuffer, nargs);
-	pgres = PQexecParams(self->pqconn, sqlbuffer, nargs,
+	QLOG(0, "PQexecParams: %p '%s' nargs=%d\n", self->pqconn, query, nargs);
+	pgres = PQexecParams(self->pqconn, query, nargs,
 						 paramTypes, (const char * const *) paramValues,
 						 paramLengths, paramFormats, 1);
 
@@ -2448,9 +3479,36 @@ CC_send_function(ConnectionClass *self, const char *fn_name, void *result_buf, i
 	else
 	{
 		handle_pgres_error(self, pgres, "send_query", NULL, TRUE);
-		goto cleanup;
+		PQclear(pgres);
+		return NULL;
 	}
 
+	return pgres;
+}
+
+int
+CC_send_function(ConnectionClass *self, const char *fn_name, void *result_buf, int *actual_result_len, int result_is_int, LO_ARG *args, int nargs)
+{
+	int			ret = FALSE;
+	int			func_cs_count = 0;
+	char		sqlbuffer[1000];
+	PGresult   *pgres = NULL;
+
+	MYLOG(0, "conn=%p, fn_name=%s, result_is_int=%d, nargs=%d\n", self, fn_name, result_is_int, nargs);
+
+	/* Finish the pending extended query first */
+#define	return DONT_CALL_RETURN_FROM_HERE???
+	ENTER_INNER_CONN_CS(self, func_cs_count);
+	if (CC_async_query_blocks(self, NULL, __FUNCTION__))
+		goto cleanup;
+	CC_finish_prefetch(self);
+
+	SPRINTF_FIXED(sqlbuffer, "SELECT pg_catalog.%s%s", fn_name,
+			 func_param_str[nargs]);
+	pgres = send_function_query(self, sqlbuffer, args, nargs);
+	if (NULL == pgres)
+		goto cleanup;
+
 	if (PQnfields(pgres) != 1 || PQntuples(pgres) != 1)
 	{
 		CC_set_errormsg(self, "unexpected result set from large_object function");
@@ -2493,6 +3551,84 @@ cleanup:
 	return ret;
 }
 
+/*
+ *	Send a query combining some large object functions so as to save
+ *	round trips, e.g. opening a large object and getting its size.
+ *	The query must return one row, whose columns are stored into
+ *	results[] like the result of CC_send_function(): the integers
+ *	according to isint and the others into u.ptr of at most len bytes,
+ *	len being set to the actual length.
+ */
+int
+CC_send_function_query(ConnectionClass *self, const char *query, LO_ARG *args, int nargs, LO_ARG *results, int nresults)
+{
+	int			i;
+	int			ret = FALSE;
+	int			func_cs_count = 0;
+	PGresult   *pgres = NULL;
+
+	MYLOG(0, "conn=%p, query=%s, nargs=%d, nresults=%d\n", self, query, nargs, nresults);
+
+#define	return DONT_CALL_RETURN_FROM_HERE???
+	ENTER_INNER_CONN_CS(self, func_cs_count);
+	if (CC_async_query_blocks(self, NULL, __FUNCTION__))
+		goto cleanup;
+	CC_finish_prefetch(self);
+
+	pgres = send_function_query(self, query, args, nargs);
+	if (NULL == pgres)
+		goto cleanup;
+
+	if (PQnfields(pgres) != nresults || PQntuples(pgres) != 1)
+	{
+		CC_set_errormsg(self, "unexpected result set from large_object function");
+		goto cleanup;
+	}
+
+	for (i = 0; i < nresults; i++)
+	{
+		int		len = PQgetlength(pgres, 0, i);
+		char   *value = PQgetvalue(pgres, 0, i);
+
+		if (results[i].isint == 2 && len == sizeof(Int8))
+		{
+			memcpy(&results[i].u.integer64, value, sizeof(Int8));
+			results[i].u.integer64 = odbc_ntoh64(results[i].u.integer64);
+		}
+		else if (results[i].isint && len == sizeof(Int4))
+		{
+			Int4 int4val;
+
+			memcpy(&int4val, value, sizeof(Int4));
+			int4val = ntohl(int4val);
+			if (results[i].isint == 2)
+				results[i].u.integer64 = int4val;
+			else
+				results[i].u.integer = int4val;
+		}
+		else if (!results[i].isint && len <= results[i].len)
+		{
+			memcpy(results[i].u.ptr, value, len);
+			results[i].len = len;
+		}
+		else
+		{
+			CC_set_errormsg(self, "unexpected result set from large_object function");
+			goto cleanup;
+		}
+		QLOG(0, "\tgot result[%d] with length: %d\n", i, len);
+	}
+
+	ret = TRUE;
+
+cleanup:
+#undef	return
+	CLEANUP_FUNC_CONN_CS(func_cs_count, self);
+	if (pgres)
+		PQclear(pgres);
+	return ret;
+}
+
 
 char
 CC_send_settings(ConnectionClass *self, const char *set_query)
@@ -2570,12 +3706,23 @@ CC_lookup_lo(ConnectionClass *self)
 
 	MYLOG(0, "entering...\n");
 
-	res = CC_send_query(self, "select oid, typbasetype from pg_type where typname = '"  PG_TYPE_LO_NAME "'",
-		NULL, READ_ONLY_QUERY, NULL);
+	res = CC_send_query(self, LO_LOOKUP_QUERY, NULL, READ_ONLY_QUERY, NULL);
 
 	if (!QR_command_maybe_successful(res))
 		ret = SQL_ERROR;
-	else if (QR_command_maybe_successful(res) && QR_get_num_cached_tuples(res) > 0)
+	else
+		CC_set_lo_type(self, res);
+	QR_Destructor(res);
+	return ret;
+}
+
+/*
+ *	Set the large object type from the result of LO_LOOKUP_QUERY.
+ */
+static void
+CC_set_lo_type(ConnectionClass *self, const QResultClass *res)
+{
+	if (QR_get_num_cached_tuples(res) > 0)
 	{
 		OID	basetype;
 
@@ -2586,9 +3733,7 @@ CC_lookup_lo(ConnectionClass *self)
 		else if (0 != basetype)
 			self->lobj_type = 0;
 	}
-	QR_Destructor(res);
 	MYLOG(0, "Got the large object oid: %d\n", self->lobj_type);
-	return ret;
 }
 
 
@@ -2692,6 +3837,257 @@ int	CC_discard_marked_objects(ConnectionClass *conn)
 	return 1;
 }
 
+/*
+ *	The plan cache (PlanCacheSize) shares the server side plans of the
+ *	same queries among the statements of the connection. The callers
+ *	hold the critical section of the connection.
+ */
+static void
+free_plan_info(PLAN_INFO *plan)
+{
+	if (NULL != plan->describe)
+		PQclear(plan->describe);
+	if (NULL != plan->query)
+		free(plan->query);
+	if (NULL != plan->param_types)
+		free(plan->param_types);
+	free(plan);
+}
+
+static void
+CC_clear_plan_cache(ConnectionClass *self)
+{
+	int	i;
+
+	for (i = 0; i < self->nplans; i++)
+		free_plan_info(self->plan_cache[i]);
+	self->nplans = 0;
+	if (NULL != self->plan_cache)
+	{
+		free(self->plan_cache);
+		self->plan_cache = NULL;
+	}
+}
+
+static UInt4
+plan_hash(const char *query, Int2 num_params, const OID *param_types)
+{
+	UInt4	hashval = hash_bytes(query, strlen(query));
+
+	if (num_params > 0)
+		hashval ^= hash_bytes(param_types, num_params * sizeof(OID));
+	return hashval;
+}
+
+/*
+ *	Look up the plan of the query with the parameter types and mark it
+ *	in use. CC_release_plan() releases it.
+ */
+PLAN_INFO *
+CC_lookup_plan(ConnectionClass *self, const char *query, Int2 num_params, const OID *param_types)
+{
+	UInt4		hashval = plan_hash(query, num_params, param_types);
+	PLAN_INFO	*plan;
+	int		i;
+
+	for (i = 0; i < self->nplans; i++)
+	{
+		plan = self->plan_cache[i];
+		if (plan->hashval == hashval &&
+		    plan->num_params == num_params &&
+		    strcmp(plan->query, query) == 0 &&
+		    (num_params <= 0 ||
+		     memcmp(plan->param_types, param_types, num_params * sizeof(OID)) == 0))
+		{
+			plan->refcnt++;
+			plan->acc_seq = ++self->plan_seq;
+			MYLOG(0, "found plan %s refcnt=%d\n", plan->plan_name, plan->refcnt);
+			return plan;
+		}
+	}
+	return NULL;
+}
+
+/*
+ *	Add the plan prepared as plan_name to the cache and mark it in use.
+ *	The cache takes the ownership of the describe result on success.
+ *	The least recently used plan which isn't in use is evicted if the
+ *	cache is full, and NULL is returned if every plan is in use.
+ */
+PLAN_INFO *
+CC_add_plan(ConnectionClass *self, const char *query, Int2 num_params, const OID *param_types, const char *plan_name, PGresult *describe)
+{
+	PLAN_INFO	*plan, *evicted;
+	int		i, idx;
+
+	if (NULL == self->plan_cache)
+	{
+		self->plan_cache = (PLAN_INFO **) calloc(self->connInfo.plan_cache_size, sizeof(PLAN_INFO *));
+		if (NULL == self->plan_cache)
+			return NULL;
+	}
+	if (plan = (PLAN_INFO *) calloc(1, sizeof(PLAN_INFO)), NULL == plan)
+		return NULL;
+	plan->query = strdup(query);
+	if (num_params > 0)
+	{
+		if (plan->param_types = (OID *) malloc(num_params * sizeof(OID)), NULL != plan->param_types)
+			memcpy(plan->param_types, param_types, num_params * sizeof(OID));
+	}
+	if (NULL == plan->query ||
+	    (num_params > 0 && NULL == plan->param_types))
+	{
+		free_plan_info(plan);
+		return NULL;
+	}
+
+	idx = self->nplans;
+	if (idx >= self->connInfo.plan_cache_size)
+	{
+		idx = -1;
+		for (i = 0; i < self->nplans; i++)
+		{
+			if (0 < self->plan_cache[i]->refcnt)
+				continue;
+			if (idx < 0 ||
+			    self->plan_cache[i]->acc_seq < self->plan_cache[idx]->acc_seq)
+				idx = i;
+		}
+		if (idx < 0)
+		{
+			MYLOG(0, "all the %d plans are in use\n", self->nplans);
+			free_plan_info(plan);
+			return NULL;
+		}
+		evicted = self->plan_cache[idx];
+		MYLOG(0, "evicting plan %s\n", evicted->plan_name);
+		CC_mark_a_object_to_discard(self, 's', evicted->plan_name);
+		free_plan_info(evicted);
+		/* a transaction discards them on commit or rollback */
+		if (!CC_is_in_trans(self))
+			CC_discard_marked_objects(self);
+	}
+	else
+		self->nplans++;
+	plan->refcnt = 1;
+	plan->hashval = plan_hash(query, num_params, param_types);
+	plan->num_params = num_params;
+	STRCPY_FIXED(plan->plan_name, plan_name);
+	plan->describe = describe;
+	plan->acc_seq = ++self->plan_seq;
+	self->plan_cache[idx] = plan;
+	MYLOG(0, "added plan %s\n", plan->plan_name);
+
+	return plan;
+}
+
+void
+CC_release_plan(ConnectionClass *self, const char *plan_name)
+{
+	int	i;
+
+	for (i = 0; i < self->nplans; i++)
+	{
+		if (strcmp(self->plan_cache[i]->plan_name, plan_name) == 0)
+		{
+			self->plan_cache[i]->refcnt--;
+			MYLOG(0, "released plan %s refcnt=%d\n", plan_name, self->plan_cache[i]->refcnt);
+			break;
+		}
+	}
+}
+
+/*
+ *	The query cache (QueryCacheSize) keeps the statements converted by
+ *	copy_statement_with_parameters() without their parameter values.
+ *	The callers hold the critical section of the connection.
+ */
+void
+free_query_template(QUERY_TEMPLATE *tmpl)
+{
+	if (NULL != tmpl->query)
+		free(tmpl->query);
+	if (NULL != tmpl->text)
+		free(tmpl->text);
+	if (NULL != tmpl->slots)
+		free(tmpl->slots);
+	free(tmpl);
+}
+
+static void
+CC_clear_query_cache(ConnectionClass *self)
+{
+	int	i;
+
+	for (i = 0; i < self->ntemplates; i++)
+		free_query_template(self->query_cache[i]);
+	self->ntemplates = 0;
+	if (NULL != self->query_cache)
+	{
+		free(self->query_cache);
+		self->query_cache = NULL;
+	}
+}
+
+const QUERY_TEMPLATE *
+CC_lookup_query_template(ConnectionClass *self, const char *query, UInt4 build_flags)
+{
+	UInt4		hashval = hash_bytes(query, strlen(query));
+	QUERY_TEMPLATE	*tmpl;
+	int		i;
+
+	for (i = 0; i < self->ntemplates; i++)
+	{
+		tmpl = self->query_cache[i];
+		if (tmpl->hashval == hashval &&
+		    tmpl->build_flags == build_flags &&
+		    tmpl->ccsc == self->ccsc &&
+		    strcmp(tmpl->query, query) == 0)
+		{
+			tmpl->acc_seq = ++self->query_seq;
+			return tmpl;
+		}
+	}
+	return NULL;
+}
+
+/*
+ *	Add the template of tmpl->query to the cache, evicting the least
+ *	recently used one if the cache is full. The cache takes the
+ *	ownership of tmpl on success.
+ */
+BOOL
+CC_add_query_template(ConnectionClass *self, QUERY_TEMPLATE *tmpl)
+{
+	int		i, idx;
+
+	if (NULL == self->query_cache)
+	{
+		self->query_cache = (QUERY_TEMPLATE **) calloc(self->connInfo.query_cache_size, sizeof(QUERY_TEMPLATE *));
+		if (NULL == self->query_cache)
+			return FALSE;
+	}
+	idx = self->ntemplates;
+	if (idx >= self->connInfo.query_cache_size)
+	{
+		for (idx = 0, i = 1; i < self->ntemplates; i++)
+		{
+			if (self->query_cache[i]->acc_seq < self->query_cache[idx]->acc_seq)
+				idx = i;
+		}
+		free_query_template(self->query_cache[idx]);
+	}
+	else
+		self->ntemplates++;
+	tmpl->hashval = hash_bytes(tmpl->query, strlen(tmpl->query));
+	tmpl->ccsc = self->ccsc;
+	tmpl->acc_seq = ++self->query_seq;
+	self->query_cache[idx] = tmpl;
+	MYLOG(0, "added the template of %s\n", tmpl->query);
+
+	return TRUE;
+}
+
 static void
 LIBPQ_update_transaction_status(ConnectionClass *self)
 {
@@ -2739,6 +4135,100 @@ LIBPQ_update_transaction_status(ConnectionClass *self)
 
 #define        PROTOCOL3_OPTS_MAX      30
 
+/*
+ * Make the key of the connection pool from the connection parameters.
+ * The values are prefixed with their lengths so that any value can't
+ * be mistaken for another parameter.
+ */
+static char *
+make_pool_key(const char * const *opts, const char * const *vals)
+{
+	PQExpBufferData	key;
+
+	initPQExpBuffer(&key);
+	for (; *opts; opts++, vals++)
+		appendPQExpBuffer(&key, "%s=" FORMAT_SIZE_T ":%s;", *opts, strlen(*vals), *vals);
+	if (PQExpBufferDataBroken(key))
+	{
+		termPQExpBuffer(&key);
+		return NULL;
+	}
+	return key.data;
+}
+
+/*
+ * Does the reset query drop the prepared statements ? Otherwise the
+ * plans of the previous session (_PLAN...) are still there and the new
+ * statements may happen to get the same names.
+ */
+static BOOL
+deallocates_all(const char *query)
+{
+	static const char * const cmds[] = {"discard all", "deallocate all", "deallocate prepare all", NULL};
+	const char * const *cmd;
+	const char	*p;
+
+	for (p = query; *p; p++)
+	{
+		for (cmd = cmds; *cmd; cmd++)
+		{
+			if (strnicmp(p, *cmd, strlen(*cmd)) == 0)
+				return TRUE;
+		}
+	}
+	return FALSE;
+}
+
+/*
+ * Take a parked connection for the key out of the connection pool and
+ * reset its session state. The connections which are found broken are
+ * closed.
+ */
+static void *
+LIBPQ_take_pooled_conn(ConnectionClass *self, const char *key)
+{
+	const char	*reset_query = SAFE_NAME(self->connInfo.pool_reset_query);
+	void	   *pqconn;
+	PGresult   *pgres;
+	ExecStatusType	pgresstatus;
+	BOOL		deallocate;
+
+	if (!NAME_IS_VALID(self->connInfo.pool_reset_query))
+		reset_query = DEFAULT_POOLRESETQUERY;
+	deallocate = !deallocates_all(reset_query);
+	while (pqconn = EN_take_pqconn(key), NULL != pqconn)
+	{
+		if (CONNECTION_OK == PQstatus(pqconn))
+		{
+			QLOG(0, "PQexec: %p '%s'\n", pqconn, reset_query);
+			pgres = PQexec(pqconn, reset_query);
+			pgresstatus = PQresultStatus(pgres);
+			PQclear(pgres);
+			if (deallocate &&
+			    (PGRES_COMMAND_OK == pgresstatus ||
+			     PGRES_TUPLES_OK == pgresstatus ||
+			     PGRES_EMPTY_QUERY == pgresstatus))
+			{
+				/* DISCARD ALL can't be a part of a multiple command query */
+				QLOG(0, "PQexec: %p 'DEALLOCATE ALL'\n", pqconn);
+				pgres = PQexec(pqconn, "DEALLOCATE ALL");
+				pgresstatus = PQresultStatus(pgres);
+				PQclear(pgres);
+			}
+			if ((PGRES_COMMAND_OK == pgresstatus ||
+			     PGRES_TUPLES_OK == pgresstatus ||
+			     PGRES_EMPTY_QUERY == pgresstatus) &&
+			    PQTRANS_IDLE == PQtransactionStatus(pqconn))
+				return pqconn;
+			MYLOG(0, "reset of the pooled connection failed status=%d\n", pgresstatus);
+		}
+		QLOG(0, "PQfinish: %p\n", pqconn);
+		PQfinish(pqconn);
+	}
+
+	return NULL;
+}
+
 static int
 LIBPQ_connect(ConnectionClass *self)
 {
@@ -2755,6 +4245,7 @@ LIBPQ_connect(ConnectionClass *self)
 	char		keepalive_idle_str[20];
 	char		keepalive_interval_str[20];
 	char		*errmsg = NULL;
+	char		*pool_key = NULL;
 
 	MYLOG(0, "connecting to the database using %s as the server and pqopt={%s}\n", self->connInfo.server, SAFE_NAME(ci->pqopt));
 
@@ -2873,7 +4364,13 @@ LIBPQ_connect(ConnectionClass *self)
 			QPRINTF(0, " %s='%s'", *popt, *pval);
 		QPRINTF(0, "\n"); 
 	}
-	pqconn = PQconnectdbParams(opts, vals, FALSE);
+	if (ci->pool_size > 0)
+		pool_key = make_pool_key(opts, vals);
+	if (NULL != pool_key &&
+	    NULL != (pqconn = LIBPQ_take_pooled_conn(self, pool_key)))
+		QLOG(0, "reusing the pooled connection: %p\n", pqconn);
+	else
+		pqconn = PQconnectdbParams(opts, vals, FALSE);
 	if (!pqconn)
 	{
 		CC_set_error(self, CONN_OPENDB_ERROR, "PQconnectdb error", func);
@@ -2930,10 +4427,14 @@ MYLOG(DETAIL_LOG_LEVEL, "status=%d\n", pqret);
 	}
 
 	ret = 1;
+	self->pool_key = pool_key;
+	pool_key = NULL;
 
 cleanup:
 	if (errmsg != NULL)
 		free(errmsg);
+	if (pool_key != NULL)
+		free(pool_key);
 	PQconninfoFree(conninfoOption);
 	if (ret != 1)
 	{
@@ -3548,10 +5049,25 @@ PgDtc_isolate(void *self, DWORD option)
 
 #endif /* _HANDLE_ENLIST_IN_DTC_ */
 
+static const char *
+CC_isolation_query(UInt4 isolation)
+{
+	switch (isolation)
+	{
+		case SQL_TXN_SERIALIZABLE:
+			return "SET SESSION CHARACTERISTICS AS TRANSACTION ISOLATION LEVEL SERIALIZABLE";
+		case SQL_TXN_REPEATABLE_READ:
+			return "SET SESSION CHARACTERISTICS AS TRANSACTION ISOLATION LEVEL REPEATABLE READ";
+		case SQL_TXN_READ_UNCOMMITTED:
+			return "SET SESSION CHARACTERISTICS AS TRANSACTION ISOLATION LEVEL READ UNCOMMITTED";
+	}
+	return "SET SESSION CHARACTERISTICS AS TRANSACTION ISOLATION LEVEL READ COMMITTED";
+}
+
 BOOL
 CC_set_transact(ConnectionClass *self, UInt4 isolation)
 {
-	char *query;
+	const char *query;
 	QResultClass *res;
 	BOOL	bShow = FALSE;
 
@@ -3563,21 +5079,7 @@ CC_set_transact(ConnectionClass *self, UInt4 isolation)
 		return FALSE;
 	}
 
-	switch (isolation)
-	{
-		case SQL_TXN_SERIALIZABLE:
-			query = "SET SESSION CHARACTERISTICS AS TRANSACTION ISOLATION LEVEL SERIALIZABLE";
-						break;
-		case SQL_TXN_REPEATABLE_READ:
-			query = "SET SESSION CHARACTERISTICS AS TRANSACTION ISOLATION LEVEL REPEATABLE READ";
-			break;
-		case SQL_TXN_READ_UNCOMMITTED:
-			query = "SET SESSION CHARACTERISTICS AS TRANSACTION ISOLATION LEVEL READ UNCOMMITTED";
-			break;
-		default:
-			query = "SET SESSION CHARACTERISTICS AS TRANSACTION ISOLATION LEVEL READ COMMITTED";
-			break;
-	}
+	query = CC_isolation_query(isolation);
 	if (self->default_isolation == 0)
 		bShow = TRUE;
 	if (bShow)
@@ -71,6 +71,7 @@ typedef enum
 
 #define CONN_OPTION_NOT_FOR_THE_DRIVER					216
 #define CONN_EXEC_ERROR							217
+#define CONN_SEQUENCE_ERROR						218
 
 /* Conn_status defines */
 #define CONN_IN_AUTOCOMMIT		1L
@@ -116,6 +117,12 @@ typedef enum
 #define	CC_is_in_global_trans(x)	(NULL != (x)->asdum)
 #define	ALLOW_WCHAR(x)	(0 != (x->unicode & CONN_UNICODE_DRIVER) && 0 == (x->unicode & CONN_DISALLOW_WCHAR))
 
+/* Performance metrics */
+#define	CC_collects_metrics(x)	(0 != (x)->connInfo.collect_metrics)
+#define	METRICS_START(x)	(CC_collects_metrics(x) ? get_clock_usec() : 0)
+#define	CC_caches_plans(x)	(0 < (x)->connInfo.plan_cache_size)
+#define	CC_caches_queries(x)	(0 < (x)->connInfo.query_cache_size)
+
 #define CC_MALLOC_return_with_error(t, tp, s, x, m, ret) \
 do { \
 	if (t = malloc(s), NULL == t) \
@@ -240,6 +247,9 @@ struct col_info
 	OID		table_oid;
 	int		table_info;
 	time_t		acc_time;
+	SharedColInfo	*shared;	/* the result is shared by the connections */
+	COL_INFO	*name_next;	/* in the hash table by the names */
+	COL_INFO	*oid_next;	/* in the hash table by the oid */
 };
 enum {
 	TBINFO_HASOIDS	 = 1L
@@ -247,8 +257,11 @@ enum {
 };
 #define free_col_info_contents(coli) \
 { \
-	if (NULL != coli->result) \
+	if (NULL != coli->shared) \
+		EN_release_shared_col_info(coli->shared); \
+	else if (NULL != coli->result) \
 		QR_Destructor(coli->result); \
+	coli->shared = NULL; \
 	coli->result = NULL; \
 	NULL_THE_NAME(coli->schema_name); \
 	NULL_THE_NAME(coli->table_name); \
@@ -258,6 +271,47 @@ enum {
 }
 #define col_info_initialize(coli) (memset(coli, 0, sizeof(COL_INFO)))
 
+/*	This is used to share the server side plans among the statements */
+struct plan_info
+{
+	Int2		refcnt;		/* the statements using the plan */
+	UInt4		hashval;	/* of the query */
+	char		*query;
+	Int2		num_params;
+	OID		*param_types;
+	char		plan_name[40];
+	PGresult	*describe;	/* the result of PQdescribePrepared */
+	UInt4		acc_seq;
+};
+
+/*
+ *	This is used to skip scanning the same statements again when the
+ *	parameters are substituted on the driver side. The text is the
+ *	converted statement without the parameter values which are put
+ *	at the slots.
+ */
+typedef struct
+{
+	size_t		pos;		/* in the text */
+	Int2		param_number;	/* the preceding parameter number */
+} QUERY_SLOT;
+
+struct query_template
+{
+	UInt4		hashval;	/* of the query */
+	char		*query;
+	UInt4		build_flags;	/* the conversion depends on */
+	int		ccsc;
+	char		*text;
+	size_t		textlen;
+	Int2		nslots;
+	QUERY_SLOT	*slots;
+	Int2		statement_type;
+	UInt4		parse_flags;
+	char		join_info;
+	UInt4		acc_seq;
+};
+
  /* Translation DLL entry points */
 #ifdef WIN32
 #define DLLHANDLE HINSTANCE
@@ -297,6 +351,8 @@ struct ConnectionClass_
 	Int2		coli_allocated;
 	Int2		ntables;
 	COL_INFO	**col_info;
+	COL_INFO	**coli_name_hash;	/* col_info hashed by the table names */
+	COL_INFO	**coli_oid_hash;	/* col_info hashed by the table oid */
 	long		translation_option;
 	HINSTANCE	translation_handle;
 	DataSourceToDriverProc DataSourceToDriver;
@@ -342,6 +398,22 @@ struct ConnectionClass_
 	pgNAME		schemaIns;
 	pgNAME		tableIns;
 	SQLULEN		stmt_timeout_in_effect;
+	char		*pool_key;		/* key of the connection pool, NULL unless pooled */
+	PG_Metrics	metrics;	/* CollectMetrics, the connection totals */
+	PG_QueryMetrics	*query_metrics;	/* CollectMetrics, per query */
+	Int4		num_query_metrics;
+	Int4		nplans;
+	PLAN_INFO	**plan_cache;	/* PlanCacheSize entries */
+	UInt4		plan_seq;	/* to name the cached plans and find
+					 * the least recently used one */
+	Int4		ntemplates;
+	QUERY_TEMPLATE	**query_cache;	/* QueryCacheSize entries */
+	UInt4		query_seq;	/* to find the least recently used
+					 * template */
+	QResultClass	*prefetch_res;	/* the result whose FETCH is read ahead */
+	char		prefetch_svp;	/* the FETCH read ahead runs in a savepoint */
+	ASYNC_QUERY	*async_query;	/* the query sent by the asynchronous
+					 * execution */
 #if defined(WIN_MULTITHREAD_SUPPORT)
 	CRITICAL_SECTION	cs;
 	CRITICAL_SECTION	slock;
@@ -426,6 +498,9 @@ void		handle_pgres_error(ConnectionClass *self, const PGresult *pgres,
 				   QResultClass *res, BOOL error_not_a_notice);
 void		CC_clear_error(ConnectionClass *self);
 int		CC_send_function(ConnectionClass *conn, const char *fn_name, void *result_buf, int *actual_result_len, int result_is_int, LO_ARG *argv, int nargs);
+int		CC_send_function_query(ConnectionClass *conn, const char *query, LO_ARG *argv, int nargs, LO_ARG *results, int nresults);
+Int8		odbc_hton64(Int8 h64);
+Int8		odbc_ntoh64(Int8 n64);
 char		CC_send_settings(ConnectionClass *self, const char *set_query);
 void		CC_initialize_pg_version(ConnectionClass *conn);
 void		CC_log_error(const char *func, const char *desc, const ConnectionClass *self);
@@ -437,6 +512,19 @@ void		ProcessRollback(ConnectionClass *conn, BOOL undo, BOOL partial);
 const char	*CC_get_current_schema(ConnectionClass *conn);
 int             CC_mark_a_object_to_discard(ConnectionClass *conn, int type, const char *plan);
 int             CC_discard_marked_objects(ConnectionClass *conn);
+void		CC_index_col_info(ConnectionClass *self);
+COL_INFO	*CC_find_col_info(const ConnectionClass *self, const char *schema_name, const char *table_name);
+COL_INFO	*CC_find_col_info_by_oid(const ConnectionClass *self, OID table_oid);
+BOOL		CC_get_coli_share_key(const ConnectionClass *self, char *key, size_t keysize);
+PLAN_INFO	*CC_lookup_plan(ConnectionClass *self, const char *query, Int2 num_params, const OID *param_types);
+PLAN_INFO	*CC_add_plan(ConnectionClass *self, const char *query, Int2 num_params, const OID *param_types, const char *plan_name, PGresult *describe);
+void		CC_release_plan(ConnectionClass *self, const char *plan_name);
+const QUERY_TEMPLATE	*CC_lookup_query_template(ConnectionClass *self, const char *query, UInt4 build_flags);
+BOOL		CC_add_query_template(ConnectionClass *self, QUERY_TEMPLATE *tmpl);
+void		free_query_template(QUERY_TEMPLATE *tmpl);
+void		CC_prefetch(ConnectionClass *self, QResultClass *res, Int4 fetch_size);
+void		CC_finish_prefetch(ConnectionClass *self);
+QResultClass	*CC_receive_prefetched(ConnectionClass *self, QueryInfo *qi, StatementClass *stmt);
 
 int		CC_get_max_idlen(ConnectionClass *self);
 char	CC_get_escape(const ConnectionClass *self);
@@ -448,6 +536,10 @@ int		eatTableIdentifiers(const UCHAR *str, int ccsc, pgNAME *table, pgNAME *sche
 const		char *CurrCat(const ConnectionClass *self);
 const		char *CurrCatString(const ConnectionClass *self);
 SQLUINTEGER	CC_get_isolation(ConnectionClass *self);
+void		CC_reset_metrics(ConnectionClass *self);
+void		CC_count_execute(ConnectionClass *self, StatementClass *stmt);
+void		CC_add_metrics(ConnectionClass *self, StatementClass *stmt, const PG_Metrics *metrics);
+size_t		CC_metrics_report(ConnectionClass *self, char *buf, size_t bufsize);
 
 SQLCHAR	*make_lstring_ifneeded(ConnectionClass *, const SQLCHAR *s, ssize_t len, BOOL);
 
@@ -478,6 +570,7 @@ enum {
 	,ROLLBACK_ON_ERROR	= (1L << 3) /* rollback the query when an error occurs */
 	,END_WITH_COMMIT	= (1L << 4) /* the query ends with COMMIT command */
 	,READ_ONLY_QUERY	= (1L << 5) /* the query is read-only */
+	,SEND_ASYNCHRONOUSLY	= (1L << 6) /* don't wait for the results */
 };
 /* CC_on_abort options */
 #define	NO_TRANS		1L
@@ -497,6 +590,42 @@ typedef struct
 
 void receive_libpq_notice(void *arg, const PGresult *pgres);
 
+/*
+ *	The query sent by the asynchronous execution (SQL_ATTR_ASYNC_ENABLE).
+ *	CC_poll_async_query() collects its results without blocking, then the
+ *	execution is replayed and CC_send_query_append() processes them
+ *	instead of sending the query again.
+ */
+struct async_query
+{
+	StatementClass	*stmt;		/* the statement sending the query */
+	char		*query;
+	/* the state of CC_send_query_append() after sending the query */
+	BOOL		rollback_on_error;
+	BOOL		query_rollback;
+	BOOL		discard_next_begin;
+	BOOL		discard_next_savepoint;
+	Int8		start_usec;
+	QResultClass	*cmdres;	/* receives the notices meanwhile */
+	notice_receiver_arg	nrarg;
+	/* the collected results */
+	PGresult	**results;
+	int		num_results;
+	int		alloc_results;
+	int		next_result;
+	BOOL		completed;
+	BOOL		nomem;
+#ifdef	USE_ASYNC_NOTIFICATION
+	WSAEVENT	sockevent;	/* signaled when the socket gets ready */
+	HANDLE		waiter;
+#endif /* USE_ASYNC_NOTIFICATION */
+};
+
+#define	CC_is_async_executing(conn, astmt) \
+	(NULL != (conn)->async_query && (astmt) == (conn)->async_query->stmt)
+BOOL	CC_poll_async_query(ConnectionClass *self, BOOL wait);
+void	CC_discard_async_query(ConnectionClass *self);
+
 /*
  *	internal savepoint related
  */
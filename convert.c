@@ -18,6 +18,7 @@
 /* Multibyte support  Eiji Tokuya	2001-03-15	*/
 
 #include "convert.h"
+#include "canonical.h"
 #include "unicode_support.h"
 #include "misc.h"
 #ifdef	WIN32
@@ -38,6 +39,12 @@
 #include <math.h>
 #include <stdlib.h>
 #include <limits.h>
+#ifdef	WIN32
+#include <process.h>
+#endif /* WIN32 */
+#ifndef	WIN32
+#include <float.h>
+#endif /* WIN32 */
 #include "statement.h"
 #include "qresult.h"
 #include "bind.h"
@@ -46,6 +53,12 @@
 #include "connection.h"
 #include "catfunc.h"
 #include "pgapifunc.h"
+#ifdef	USE_SSE2
+#include <emmintrin.h>
+#ifdef	USE_AVX2
+#include <immintrin.h>
+#endif /* USE_AVX2 */
+#endif /* USE_SSE2 */
 
 CSTR	NAN_STRING = "NaN";
 CSTR	INFINITY_STRING = "Infinity";
@@ -183,18 +196,6 @@ static const struct
 	{0, 0}
 };
 
-typedef struct
-{
-	int		infinity;
-	int			m;
-	int			d;
-	int			y;
-	int			hh;
-	int			mm;
-	int			ss;
-	int			fr;
-} SIMPLE_TIME;
-
 static const char *mapFunction(const char *func, int param_count, const char * keyword);
 static BOOL convert_money(const char *s, char *sout, size_t soutmax);
 static char parse_datetime(const char *buf, SIMPLE_TIME *st);
@@ -203,10 +204,17 @@ static size_t convert_from_pgbinary(const char *value, char *rgbValue, SQLLEN cb
 static int convert_lo(StatementClass *stmt, const void *value, SQLSMALLINT fCType,
 	 PTR rgbValue, SQLLEN cbValueMax, SQLLEN *pcbValue);
 static int conv_from_octal(const char *s);
+static int convert_field_to_row(StatementClass *stmt,
+		SQLSETPOSIROW bind_row, int current_col,
+		OID field_type, int atttypmod, void *value,
+		SQLSMALLINT fCType, int precision,
+		PTR rgbValue, SQLLEN cbValueMax,
+		SQLLEN *pcbValue, SQLLEN *pIndicator);
 static SQLLEN pg_bin2hex(const char *src, char *dst, SQLLEN length);
 #ifdef	UNICODE_SUPPORT
 static SQLLEN pg_bin2whex(const char *src, SQLWCHAR *dst, SQLLEN length);
 #endif /* UNICODE_SUPPORT */
+static SQLLEN pg_hex2uhex(const char *src, char *dst, SQLLEN length);
 
 /*---------
  *			A Guide for date/time/timestamp conversions
@@ -294,6 +302,9 @@ timestamp2stime(const char *str, SIMPLE_TIME *st, BOOL *bZone, int *zone)
 	*zone = 0;
 	st->fr = 0;
 	st->infinity = 0;
+	/* the time zone isn't adjusted without withZone */
+	if (!withZone && parse_canonical_timestamp(str, st, bZone, zone))
+		return TRUE;
 	rest[0] = '\0';
 	bc[0] = '\0';
 	if ((scnt = sscanf(str, "%4d-%2d-%2d %2d:%2d:%2d%31s %15s", &y, &m, &d, &hh, &mm, &ss, rest, bc)) < 6)
@@ -766,6 +777,7 @@ static void set_client_decimal_point(char *num)
 	}
 }
 #else
+static char get_current_decimal_point(void) { return '.'; }
 static void set_server_decimal_point(char *num) {}
 static void set_client_decimal_point(char *num, BOOL) {}
 #endif /* HAVE_LOCALE_H */
@@ -777,15 +789,25 @@ copy_and_convert_field_bindinfo(StatementClass *stmt, OID field_type, int atttyp
 	ARDFields *opts = SC_get_ARDF(stmt);
 	BindInfoClass *bic;
 	SQLULEN	offset = opts->row_offset_ptr ? *opts->row_offset_ptr : 0;
+	Int8	start_usec = METRICS_START(SC_get_conn(stmt));
+	int	ret;
 
 	if (opts->allocated <= col)
 		extend_column_bindings(opts, col + 1);
 	bic = &(opts->bindings[col]);
 	SC_set_current_col(stmt, -1);
-	return copy_and_convert_field(stmt, field_type, atttypmod, value,
+	ret = copy_and_convert_field(stmt, field_type, atttypmod, value,
 		bic->returntype, bic->precision,
 		(PTR) (bic->buffer + offset), bic->buflen,
 		LENADDR_SHIFT(bic->used, offset), LENADDR_SHIFT(bic->indicator, offset));
+	if (start_usec > 0)
+	{
+		PG_Metrics	metrics = {0};
+
+		metrics.convert_usec = get_clock_usec() - start_usec;
+		CC_add_metrics(SC_get_conn(stmt), stmt, &metrics);
+	}
+	return ret;
 }
 
 /*
@@ -852,6 +874,22 @@ static double get_double_value(const char *str)
 	return atof(str);
 }
 
+
+/*
+ * The double value of a float or numeric output of the server.  Unless in
+ * the canonical form, the decimal point is converted for atof().
+ */
+static double
+get_client_double_value(const char *str)
+{
+	double	dval;
+
+	if (parse_canonical_double(str, &dval))
+		return dval;
+	set_client_decimal_point((char *) str);
+	return get_double_value(str);
+}
+
 static int char2guid(const char *str, SQLGUID *g)
 {
 	/*
@@ -913,11 +951,20 @@ get_adjust_len(SQLSMALLINT fCType, SQLLEN len)
 #define	BYTEA_PROCESS_ESCAPE	1
 #define	BYTEA_PROCESS_BINARY	2
 
+/* the conversion buffer up to this size is kept for the next row */
+#define	TTLBUF_KEEP_SIZE	8192
+
+/*
+ * Convert the field into the conversion buffer (ttlbuf) of pgdc if needed.
+ * A SQL_C_WCHAR value which fits in rgbValueBindRow is converted there
+ * directly, and *copied_return is set.
+ */
 static int
 setup_getdataclass(SQLLEN * const length_return, const char ** const ptr_return,
 	int *needbuflen_return, GetDataClass * const pgdc, const char *neut_str,
 	const OID field_type, const SQLSMALLINT fCType,
-	const SQLLEN cbValueMax, const ConnectionClass * const conn)
+	char * const rgbValueBindRow, const SQLLEN cbValueMax,
+	const ConnectionClass * const conn, BOOL * const copied_return)
 {
 	SQLLEN len = (-2);
 	const char *ptr = NULL;
@@ -988,7 +1035,18 @@ setup_getdataclass(SQLLEN * const length_return, const char ** const ptr_return,
 		}
 		else	/* normally */
 		{
-			unicode_count = utf8_to_ucs2_lf(neut_str, SQL_NTS, lf_conv, NULL, 0, FALSE);
+			SQLULEN	bufcount = (NULL != rgbValueBindRow && cbValueMax > 0) ? cbValueMax / WCLEN : 0;
+
+			/* try converting into the application buffer at once */
+			unicode_count = utf8_to_ucs2_lf(neut_str, SQL_NTS, lf_conv, bufcount > 0 ? (SQLWCHAR *) rgbValueBindRow : NULL, bufcount, FALSE);
+			if ((SQLULEN) unicode_count < bufcount)
+			{
+				len = WCLEN * unicode_count;
+				needbuflen = len + WCLEN;
+				ptr = rgbValueBindRow;
+				*copied_return = TRUE;
+				goto cleanup;
+			}
 		}
 		len = WCLEN * unicode_count;
 		already_processed = changed = TRUE;
@@ -1082,6 +1140,9 @@ setup_getdataclass(SQLLEN * const length_return, const char ** const ptr_return,
 
 		if (already_processed)
 			;
+		else if (BYTEA_PROCESS_ESCAPE == bytea_process_kind &&
+				 BYTEA_ESCAPE_CHAR == neut_str[0] && 'x' == neut_str[1])
+			len = pg_hex2uhex(neut_str + 2, pgdc->ttlbuf, len);
 		else if (0 != bytea_process_kind)
 		{
 			len = convert_from_pgbinary(neut_str, pgdc->ttlbuf, pgdc->ttlbuflen);
@@ -1095,7 +1156,7 @@ setup_getdataclass(SQLLEN * const length_return, const char ** const ptr_return,
 	}
 	else
 	{
-		if (pgdc->ttlbuf)
+		if (pgdc->ttlbuf && pgdc->ttlbuflen > TTLBUF_KEEP_SIZE)
 		{
 			free(pgdc->ttlbuf);
 			pgdc->ttlbuf = NULL;
@@ -1137,6 +1198,7 @@ convert_text_field_to_sql_c(GetDataInfo * const gdata, const int current_col,
 	GetDataClass *pgdc;
 	int	copy_len = 0, needbuflen = 0, i;
 	const char	*ptr;
+	BOOL	copied = FALSE;
 
 	MYLOG(0, "field_type=%u type=%d\n", field_type, fCType);
 
@@ -1160,7 +1222,7 @@ convert_text_field_to_sql_c(GetDataInfo * const gdata, const int current_col,
 	{
 		if (COPY_OK != (result = setup_getdataclass(&len, &ptr,
 				&needbuflen, pgdc, neut_str, field_type,
-				fCType, cbValueMax, conn)))
+				fCType, rgbValueBindRow, cbValueMax, conn, &copied)))
 			goto cleanup;
 	}
 	else
@@ -1185,7 +1247,7 @@ convert_text_field_to_sql_c(GetDataInfo * const gdata, const int current_col,
 
 	if (cbValueMax > 0)
 	{
-		BOOL	already_copied = FALSE;
+		BOOL	already_copied = copied;
 		int		terminatorlen;
 
 		terminatorlen = get_terminator_len(fCType);
@@ -1218,7 +1280,7 @@ convert_text_field_to_sql_c(GetDataInfo * const gdata, const int current_col,
 		result = COPY_RESULT_TRUNCATED;
 	else
 	{
-		if (pgdc->ttlbuf != NULL)
+		if (pgdc->ttlbuf != NULL && pgdc->ttlbuflen > TTLBUF_KEEP_SIZE)
 		{
 			free(pgdc->ttlbuf);
 			pgdc->ttlbuf = NULL;
@@ -1241,6 +1303,219 @@ cleanup:
 	return result;
 }
 
+/*
+ *	Get the integer value of a big-endian binary field of the given width.
+ */
+static Int8
+get_binary_integer(const char *value, int width)
+{
+	const UCHAR	*p = (const UCHAR *) value;
+	Int8	n64;
+
+	switch (width)
+	{
+		case 2:
+			return (Int2) ((p[0] << 8) | p[1]);
+		case 4:
+			return (Int4) (((UInt4) p[0] << 24) | ((UInt4) p[1] << 16) | ((UInt4) p[2] << 8) | p[3]);
+	}
+	memcpy(&n64, value, sizeof(n64));
+	return odbc_ntoh64(n64);
+}
+
+/*
+ *	Get the value of a big-endian binary float4 or float8 field.
+ */
+static double
+get_binary_double(const char *value, OID field_type)
+{
+	Int8	ival;
+	double	dval;
+
+	if (PG_TYPE_FLOAT4 == field_type)
+	{
+		UInt4	uval = (UInt4) get_binary_integer(value, 4);
+		SFLOAT	flv;
+
+		memcpy(&flv, &uval, sizeof(flv));
+		return flv;
+	}
+	ival = get_binary_integer(value, 8);
+	memcpy(&dval, &ival, sizeof(dval));
+	return dval;
+}
+
+/*
+ *	Put the text representation of a float value received in binary
+ *	format into buf, using the fewest digits which read back the same
+ *	value like the server does.
+ */
+static void
+binary_float_to_text(double dval, BOOL is_float4, char *buf, size_t bufsize)
+{
+	int	digits;
+
+	if (dval != dval)
+	{
+		strncpy_null(buf, NAN_STRING, bufsize);
+		return;
+	}
+	else if (dval > DBL_MAX)
+	{
+		strncpy_null(buf, INFINITY_STRING, bufsize);
+		return;
+	}
+	else if (dval < -DBL_MAX)
+	{
+		strncpy_null(buf, MINFINITY_STRING, bufsize);
+		return;
+	}
+	for (digits = is_float4 ? FLT_DIG : DBL_DIG;; digits++)
+	{
+		snprintf(buf, bufsize, "%.*g", digits, dval);
+		if (is_float4)
+		{
+			if (digits >= PG_REAL_DIGITS || (float) strtod(buf, NULL) == (float) dval)
+				break;
+		}
+		else if (digits >= PG_DOUBLE_DIGITS || strtod(buf, NULL) == dval)
+			break;
+	}
+	set_server_decimal_point(buf, SQL_NTS);
+}
+
+/*
+ *	Convert a fixed-width value received in binary format (see
+ *	pgtype_binary_transferable()).  The value is stored into the
+ *	application buffer directly if the C type matches the type of
+ *	the field and the copied length is returned. Otherwise 0 is
+ *	returned and the text representation of the value is put into buf
+ *	so that the caller can convert it the usual way.
+ */
+static SQLLEN
+convert_binary_field(const StatementClass *stmt, SQLSETPOSIROW bind_row,
+		OID field_type, const char *value, SQLSMALLINT fCType,
+		PTR rgbValue, char *rgbValueBindRow, char *buf, size_t bufsize)
+{
+	int		bind_size = SC_get_ARDF(stmt)->bind_size;
+	Int8		ival = 0;
+	double		dval = .0;
+	SQLLEN		len = 0;
+
+	switch (field_type)
+	{
+		case PG_TYPE_BOOL:
+			ival = (0 != value[0]);
+			break;
+		case PG_TYPE_INT2:
+			ival = get_binary_integer(value, 2);
+			break;
+		case PG_TYPE_INT4:
+		case PG_TYPE_OID:
+			ival = get_binary_integer(value, 4);
+			break;
+		case PG_TYPE_INT8:
+			ival = get_binary_integer(value, 8);
+			break;
+		case PG_TYPE_FLOAT4:
+		case PG_TYPE_FLOAT8:
+			dval = get_binary_double(value, field_type);
+			break;
+	}
+
+	switch (fCType)
+	{
+		case SQL_C_BIT:
+			if (PG_TYPE_BOOL != field_type)
+				break;
+			len = 1;
+			if (bind_size > 0)
+				*((UCHAR *) rgbValueBindRow) = (UCHAR) ival;
+			else
+				*((UCHAR *) rgbValue + bind_row) = (UCHAR) ival;
+			break;
+		case SQL_C_SSHORT:
+		case SQL_C_SHORT:
+			if (PG_TYPE_INT2 != field_type)
+				break;
+			len = 2;
+			if (bind_size > 0)
+				*((SQLSMALLINT *) rgbValueBindRow) = (SQLSMALLINT) ival;
+			else
+				*((SQLSMALLINT *) rgbValue + bind_row) = (SQLSMALLINT) ival;
+			break;
+		case SQL_C_SLONG:
+		case SQL_C_LONG:
+			if (PG_TYPE_INT4 != field_type && PG_TYPE_INT2 != field_type)
+				break;
+			len = 4;
+			if (bind_size > 0)
+				*((SQLINTEGER *) rgbValueBindRow) = (SQLINTEGER) ival;
+			else
+				*((SQLINTEGER *) rgbValue + bind_row) = (SQLINTEGER) ival;
+			break;
+		case SQL_C_ULONG:
+			if (PG_TYPE_OID != field_type)
+				break;
+			len = 4;
+			if (bind_size > 0)
+				*((SQLUINTEGER *) rgbValueBindRow) = (SQLUINTEGER) ival;
+			else
+				*((SQLUINTEGER *) rgbValue + bind_row) = (SQLUINTEGER) ival;
+			break;
+#ifdef ODBCINT64
+		case SQL_C_SBIGINT:
+			if (PG_TYPE_INT8 != field_type && PG_TYPE_INT4 != field_type && PG_TYPE_INT2 != field_type)
+				break;
+			len = 8;
+			if (bind_size > 0)
+				*((SQLBIGINT *) rgbValueBindRow) = ival;
+			else
+				*((SQLBIGINT *) rgbValue + bind_row) = ival;
+			break;
+#endif /* ODBCINT64 */
+		case SQL_C_FLOAT:
+			if (PG_TYPE_FLOAT4 != field_type)
+				break;
+			len = 4;
+			if (bind_size > 0)
+				*((SFLOAT *) rgbValueBindRow) = (SFLOAT) dval;
+			else
+				*((SFLOAT *) rgbValue + bind_row) = (SFLOAT) dval;
+			break;
+		case SQL_C_DOUBLE:
+			if (PG_TYPE_FLOAT8 != field_type && PG_TYPE_FLOAT4 != field_type)
+				break;
+			len = 8;
+			if (bind_size > 0)
+				*((SDOUBLE *) rgbValueBindRow) = dval;
+			else
+				*((SDOUBLE *) rgbValue + bind_row) = dval;
+			break;
+	}
+	if (len > 0)
+		return len;
+
+	/* fall back to the text representation */
+	switch (field_type)
+	{
+		case PG_TYPE_BOOL:
+			strncpy_null(buf, ival ? "t" : "f", bufsize);
+			break;
+		case PG_TYPE_OID:
+			snprintf(buf, bufsize, FORMAT_UINTEGER, (SQLUINTEGER) ival);
+			break;
+		case PG_TYPE_FLOAT4:
+		case PG_TYPE_FLOAT8:
+			binary_float_to_text(dval, PG_TYPE_FLOAT4 == field_type, buf, bufsize);
+			break;
+		default:
+			snprintf(buf, bufsize, FORMATI64, ival);
+			break;
+	}
+	return 0;
+}
+
 /*	This is called by SQLGetData() */
 int
 copy_and_convert_field(StatementClass *stmt,
@@ -1249,6 +1524,27 @@ copy_and_convert_field(StatementClass *stmt,
 		SQLSMALLINT fCType, int precision,
 		PTR rgbValue, SQLLEN cbValueMax,
 		SQLLEN *pcbValue, SQLLEN *pIndicator)
+{
+	return convert_field_to_row(stmt, stmt->bind_row, stmt->current_col,
+				field_type, atttypmod, valuei, fCType, precision,
+				rgbValue, cbValueMax, pcbValue, pIndicator);
+}
+
+/*
+ *	Convert a field into the bind_row-th row of the buffers.
+ *	current_col is the column of SQLGetData() or -1 for a bound column.
+ *	Apart from large objects and SQLGetData() it only reads stmt, so
+ *	the bound columns of different rows can be converted in parallel
+ *	(see copy_and_convert_rowset()).
+ */
+static int
+convert_field_to_row(StatementClass *stmt,
+		SQLSETPOSIROW bind_row, int current_col,
+		OID field_type, int atttypmod,
+		void *valuei,
+		SQLSMALLINT fCType, int precision,
+		PTR rgbValue, SQLLEN cbValueMax,
+		SQLLEN *pcbValue, SQLLEN *pIndicator)
 {
 	CSTR func = "copy_and_convert_field";
 	const char *value = valuei;
@@ -1263,7 +1559,6 @@ copy_and_convert_field(StatementClass *stmt,
 				rgbValueOffset;
 	char	   *rgbValueBindRow = NULL;
 	SQLLEN		*pcbValueBindRow = NULL, *pIndicatorBindRow = NULL;
-	SQLSETPOSIROW		bind_row = stmt->bind_row;
 	int			bind_size = opts->bind_size;
 	int			result = COPY_OK;
 	const ConnectionClass	*conn = SC_get_conn(stmt);
@@ -1271,17 +1566,19 @@ copy_and_convert_field(StatementClass *stmt,
 	const char *neut_str = value;
 	char		booltemp[3];
 	char		midtemp[64];
+	char		bintemp[32];
 	GetDataClass *pgdc;
+	QResultClass	*res;
 
-	if (stmt->current_col >= 0)
+	if (current_col >= 0)
 	{
-		if (stmt->current_col >= opts->allocated)
+		if (current_col >= opts->allocated)
 		{
 			return SQL_ERROR;
 		}
 		if (gdata->allocated != opts->allocated)
 			extend_getdata_info(gdata, opts->allocated, TRUE);
-		pgdc = &gdata->gdata[stmt->current_col];
+		pgdc = &gdata->gdata[current_col];
 		if (pgdc->data_left == -2)
 			pgdc->data_left = (cbValueMax > 0) ? 0 : -1; /* This seems to be *
 						 * needed by ADO ? */
@@ -1326,7 +1623,8 @@ copy_and_convert_field(StatementClass *stmt,
 
 	memset(&std_time, 0, sizeof(SIMPLE_TIME));
 
-	MYLOG(0, "field_type = %d, fctype = %d, value = '%s', cbValueMax=" FORMAT_LEN "\n", field_type, fCType, (value == NULL) ? "<NULL>" : value, cbValueMax);
+	res = SC_get_Curres(stmt);
+	MYLOG(0, "field_type = %d, fctype = %d, value = '%s', cbValueMax=" FORMAT_LEN "\n", field_type, fCType, (value == NULL) ? "<NULL>" : ((NULL != res && QR_is_binary_format(res)) ? "<binary>" : value), cbValueMax);
 
 	if (!value)
 	{
@@ -1393,6 +1691,26 @@ MYLOG(0, "null_cvt_date_string=%d\n", conn->connInfo.cvt_null_date_string);
 		}
 	}
 
+	/* decode the fixed-width values received in binary format */
+	if (NULL != res && QR_is_binary_format(res))
+	{
+		SQLSMALLINT	bin_ctype = fCType;
+
+		if (SQL_C_DEFAULT == bin_ctype)
+			bin_ctype = pgtype_attr_to_ctype(conn, field_type, atttypmod);
+		len = convert_binary_field(stmt, bind_row, field_type, value, bin_ctype, rgbValue, rgbValueBindRow, bintemp, sizeof(bintemp));
+		if (len > 0)
+		{
+			if (pcbValue)
+				*pcbValueBindRow = len;
+			if (current_col >= 0)
+				gdata->gdata[current_col].data_left = 0;
+			return COPY_OK;
+		}
+		valuei = bintemp;
+		value = neut_str = bintemp;
+	}
+
 	if (stmt->hdbc->DataSourceToDriver != NULL)
 	{
 		size_t			length = strlen(value);
@@ -1416,7 +1734,15 @@ MYLOG(0, "null_cvt_date_string=%d\n", conn->connInfo.cvt_null_date_string);
 			 * PG_TYPE_CHAR,VARCHAR $$$
 			 */
 		case PG_TYPE_DATE:
-			sscanf(value, "%4d-%2d-%2d", &std_time.y, &std_time.m, &std_time.d);
+			{
+				BOOL	bZone;
+				int	zone;
+
+				if (!parse_canonical_timestamp(value, &std_time, &bZone, &zone))
+					sscanf(value, "%4d-%2d-%2d", &std_time.y, &std_time.m, &std_time.d);
+				else if (std_time.y < 0)
+					std_time.y = -std_time.y;	/* " BC" is ignored as sscanf() does */
+			}
 			break;
 
 		case PG_TYPE_TIME:
@@ -1690,7 +2016,7 @@ MYLOG(DETAIL_LOG_LEVEL, "2stime fr=%d\n", std_time.fr);
 		}
 		if (pre_convert)
 			neut_str = midtemp;
-		result = convert_text_field_to_sql_c(gdata, stmt->current_col, neut_str, field_type, fCType, rgbValueBindRow, cbValueMax, conn, &len);
+		result = convert_text_field_to_sql_c(gdata, current_col, neut_str, field_type, fCType, rgbValueBindRow, cbValueMax, conn, &len);
 	}
 	else
 	{
@@ -1828,21 +2154,19 @@ MYLOG(DETAIL_LOG_LEVEL, "2stime fr=%d\n", std_time.fr);
 				break;
 
 			case SQL_C_FLOAT:
-				set_client_decimal_point((char *) neut_str);
 				len = 4;
 				if (bind_size > 0)
-					*((SFLOAT *) rgbValueBindRow) = (float) get_double_value(neut_str);
+					*((SFLOAT *) rgbValueBindRow) = (float) get_client_double_value(neut_str);
 				else
-					*((SFLOAT *) rgbValue + bind_row) = (float) get_double_value(neut_str);
+					*((SFLOAT *) rgbValue + bind_row) = (float) get_client_double_value(neut_str);
 				break;
 
 			case SQL_C_DOUBLE:
-				set_client_decimal_point((char *) neut_str);
 				len = 8;
 				if (bind_size > 0)
-					*((SDOUBLE *) rgbValueBindRow) = get_double_value(neut_str);
+					*((SDOUBLE *) rgbValueBindRow) = get_client_double_value(neut_str);
 				else
-					*((SDOUBLE *) rgbValue + bind_row) = get_double_value(neut_str);
+					*((SDOUBLE *) rgbValue + bind_row) = get_client_double_value(neut_str);
 				break;
 
 			case SQL_C_NUMERIC:
@@ -1991,10 +2315,596 @@ MYLOG(DETAIL_LOG_LEVEL, "SQL_C_VARBOOKMARK value=%d\n", ival);
 	if (pcbValue)
 		*pcbValueBindRow = len;
 
-	if (result == COPY_OK && stmt->current_col >= 0)
-		gdata->gdata[stmt->current_col].data_left = 0;
+	if (result == COPY_OK && current_col >= 0)
+		gdata->gdata[current_col].data_left = 0;
+	return result;
+
+}
+
+
+/*
+ *	Bulk conversion of the bound columns of a rowset.
+ *
+ *	With column-wise binding PGAPI_ExtendedFetch() calls
+ *	setup_columnar_fetch() before fetching a rowset. It chooses a
+ *	conversion kernel once for each bound column whose conversion is a
+ *	plain one, SC_fetch() skips those columns and
+ *	copy_and_convert_rowset() converts them column by column after all
+ *	the rows of the rowset were fetched. When the rowset is large enough
+ *	to be converted by the worker threads, the other bound columns are
+ *	also converted there by the usual conversion (FETCH_KERNEL_CONVERT).
+ */
+enum {
+	FETCH_KERNEL_NONE = 0
+	,FETCH_KERNEL_INT4	/* int2, int4 -> SQL_C_SLONG */
+	,FETCH_KERNEL_INT8	/* int2, int4, int8 -> SQL_C_SBIGINT */
+	,FETCH_KERNEL_FLOAT8	/* float4, float8 -> SQL_C_DOUBLE */
+	,FETCH_KERNEL_CHAR	/* text values -> SQL_C_CHAR as they are */
+	,FETCH_KERNEL_CONVERT	/* the others by convert_field_to_row() */
+};
+
+#define	CONVERT_MAX_THREADS	64
+#define	CONVERT_SLICE_ROWS	4096
+
+int
+setup_columnar_fetch(StatementClass *stmt, SQLLEN rowsetSize)
+{
+	QResultClass	*res = SC_get_Curres(stmt);
+	ARDFields	*opts = SC_get_ARDF(stmt);
+	ConnectionClass	*conn = SC_get_conn(stmt);
+	const ConnInfo	*ci = &(conn->connInfo);
+	BOOL	binary, plain_text, plain_decimal, parallel;
+	int	num_cols, lf, count = 0;
+
+	if (rowsetSize < 2 || NULL == res || NULL == opts->bindings ||
+	    opts->bind_size > 0 || NULL != res->keyset ||
+	    (SC_is_fetchcursor(stmt) && NULL != QR_get_cursor(res)) ||
+	    SQL_RD_OFF == stmt->options.retrieve_data ||
+	    NULL != conn->DataSourceToDriver)
+		return 0;
+
+	binary = QR_is_binary_format(res);
+	/* character values need neither linefeed nor encoding conversion ? */
+	plain_text = !ci->lf_conversion;
+#ifdef	UNICODE_SUPPORT
+	if (get_convtype() > 0 &&
+	    (conn->ccsc != pg_CS_code(conn->locale_encoding) || ci->wcs_debug))
+		plain_text = FALSE;
+#endif /* UNICODE_SUPPORT */
+	/* numeric values need no decimal point conversion ? */
+	plain_decimal = ('.' == get_current_decimal_point());
+	/* may the rowset be split among the worker threads ? */
+	parallel = (ci->convert_threads > 0 && rowsetSize >= 2 * CONVERT_SLICE_ROWS);
+
+	num_cols = QR_NumPublicResultCols(res);
+	if (num_cols > opts->allocated)
+		num_cols = opts->allocated;
+	for (lf = 0; lf < num_cols; lf++)
+	{
+		BindInfoClass	*bic = &opts->bindings[lf];
+		OID	field_type = QR_get_field_type(res, lf);
+		char	kernel = FETCH_KERNEL_NONE;
+
+		/* NULLs without an indicator are errors which SC_fetch() reports */
+		if (NULL == bic->buffer || NULL == bic->indicator)
+			;
+		else switch (bic->returntype)
+		{
+			case SQL_C_SLONG:
+			case SQL_C_LONG:
+				if (PG_TYPE_INT2 == field_type ||
+				    PG_TYPE_INT4 == field_type)
+					kernel = FETCH_KERNEL_INT4;
+				break;
+#ifdef	ODBCINT64
+			case SQL_C_SBIGINT:
+				if (PG_TYPE_INT2 == field_type ||
+				    PG_TYPE_INT4 == field_type ||
+				    PG_TYPE_INT8 == field_type)
+					kernel = FETCH_KERNEL_INT8;
+				break;
+#endif /* ODBCINT64 */
+			case SQL_C_DOUBLE:
+				if ((PG_TYPE_FLOAT4 == field_type ||
+				     PG_TYPE_FLOAT8 == field_type) &&
+				    (binary || plain_decimal))
+					kernel = FETCH_KERNEL_FLOAT8;
+				break;
+			case SQL_C_CHAR:
+				if (binary || bic->buflen <= 0)
+					break;
+				switch (field_type)
+				{
+					case PG_TYPE_BPCHAR:
+					case PG_TYPE_VARCHAR:
+					case PG_TYPE_TEXT:
+						if (plain_text)
+							kernel = FETCH_KERNEL_CHAR;
+						break;
+					case PG_TYPE_INT2:
+					case PG_TYPE_INT4:
+					case PG_TYPE_INT8:
+						kernel = FETCH_KERNEL_CHAR;
+						break;
+					case PG_TYPE_FLOAT4:
+					case PG_TYPE_FLOAT8:
+					case PG_TYPE_NUMERIC:
+						if (plain_decimal)
+							kernel = FETCH_KERNEL_CHAR;
+						break;
+				}
+				break;
+		}
+		/* large objects are read from the server */
+		if (FETCH_KERNEL_NONE == kernel && parallel &&
+		    NULL != bic->buffer && NULL != bic->indicator &&
+		    PG_TYPE_LO_UNDEFINED != field_type &&
+		    PG_TYPE_OID != field_type &&
+		    conn->lobj_type != field_type)
+			kernel = FETCH_KERNEL_CONVERT;
+		if (FETCH_KERNEL_NONE != (bic->fetch_kernel = kernel))
+			count++;
+	}
+	MYLOG(0, "%d of %d columns are converted per rowset\n", count, num_cols);
+
+	return count;
+}
+
+void
+reset_columnar_fetch(StatementClass *stmt)
+{
+	ARDFields	*opts = SC_get_ARDF(stmt);
+	int	lf;
+
+	for (lf = 0; lf < opts->allocated; lf++)
+		opts->bindings[lf].fetch_kernel = FETCH_KERNEL_NONE;
+}
+
+#define	SET_ROWSET_LENGTH(used, indicator, row, len) \
+do { \
+	(indicator)[row] = 0; \
+	if (used) \
+		(used)[row] = (len); \
+} while (0)
+
+/*
+ *	Merge the result of a conversion into those of the others.
+ *	The first error wins over truncations.
+ */
+static int
+merge_copy_result(int result, int newres)
+{
+	switch (newres)
+	{
+		case COPY_OK:
+		case COPY_NO_DATA_FOUND:
+			return result;
+		case COPY_RESULT_TRUNCATED:
+			return COPY_OK == result ? newres : result;
+	}
+	return (COPY_OK == result || COPY_RESULT_TRUNCATED == result) ? newres : result;
+}
+
+/*
+ *	Convert the columns chosen by setup_columnar_fetch() for the rows
+ *	from .. to - 1 of the current rowset.
+ *	This only reads the tuple cache and the statement and writes the
+ *	bound arrays and the row status array, so the disjoint row ranges of
+ *	a rowset can be converted in parallel. The rows with a truncated
+ *	value get SQL_ROW_SUCCESS_WITH_INFO and those which failed to be
+ *	converted SQL_ROW_ERROR.
+ */
+typedef struct
+{
+	StatementClass	*stmt;
+	const QResultClass	*res;
+	const ARDFields	*opts;
+	SQLULEN		offset;
+	SQLLEN		cache_idx;
+	SQLUSMALLINT	*row_status;
+} RowsetConv;
+
+#define	SET_ROWSET_STATUS(conv, row, copyres) \
+do { \
+	if (NULL == (conv)->row_status) \
+		; \
+	else if (COPY_RESULT_TRUNCATED == (copyres)) \
+	{ \
+		if (SQL_ROW_SUCCESS == (conv)->row_status[row]) \
+			(conv)->row_status[row] = SQL_ROW_SUCCESS_WITH_INFO; \
+	} \
+	else if (COPY_OK != (copyres) && COPY_NO_DATA_FOUND != (copyres)) \
+		(conv)->row_status[row] = SQL_ROW_ERROR; \
+} while (0)
+
+static int
+convert_rowset_rows(const RowsetConv *conv, SQLLEN from, SQLLEN to)
+{
+	const QResultClass	*res = conv->res;
+	const ARDFields	*opts = conv->opts;
+	BOOL		binary = QR_is_binary_format(res);
+	int		lf, num_fields = res->num_fields, width, result = COPY_OK, rowres;
+	SQLLEN		row;
+
+	for (lf = 0; lf < opts->allocated; lf++)
+	{
+		const BindInfoClass	*bic = &opts->bindings[lf];
+		char		*buffer;
+		SQLLEN		*used, *indicator;
+		const TupleField	*tuple;
+		OID		field_type;
+		const char	*value;
+
+		if (FETCH_KERNEL_NONE == bic->fetch_kernel)
+			continue;
+		buffer = bic->buffer + conv->offset;
+		used = LENADDR_SHIFT(bic->used, conv->offset);
+		indicator = LENADDR_SHIFT(bic->indicator, conv->offset);
+		tuple = res->backend_tuples + (conv->cache_idx + from) * num_fields + lf;
+		field_type = QR_get_field_type(res, lf);
+		width = (PG_TYPE_INT2 == field_type ? 2 : (PG_TYPE_INT4 == field_type ? 4 : 8));
+		switch (bic->fetch_kernel)
+		{
+			case FETCH_KERNEL_INT4:
+				for (row = from; row < to; row++, tuple += num_fields)
+				{
+					if (value = tuple->value, NULL == value)
+					{
+						indicator[row] = SQL_NULL_DATA;
+						continue;
+					}
+					((SQLINTEGER *) buffer)[row] = (SQLINTEGER) (binary ? get_binary_integer(value, width) : atol(value));
+					SET_ROWSET_LENGTH(used, indicator, row, sizeof(SQLINTEGER));
+				}
+				break;
+#ifdef	ODBCINT64
+			case FETCH_KERNEL_INT8:
+				for (row = from; row < to; row++, tuple += num_fields)
+				{
+					if (value = tuple->value, NULL == value)
+					{
+						indicator[row] = SQL_NULL_DATA;
+						continue;
+					}
+					((SQLBIGINT *) buffer)[row] = binary ? get_binary_integer(value, width) : ATOI64(value);
+					SET_ROWSET_LENGTH(used, indicator, row, sizeof(SQLBIGINT));
+				}
+				break;
+#endif /* ODBCINT64 */
+			case FETCH_KERNEL_FLOAT8:
+				for (row = from; row < to; row++, tuple += num_fields)
+				{
+					double	dval;
+
+					if (value = tuple->value, NULL == value)
+					{
+						indicator[row] = SQL_NULL_DATA;
+						continue;
+					}
+					if (binary)
+						dval = get_binary_double(value, field_type);
+					else if (!parse_canonical_double(value, &dval))
+						dval = get_double_value(value);
+					((SDOUBLE *) buffer)[row] = dval;
+					SET_ROWSET_LENGTH(used, indicator, row, sizeof(SDOUBLE));
+				}
+				break;
+			case FETCH_KERNEL_CHAR:
+				buffer += from * bic->buflen;
+				for (row = from; row < to; row++, tuple += num_fields, buffer += bic->buflen)
+				{
+					size_t	len;
+
+					if (value = tuple->value, NULL == value)
+					{
+						indicator[row] = SQL_NULL_DATA;
+						continue;
+					}
+					len = strlen(value);
+					if ((SQLLEN) len < bic->buflen)
+						memcpy(buffer, value, len + 1);
+					else
+					{
+						memcpy(buffer, value, bic->buflen - 1);
+						buffer[bic->buflen - 1] = '\0';
+						result = merge_copy_result(result, COPY_RESULT_TRUNCATED);
+						SET_ROWSET_STATUS(conv, row, COPY_RESULT_TRUNCATED);
+					}
+					SET_ROWSET_LENGTH(used, indicator, row, len);
+				}
+				break;
+			case FETCH_KERNEL_CONVERT:
+				for (row = from; row < to; row++, tuple += num_fields)
+				{
+					rowres = convert_field_to_row(conv->stmt, (SQLSETPOSIROW) row, -1,
+							field_type, QR_get_atttypmod(res, lf), tuple->value,
+							bic->returntype, bic->precision,
+							bic->buffer + conv->offset, bic->buflen,
+							used, indicator);
+					result = merge_copy_result(result, rowres);
+					SET_ROWSET_STATUS(conv, row, rowres);
+				}
+				break;
+		}
+	}
+
+	return result;
+}
+
+/*
+ *	The worker threads which convert large rowsets (ConvertThreads).
+ *
+ *	The threads are started on demand, shared by all the connections
+ *	and stopped when the driver is unloaded. A rowset is split into
+ *	slices of at least CONVERT_SLICE_ROWS rows, the workers and the
+ *	calling thread take the slices one by one and the calling thread
+ *	merges their results. Only one rowset is converted by the workers
+ *	at a time, the others are converted by their calling threads.
+ */
+
+#if defined(WIN_MULTITHREAD_SUPPORT)
+static CRITICAL_SECTION	convert_cs;
+static CONDITION_VARIABLE	convert_work_cv, convert_done_cv;
+static HANDLE	convert_threads[CONVERT_MAX_THREADS];
+#define	INIT_CONVERT_CS \
+do { \
+	InitializeCriticalSection(&convert_cs); \
+	InitializeConditionVariable(&convert_work_cv); \
+	InitializeConditionVariable(&convert_done_cv); \
+} while (0)
+#define	DELETE_CONVERT_CS	DeleteCriticalSection(&convert_cs)
+#define	ENTER_CONVERT_CS	EnterCriticalSection(&convert_cs)
+#define	LEAVE_CONVERT_CS	LeaveCriticalSection(&convert_cs)
+#define	WAIT_CONVERT_WORK	SleepConditionVariableCS(&convert_work_cv, &convert_cs, INFINITE)
+#define	WAIT_CONVERT_DONE	SleepConditionVariableCS(&convert_done_cv, &convert_cs, INFINITE)
+#define	WAKEUP_CONVERT_WORKERS	WakeAllConditionVariable(&convert_work_cv)
+#define	WAKEUP_CONVERT_CALLER	WakeConditionVariable(&convert_done_cv)
+#define	USE_CONVERT_WORKERS
+#elif defined(POSIX_MULTITHREAD_SUPPORT)
+static pthread_mutex_t	convert_cs;
+static pthread_cond_t	convert_work_cv, convert_done_cv;
+static pthread_t	convert_threads[CONVERT_MAX_THREADS];
+#define	INIT_CONVERT_CS \
+do { \
+	pthread_mutex_init(&convert_cs, NULL); \
+	pthread_cond_init(&convert_work_cv, NULL); \
+	pthread_cond_init(&convert_done_cv, NULL); \
+} while (0)
+#define	DELETE_CONVERT_CS \
+do { \
+	pthread_cond_destroy(&convert_done_cv); \
+	pthread_cond_destroy(&convert_work_cv); \
+	pthread_mutex_destroy(&convert_cs); \
+} while (0)
+#define	ENTER_CONVERT_CS	pthread_mutex_lock(&convert_cs)
+#define	LEAVE_CONVERT_CS	pthread_mutex_unlock(&convert_cs)
+#define	WAIT_CONVERT_WORK	pthread_cond_wait(&convert_work_cv, &convert_cs)
+#define	WAIT_CONVERT_DONE	pthread_cond_wait(&convert_done_cv, &convert_cs)
+#define	WAKEUP_CONVERT_WORKERS	pthread_cond_broadcast(&convert_work_cv)
+#define	WAKEUP_CONVERT_CALLER	pthread_cond_signal(&convert_done_cv)
+#define	USE_CONVERT_WORKERS
+#endif /* WIN_MULTITHREAD_SUPPORT */
+
+#ifdef	USE_CONVERT_WORKERS
+typedef struct
+{
+	const RowsetConv	*conv;
+	SQLLEN		nrows;
+	int		nslices;
+	int		next_slice;	/* the next slice to take */
+	int		done_slices;
+	int		result;
+} ConvertJob;
+
+static int	convert_nthreads = 0;
+static BOOL	convert_stop = FALSE;
+static ConvertJob	*convert_job = NULL;
+
+/*
+ *	Convert the slices of the current job until none is left.
+ *	Called with convert_cs held.
+ */
+static void
+convert_job_slices(ConvertJob *job)
+{
+	while (job->next_slice < job->nslices)
+	{
+		int	slice = job->next_slice++, result;
+		SQLLEN	from, to;
+
+		LEAVE_CONVERT_CS;
+		from = job->nrows * slice / job->nslices;
+		to = job->nrows * (slice + 1) / job->nslices;
+		result = convert_rowset_rows(job->conv, from, to);
+		ENTER_CONVERT_CS;
+		job->result = merge_copy_result(job->result, result);
+		if (++job->done_slices >= job->nslices)
+			WAKEUP_CONVERT_CALLER;
+	}
+}
+
+#if defined(WIN_MULTITHREAD_SUPPORT)
+static unsigned __stdcall
+convert_worker(void *arg)
+#else
+static void *
+convert_worker(void *arg)
+#endif /* WIN_MULTITHREAD_SUPPORT */
+{
+	ENTER_CONVERT_CS;
+	for (;;)
+	{
+		while (!convert_stop &&
+			   (NULL == convert_job ||
+				convert_job->next_slice >= convert_job->nslices))
+			WAIT_CONVERT_WORK;
+		if (convert_stop)
+			break;
+		convert_job_slices(convert_job);
+	}
+	LEAVE_CONVERT_CS;
+	return 0;
+}
+
+/*
+ *	Start the workers up to nthreads.
+ *	Called with convert_cs held. Returns the number of running workers.
+ */
+static int
+start_convert_workers(int nthreads)
+{
+	if (nthreads > CONVERT_MAX_THREADS)
+		nthreads = CONVERT_MAX_THREADS;
+	for (; convert_nthreads < nthreads; convert_nthreads++)
+	{
+#if defined(WIN_MULTITHREAD_SUPPORT)
+		HANDLE	th = (HANDLE) _beginthreadex(NULL, 0, convert_worker, NULL, 0, NULL);
+
+		if (NULL == th)
+			break;
+		convert_threads[convert_nthreads] = th;
+#else
+		if (0 != pthread_create(&convert_threads[convert_nthreads], NULL, convert_worker, NULL))
+			break;
+#endif /* WIN_MULTITHREAD_SUPPORT */
+	}
+	return convert_nthreads;
+}
+#endif /* USE_CONVERT_WORKERS */
+
+void
+InitializeConvertWorkers(void)
+{
+#ifdef	USE_CONVERT_WORKERS
+	INIT_CONVERT_CS;
+#endif /* USE_CONVERT_WORKERS */
+}
+
+/*
+ *	Stop the worker threads and wait for them to exit.
+ *	Called when the last environment is freed, no statement is converting
+ *	then. The workers are started again by a later conversion.
+ */
+void
+StopConvertWorkers(void)
+{
+#ifdef	USE_CONVERT_WORKERS
+	int	i, nthreads;
+
+	ENTER_CONVERT_CS;
+	nthreads = convert_nthreads;
+	convert_stop = TRUE;
+	WAKEUP_CONVERT_WORKERS;
+	LEAVE_CONVERT_CS;
+	for (i = 0; i < nthreads; i++)
+	{
+#if defined(WIN_MULTITHREAD_SUPPORT)
+		WaitForSingleObject(convert_threads[i], INFINITE);
+		CloseHandle(convert_threads[i]);
+#else
+		pthread_join(convert_threads[i], NULL);
+#endif /* WIN_MULTITHREAD_SUPPORT */
+	}
+	ENTER_CONVERT_CS;
+	convert_nthreads = 0;
+	convert_stop = FALSE;
+	LEAVE_CONVERT_CS;
+#endif /* USE_CONVERT_WORKERS */
+}
+
+/*
+ *	Called when the driver is unloaded. The workers are stopped by
+ *	StopConvertWorkers() unless the application didn't free the
+ *	environment. Then they may still use convert_cs and we can't wait for
+ *	them here (DllMain holds the loader lock), so leave it alone.
+ */
+void
+FinalizeConvertWorkers(void)
+{
+#ifdef	USE_CONVERT_WORKERS
+	if (convert_nthreads > 0)
+	{
+		MYLOG(0, "%d convert workers are still running\n", convert_nthreads);
+		return;
+	}
+	DELETE_CONVERT_CS;
+#endif /* USE_CONVERT_WORKERS */
+}
+
+/*
+ *	Convert the columns chosen by setup_columnar_fetch() for the nrows
+ *	rows of the current rowset and update row_status (if any) of the
+ *	rows with a truncated value or a conversion error.
+ *	Returns the first error, else COPY_RESULT_TRUNCATED if a value was
+ *	truncated, else COPY_OK.
+ */
+int
+copy_and_convert_rowset(StatementClass *stmt, SQLLEN nrows, SQLUSMALLINT *row_status)
+{
+	QResultClass	*res = SC_get_Curres(stmt);
+	ARDFields	*opts = SC_get_ARDF(stmt);
+	ConnectionClass	*conn = SC_get_conn(stmt);
+	Int8		start_usec = METRICS_START(conn);
+	RowsetConv	conv;
+	int		nslices, result = COPY_OK;
+
+	if (NULL == res || nrows <= 0)
+		return COPY_OK;
+	conv.stmt = stmt;
+	conv.res = res;
+	conv.opts = opts;
+	conv.offset = opts->row_offset_ptr ? *opts->row_offset_ptr : 0;
+	conv.row_status = row_status;
+	/* The rows of a rowset without keyset are contiguous in the cache */
+	conv.cache_idx = GIdx2CacheIdx(RowIdx2GIdx(0, stmt), stmt, res);
+
+	nslices = (int) (nrows / CONVERT_SLICE_ROWS);
+	if (nslices > conn->connInfo.convert_threads + 1)
+		nslices = conn->connInfo.convert_threads + 1;
+#ifdef	USE_CONVERT_WORKERS
+	if (nslices >= 2)
+	{
+		ConvertJob	job;
+
+		/* the workers only read the local time of the statement */
+		SC_get_localtime(stmt);
+		ENTER_CONVERT_CS;
+		if (NULL == convert_job && !convert_stop &&
+			start_convert_workers(nslices - 1) > 0)
+		{
+			MYLOG(0, "converting " FORMAT_LEN " rows in %d slices\n", nrows, nslices);
+			job.conv = &conv;
+			job.nrows = nrows;
+			job.nslices = nslices;
+			job.next_slice = job.done_slices = 0;
+			job.result = COPY_OK;
+			convert_job = &job;
+			WAKEUP_CONVERT_WORKERS;
+			convert_job_slices(&job);
+			while (job.done_slices < job.nslices)
+				WAIT_CONVERT_DONE;
+			convert_job = NULL;
+			LEAVE_CONVERT_CS;
+			result = job.result;
+			goto done;
+		}
+		/* the workers are busy */
+		LEAVE_CONVERT_CS;
+	}
+#endif /* USE_CONVERT_WORKERS */
+	result = convert_rowset_rows(&conv, 0, nrows);
+#ifdef	USE_CONVERT_WORKERS
+done:
+#endif /* USE_CONVERT_WORKERS */
+	if (start_usec > 0)
+	{
+		PG_Metrics	metrics = {0};
+
+		metrics.convert_usec = get_clock_usec() - start_usec;
+		CC_add_metrics(conn, stmt, &metrics);
+	}
+
 	return result;
-
 }
 
 
@@ -2012,6 +2922,7 @@ MYLOG(DETAIL_LOG_LEVEL, "SQL_C_VARBOOKMARK value=%d\n", ival);
 #define	FLGP_SELECT_FOR_UPDATE_OR_SHARE	(1L << 3)
 #define	FLGP_MULTIPLE_STATEMENT	(1L << 5)
 #define	FLGP_SELECT_FOR_READONLY	(1L << 6)
+#define	FLGP_NOT_CACHEABLE	(1L << 7)
 typedef struct _QueryParse {
 	const char	*statement;
 	int		statement_type;
@@ -2131,6 +3042,9 @@ typedef struct _QueryBuild {
 
 	ConnectionClass	*conn; /* mainly needed for LO handling */
 	StatementClass	*stmt; /* needed to set error info in ENLARGE_.. */
+	QUERY_TEMPLATE	*tmpl;	/* the template being recorded */
+	size_t	tmpl_from;	/* the end of the last parameter value */
+	size_t	tmpl_alsize;
 }	QueryBuild;
 
 #define INIT_MIN_ALLOC	4096
@@ -2153,6 +3067,9 @@ QB_initialize(QueryBuild *qb, size_t size, StatementClass *stmt, ResolveParamMod
 	qb->num_discard_params = 0;
 	qb->brace_level = 0;
 	qb->parenthesize_the_first = FALSE;
+	qb->tmpl = NULL;
+	qb->tmpl_from = 0;
+	qb->tmpl_alsize = 0;
 
 	/* Copy options from statement */
 	qb->apdopts = SC_get_APDF(stmt);
@@ -2203,6 +3120,8 @@ static int
 QB_initialize_copy(QueryBuild *qb_to, const QueryBuild *qb_from, UInt4 size)
 {
 	memcpy(qb_to, qb_from, sizeof(QueryBuild));
+	/* the parameters in escapes make the query uncacheable */
+	qb_to->tmpl = NULL;
 
 	if ((qb_to->query_statement = malloc(size)) == NULL)
 	{
@@ -2851,6 +3770,23 @@ MYLOG(DETAIL_LOG_LEVEL, "entering\n");
 		SC_set_error(stmt, STMT_EXEC_ERROR, "Error while preparing parameters", func);
 		goto cleanup;
 	}
+	/* Remember if the described result columns can be received in binary */
+	stmt->binary_result = FALSE;
+	if (conn->connInfo.binary_results && NULL == pstmt->next &&
+		QR_NumResultCols(res) > 0)
+	{
+		int	i;
+
+		stmt->binary_result = TRUE;
+		for (i = 0; i < QR_NumResultCols(res); i++)
+		{
+			if (!pgtype_binary_transferable(conn, QR_get_field_type(res, i)))
+			{
+				stmt->binary_result = FALSE;
+				break;
+			}
+		}
+	}
 	num_pa = pstmt->num_params;
 	for (pstmt = pstmt->next; pstmt; pstmt = pstmt->next)
 	{
@@ -2903,6 +3839,111 @@ MYLOG(DETAIL_LOG_LEVEL, "calling prepareParameters\n");
 	return desc_params_and_sync(stmt);
 }
 
+/*
+ *	The query templates (QueryCacheSize).
+ *
+ *	While converting a statement, the text between the parameter
+ *	values is collected into qb->tmpl. Converting the same statement
+ *	again only puts the parameter values into the template text.
+ */
+static BOOL
+QB_append_template_text(QueryBuild *qb, const char *text, size_t len)
+{
+	QUERY_TEMPLATE	*tmpl = qb->tmpl;
+	size_t		newsize;
+	char		*newtext;
+
+	if (tmpl->textlen + len >= qb->tmpl_alsize)
+	{
+		for (newsize = (qb->tmpl_alsize > 0 ? qb->tmpl_alsize : 256); newsize <= tmpl->textlen + len; newsize *= 2)
+			;
+		if (newtext = realloc(tmpl->text, newsize), NULL == newtext)
+			return FALSE;
+		tmpl->text = newtext;
+		qb->tmpl_alsize = newsize;
+	}
+	memcpy(tmpl->text + tmpl->textlen, text, len);
+	tmpl->textlen += len;
+	tmpl->text[tmpl->textlen] = '\0';
+	return TRUE;
+}
+
+static void
+QB_start_template_slot(QueryBuild *qb)
+{
+	QUERY_TEMPLATE	*tmpl = qb->tmpl;
+	QUERY_SLOT	*slots;
+
+	if (qb->npos < qb->tmpl_from ||
+	    !QB_append_template_text(qb, qb->query_statement + qb->tmpl_from, qb->npos - qb->tmpl_from) ||
+	    (slots = realloc(tmpl->slots, (tmpl->nslots + 1) * sizeof(QUERY_SLOT)), NULL == slots))
+	{
+		/* give up recording */
+		free_query_template(tmpl);
+		qb->tmpl = NULL;
+		return;
+	}
+	tmpl->slots = slots;
+	slots[tmpl->nslots].pos = tmpl->textlen;
+	slots[tmpl->nslots].param_number = qb->param_number;
+	tmpl->nslots++;
+}
+
+/*
+ *	Add the recorded template to the cache if every parameter was put
+ *	at a slot.
+ */
+static void
+QB_finish_template(QueryBuild *qb, const QueryParse *qp)
+{
+	QUERY_TEMPLATE	*tmpl = qb->tmpl;
+
+	if (NULL == tmpl)
+		return;
+	if (tmpl->nslots == qb->param_number + 1 &&
+	    0 == (qp->flags & (FLGP_USING_CURSOR | FLGP_NOT_CACHEABLE)) &&
+	    qb->npos >= qb->tmpl_from &&
+	    QB_append_template_text(qb, qb->query_statement + qb->tmpl_from, qb->npos - qb->tmpl_from) &&
+	    NULL != (tmpl->query = strdup(qp->statement)))
+	{
+		tmpl->statement_type = qp->statement_type;
+		tmpl->parse_flags = qp->flags;
+		tmpl->join_info = qb->stmt->join_info;
+		if (CC_add_query_template(qb->conn, tmpl))
+			tmpl = NULL;
+	}
+	if (NULL != tmpl)
+		free_query_template(tmpl);
+	qb->tmpl = NULL;
+}
+
+/*
+ *	Build the statement from the template and the parameter values.
+ */
+static RETCODE
+QB_apply_template(QueryBuild *qb, const QUERY_TEMPLATE *tmpl)
+{
+	RETCODE	retval = SQL_SUCCESS;
+	size_t	pos = 0;
+	BOOL	isnull, isbinary;
+	OID	dummy;
+	int	i;
+
+	for (i = 0; i < tmpl->nslots; i++)
+	{
+		CVT_APPEND_DATA(qb, tmpl->text + pos, tmpl->slots[i].pos - pos);
+		pos = tmpl->slots[i].pos;
+		qb->param_number = tmpl->slots[i].param_number;
+		if (retval = ResolveOneParam(qb, NULL, &isnull, &isbinary, &dummy), retval < 0)
+			goto cleanup;
+	}
+	CVT_APPEND_DATA(qb, tmpl->text + pos, tmpl->textlen - pos);
+	CVT_TERMINATE(qb);
+	retval = SQL_SUCCESS;
+cleanup:
+	return retval;
+}
+
 /*
  *	This function inserts parameters into an SQL statements.
  *	It will also modify a SELECT statement for use with declare/fetch cursors.
@@ -2921,6 +3962,7 @@ copy_statement_with_parameters(StatementClass *stmt, BOOL buildPrepareStatement)
 	ConnectionClass *conn = SC_get_conn(stmt);
 	ConnInfo   *ci = &(conn->connInfo);
 	const		char *bestitem = NULL;
+	const QUERY_TEMPLATE	*cached;
 
 MYLOG(DETAIL_LOG_LEVEL, "entering prepared=%d\n", stmt->prepared);
 	if (!stmt->statement)
@@ -3075,11 +4117,39 @@ MYLOG(DETAIL_LOG_LEVEL, "type=" FORMAT_UINTEGER " concur=" FORMAT_UINTEGER "\n",
 		}
 	}
 
+	/* The statements converted the same way on every execution */
+	if (CC_caches_queries(conn) &&
+	    0 == (qp->flags & FLGP_USING_CURSOR) &&
+	    0 == (qb->flags & FLGB_CREATE_KEYSET) &&
+	    0 == qb->proc_return &&
+	    0 == qb->num_output_params &&
+	    NULL == conn->DriverToDataSource)
+	{
+		if (cached = CC_lookup_query_template(conn, qp->statement, qb->flags), NULL != cached)
+		{
+			MYLOG(DETAIL_LOG_LEVEL, "applying the cached template\n");
+			if (SQL_ERROR == QB_apply_template(qb, cached))
+			{
+				QB_replace_SC_error(stmt, qb, func);
+				QB_Destructor(qb);
+				return SQL_ERROR;
+			}
+			qp->statement_type = cached->statement_type;
+			qp->flags |= cached->parse_flags;
+			stmt->join_info |= cached->join_info;
+			goto converted;
+		}
+		if (qb->tmpl = (QUERY_TEMPLATE *) calloc(1, sizeof(QUERY_TEMPLATE)), NULL != qb->tmpl)
+			qb->tmpl->build_flags = qb->flags;
+	}
+
 	for (qp->opos = 0; qp->opos < qp->stmt_len; qp->opos++)
 	{
 		retval = inner_process_tokens(qp, qb);
 		if (SQL_ERROR == retval)
 		{
+			if (NULL != qb->tmpl)
+				free_query_template(qb->tmpl);
 			QB_replace_SC_error(stmt, qb, func);
 			QB_Destructor(qb);
 			return retval;
@@ -3087,6 +4157,8 @@ MYLOG(DETAIL_LOG_LEVEL, "type=" FORMAT_UINTEGER " concur=" FORMAT_UINTEGER "\n",
 	}
 	/* make sure new_statement is always null-terminated */
 	CVT_TERMINATE(qb);
+	QB_finish_template(qb, qp);
+converted:
 
 	new_statement = qb->query_statement;
 	stmt->statement_type = qp->statement_type;
@@ -3713,6 +4785,8 @@ inner_process_tokens(QueryParse *qp, QueryBuild *qb)
 		BOOL		converted = FALSE;
 		COL_INFO	*coli;
 
+		/* the table of the last insert changes from execution to execution */
+		qp->flags |= FLGP_NOT_CACHEABLE;
 #ifdef	NOT_USED  /* lastval() isn't always appropriate */
 		if (PG_VERSION_GE(conn, 8.1))
 		{
@@ -3995,9 +5069,13 @@ inner_process_tokens(QueryParse *qp, QueryBuild *qb)
 	/*
 	 * It's a '?' parameter alright
 	 */
+	if (NULL != qb->tmpl)
+		QB_start_template_slot(qb);
 	retval = ResolveOneParam(qb, qp, &isnull, &isbinary, &dummy);
 	if (retval < 0)
 		return retval;
+	if (NULL != qb->tmpl)
+		qb->tmpl_from = qb->npos;
 
 	if (SQL_SUCCESS_WITH_INFO == retval) /* means discarding output parameter */
 	{
@@ -4008,6 +5086,7 @@ cleanup:
 }
 
 #define	MIN_ALC_SIZE	128
+#define	BIND_HANDOVER_SIZE	(64 * 1024)
 
 /*
  * Build an array of parameters to pass to libpq's PQexecPrepared
@@ -4123,10 +5202,28 @@ MYLOG(DETAIL_LOG_LEVEL, "num_p=%d\n", num_p);
 			}
 			if (!isnull)
 			{
-				val_copy = malloc(qb.npos + 1);
-				if (!val_copy)
-					goto cleanup;
-				memcpy(val_copy, qb.query_statement, qb.npos);
+				if (qb.npos >= BIND_HANDOVER_SIZE)
+				{
+					/*
+					 * Hand the buffer over instead of copying a large
+					 * value, e.g. a bytea parameter given by SQLPutData.
+					 */
+					val_copy = qb.query_statement;
+					qb.query_statement = NULL;
+					qb.str_alsize = 0;
+					if (enlarge_query_statement(&qb, MIN_ALC_SIZE) <= 0)
+					{
+						free(val_copy);
+						goto cleanup;
+					}
+				}
+				else
+				{
+					val_copy = malloc(qb.npos + 1);
+					if (!val_copy)
+						goto cleanup;
+					memcpy(val_copy, qb.query_statement, qb.npos);
+				}
 				val_copy[qb.npos] = '\0';
 
 				(*paramTypes)[pno] = pgType;
@@ -4161,6 +5258,91 @@ cleanup:
 	return ret;
 }
 
+/*
+ * Append the parameters of the current row (stmt->exec_current_row) to
+ * buf as a line of COPY text format. The values are converted the same
+ * way as the parameters of build_libpq_bind_params(); binary ones are
+ * written in the bytea hex format.
+ */
+BOOL
+build_copy_in_row(StatementClass *stmt, PQExpBuffer buf)
+{
+	CSTR func = "build_copy_in_row";
+	QueryBuild	qb;
+	int			i;
+	size_t		j;
+	BOOL		isnull, isbinary;
+	OID			pgType;
+	BOOL		ret = FALSE;
+
+	if (QB_initialize(&qb, MIN_ALC_SIZE, stmt, RPM_BUILDING_BIND_REQUEST) < 0)
+		return FALSE;
+
+	for (i = 0; i < stmt->num_params; i++)
+	{
+		qb.npos = 0;
+		if (SQL_ERROR == ResolveOneParam(&qb, NULL, &isnull, &isbinary, &pgType))
+		{
+			QB_replace_SC_error(stmt, &qb, func);
+			goto cleanup;
+		}
+		if (i > 0)
+			appendPQExpBufferChar(buf, '\t');
+		if (isnull)
+		{
+			appendPQExpBufferStr(buf, "\\N");
+			continue;
+		}
+		if (isbinary)
+		{
+			static const char hextbl[] = "0123456789abcdef";
+
+			/* bytea in hex format, whose backslash is escaped */
+			appendPQExpBufferStr(buf, "\\\\x");
+			for (j = 0; j < qb.npos; j++)
+			{
+				UCHAR	c = (UCHAR) qb.query_statement[j];
+
+				appendPQExpBufferChar(buf, hextbl[c >> 4]);
+				appendPQExpBufferChar(buf, hextbl[c & 0xf]);
+			}
+			continue;
+		}
+		for (j = 0; j < qb.npos; j++)
+		{
+			char	c = qb.query_statement[j];
+
+			switch (c)
+			{
+				case '\\':
+					appendPQExpBufferStr(buf, "\\\\");
+					break;
+				case '\n':
+					appendPQExpBufferStr(buf, "\\n");
+					break;
+				case '\r':
+					appendPQExpBufferStr(buf, "\\r");
+					break;
+				case '\t':
+					appendPQExpBufferStr(buf, "\\t");
+					break;
+				default:
+					appendPQExpBufferChar(buf, c);
+					break;
+			}
+		}
+	}
+	appendPQExpBufferChar(buf, '\n');
+	ret = !PQExpBufferBroken(buf);
+	if (!ret)
+		SC_set_error(stmt, STMT_NO_MEMORY_ERROR, "Could not allocate the COPY data", func);
+
+cleanup:
+	QB_Destructor(&qb);
+
+	return ret;
+}
+
 
 /*
  * With SQL_MAX_NUMERIC_LEN = 16, the highest representable number is
@@ -4336,6 +5518,19 @@ parse_to_numeric_struct(const char *wv, SQL_NUMERIC_STRUCT *ns, BOOL *overflow)
 
 	/* Convert the decimal digits to binary */
 	memset(ns->val, 0, sizeof(ns->val));
+#ifdef	ODBCINT64
+	/* up to 19 digits fit in 64 bits */
+	if (nlen <= 19)
+	{
+		SQLUBIGINT	uval = 0;
+
+		for (dig = 0; dig < nlen; dig++)
+			uval = uval * 10 + (calv[dig] - '0');
+		for (i = 0; 0 != uval; i++, uval >>= 8)
+			ns->val[i] = (unsigned char) (uval & 0xFF);
+		return;
+	}
+#endif /* ODBCINT64 */
 	for (dig = 0; dig < nlen; dig++)
 	{
 		UInt4 carry;
@@ -6265,26 +7460,285 @@ convert_to_pgbinary(const char *in, char *out, size_t len, QueryBuild *qb)
 
 static const char *hextbl = "0123456789ABCDEF";
 
-#define	def_bin2hex(type) \
+/*
+ * Vectorised hex encoding and decoding of bytea values.
+ *
+ * The blocks of 16 (SSE2) or 32 (AVX2) bytes are converted at once and
+ * the rest is left to the scalar code. AVX2 is used only if the CPU
+ * supports it at runtime.
+ */
+#ifdef	USE_SSE2
+/* the uppercase hex digits of the nibbles (0 - 15) in n */
+static __m128i
+nibble_to_hex_16(__m128i n)
+{
+	__m128i	alpha = _mm_cmpgt_epi8(n, _mm_set1_epi8(9));
+
+	return _mm_add_epi8(_mm_add_epi8(n, _mm_set1_epi8('0')),
+			    _mm_and_si128(alpha, _mm_set1_epi8('A' - '9' - 1)));
+}
+
+/* the 32 hex digits of the 16 bytes at src, in two halves */
+static void
+bin2hex_16(const char *src, __m128i *first, __m128i *second)
+{
+	__m128i	v = _mm_loadu_si128((const __m128i *) src);
+	__m128i	mask = _mm_set1_epi8(0x0f);
+	__m128i	hi = nibble_to_hex_16(_mm_and_si128(_mm_srli_epi16(v, 4), mask));
+	__m128i	lo = nibble_to_hex_16(_mm_and_si128(v, mask));
+
+	*first = _mm_unpacklo_epi8(hi, lo);
+	*second = _mm_unpackhi_epi8(hi, lo);
+}
+
+/*
+ * The 16 bytes of the 32 hex digits at src, FALSE unless all of them
+ * are hex digits.
+ */
+static BOOL
+hex2bin_16(const char *src, __m128i *bytes)
+{
+	__m128i	c0 = _mm_loadu_si128((const __m128i *) src);
+	__m128i	c1 = _mm_loadu_si128((const __m128i *) (src + 16));
+	__m128i	nib[2];
+	int	i;
+
+	for (i = 0; i < 2; i++)
+	{
+		__m128i	c = (0 == i ? c0 : c1);
+		__m128i	lc = _mm_or_si128(c, _mm_set1_epi8(0x20));
+		__m128i	digit = _mm_and_si128(_mm_cmpgt_epi8(c, _mm_set1_epi8('0' - 1)),
+					      _mm_cmplt_epi8(c, _mm_set1_epi8('9' + 1)));
+		__m128i	alpha = _mm_and_si128(_mm_cmpgt_epi8(lc, _mm_set1_epi8('a' - 1)),
+					      _mm_cmplt_epi8(lc, _mm_set1_epi8('f' + 1)));
+
+		if (0xffff != _mm_movemask_epi8(_mm_or_si128(digit, alpha)))
+			return FALSE;
+		nib[i] = _mm_or_si128(_mm_and_si128(digit, _mm_sub_epi8(c, _mm_set1_epi8('0'))),
+				      _mm_and_si128(alpha, _mm_sub_epi8(lc, _mm_set1_epi8('a' - 10))));
+		/* the high nibble comes first, (even << 4) | odd in 16-bit lanes */
+		nib[i] = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(nib[i], _mm_set1_epi16(0x00ff)), 4),
+				      _mm_srli_epi16(nib[i], 8));
+	}
+	*bytes = _mm_packus_epi16(nib[0], nib[1]);
+	return TRUE;
+}
+
+#ifdef	USE_AVX2
+AVX2_TARGET
+static __m256i
+nibble_to_hex_32(__m256i n)
+{
+	__m256i	alpha = _mm256_cmpgt_epi8(n, _mm256_set1_epi8(9));
+
+	return _mm256_add_epi8(_mm256_add_epi8(n, _mm256_set1_epi8('0')),
+			       _mm256_and_si256(alpha, _mm256_set1_epi8('A' - '9' - 1)));
+}
+
+AVX2_TARGET
+static void
+bin2hex_32(const char *src, char *dst)
+{
+	__m256i	v = _mm256_loadu_si256((const __m256i *) src);
+	__m256i	mask = _mm256_set1_epi8(0x0f);
+	__m256i	hi = nibble_to_hex_32(_mm256_and_si256(_mm256_srli_epi16(v, 4), mask));
+	__m256i	lo = nibble_to_hex_32(_mm256_and_si256(v, mask));
+	__m256i	first = _mm256_unpacklo_epi8(hi, lo);
+	__m256i	second = _mm256_unpackhi_epi8(hi, lo);
+
+	/* unpack works per 128-bit lane */
+	_mm256_storeu_si256((__m256i *) dst, _mm256_permute2x128_si256(first, second, 0x20));
+	_mm256_storeu_si256((__m256i *) (dst + 32), _mm256_permute2x128_si256(first, second, 0x31));
+}
+
+AVX2_TARGET
+static SQLLEN
+bin2hex_avx2(const char *src, char *dst, SQLLEN length, BOOL backwards)
+{
+	SQLLEN	i;
+
+	if (backwards)
+	{
+		for (i = length; i >= 32; i -= 32)
+			bin2hex_32(src + i - 32, dst + 2 * (i - 32));
+		return length - i;
+	}
+	for (i = 0; i + 32 <= length; i += 32)
+		bin2hex_32(src + i, dst + 2 * i);
+	return i;
+}
+
+AVX2_TARGET
+static SQLLEN
+hex2bin_avx2(const char *src, char *dst, SQLLEN length)
+{
+	SQLLEN	i;
+	int	j;
+
+	for (i = 0; i + 64 <= length; i += 64)
+	{
+		__m256i	nib[2];
+
+		for (j = 0; j < 2; j++)
+		{
+			__m256i	c = _mm256_loadu_si256((const __m256i *) (src + i + 32 * j));
+			__m256i	lc = _mm256_or_si256(c, _mm256_set1_epi8(0x20));
+			__m256i	digit = _mm256_and_si256(_mm256_cmpgt_epi8(c, _mm256_set1_epi8('0' - 1)),
+							 _mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), c));
+			__m256i	alpha = _mm256_and_si256(_mm256_cmpgt_epi8(lc, _mm256_set1_epi8('a' - 1)),
+							 _mm256_cmpgt_epi8(_mm256_set1_epi8('f' + 1), lc));
+
+			if (-1 != _mm256_movemask_epi8(_mm256_or_si256(digit, alpha)))
+				return i;
+			nib[j] = _mm256_or_si256(_mm256_and_si256(digit, _mm256_sub_epi8(c, _mm256_set1_epi8('0'))),
+						 _mm256_and_si256(alpha, _mm256_sub_epi8(lc, _mm256_set1_epi8('a' - 10))));
+			nib[j] = _mm256_or_si256(_mm256_slli_epi16(_mm256_and_si256(nib[j], _mm256_set1_epi16(0x00ff)), 4),
+						 _mm256_srli_epi16(nib[j], 8));
+		}
+		/* packus works per 128-bit lane */
+		_mm256_storeu_si256((__m256i *) (dst + i / 2),
+				    _mm256_permute4x64_epi64(_mm256_packus_epi16(nib[0], nib[1]), 0xd8));
+	}
+	return i;
+}
+#endif /* USE_AVX2 */
+
+/*
+ * Convert the leading (or trailing if backwards) blocks of bytes to hex
+ * digits and return the number of bytes converted. The blocks are read
+ * before written, so dst may overlap src from behind if backwards.
+ */
+static SQLLEN
+bin2hex_simd(const char *src, char *dst, SQLLEN length, BOOL backwards)
+{
+	SQLLEN	i = 0;
+	__m128i	first, second;
+
+#ifdef	USE_AVX2
+	if (length >= 32 && get_simd_level() >= 2)
+		i = bin2hex_avx2(src, dst, length, backwards);
+#endif /* USE_AVX2 */
+	if (backwards)
+	{
+		SQLLEN	rest;
+
+		for (rest = length - i; rest >= 16; rest -= 16)
+		{
+			bin2hex_16(src + rest - 16, &first, &second);
+			_mm_storeu_si128((__m128i *) (dst + 2 * (rest - 16)), first);
+			_mm_storeu_si128((__m128i *) (dst + 2 * (rest - 16) + 16), second);
+		}
+		return length - rest;
+	}
+	for (; i + 16 <= length; i += 16)
+	{
+		bin2hex_16(src + i, &first, &second);
+		_mm_storeu_si128((__m128i *) (dst + 2 * i), first);
+		_mm_storeu_si128((__m128i *) (dst + 2 * i + 16), second);
+	}
+	return i;
+}
+
+#ifdef	UNICODE_SUPPORT
+/* bin2hex_simd() to UTF-16 hex digits */
+static SQLLEN
+bin2whex_simd(const char *src, SQLWCHAR *dst, SQLLEN length, BOOL backwards)
+{
+	SQLLEN	i, pos;
+	__m128i	half[2];
+	const __m128i	zero = _mm_setzero_si128();
+	int	j;
+
+	if (sizeof(SQLWCHAR) != 2)
+		return 0;
+	for (i = 0; i + 16 <= length; i += 16)
+	{
+		pos = backwards ? length - i - 16 : i;
+		bin2hex_16(src + pos, &half[0], &half[1]);
+		for (j = 0; j < 2; j++)
+		{
+			_mm_storeu_si128((__m128i *) (dst + 2 * pos + 16 * j), _mm_unpacklo_epi8(half[j], zero));
+			_mm_storeu_si128((__m128i *) (dst + 2 * pos + 16 * j + 8), _mm_unpackhi_epi8(half[j], zero));
+		}
+	}
+	return i;
+}
+#endif /* UNICODE_SUPPORT */
+
+/*
+ * Convert the leading blocks of hex digits to bytes and return the number
+ * of hex digits converted. A block having anything else is left to the
+ * scalar code.
+ */
+static SQLLEN
+hex2bin_simd(const char *src, char *dst, SQLLEN length)
+{
+	SQLLEN	i = 0;
+	__m128i	bytes;
+
+#ifdef	USE_AVX2
+	if (length >= 64 && get_simd_level() >= 2)
+		i = hex2bin_avx2(src, dst, length);
+#endif /* USE_AVX2 */
+	for (; i + 32 <= length && hex2bin_16(src + i, &bytes); i += 32)
+		_mm_storeu_si128((__m128i *) (dst + i / 2), bytes);
+	return i;
+}
+
+/*
+ * Copy the leading blocks of hex digits with a - f in uppercase and
+ * return the number of digits copied.
+ */
+static SQLLEN
+hex2uhex_simd(const char *src, char *dst, SQLLEN length)
+{
+	SQLLEN	i;
+
+	for (i = 0; i + 16 <= length; i += 16)
+	{
+		__m128i	c = _mm_loadu_si128((const __m128i *) (src + i));
+		__m128i	lower = _mm_and_si128(_mm_cmpgt_epi8(c, _mm_set1_epi8('a' - 1)),
+					      _mm_cmplt_epi8(c, _mm_set1_epi8('f' + 1)));
+
+		/* stop at the terminator */
+		if (0 != _mm_movemask_epi8(_mm_cmpeq_epi8(c, _mm_setzero_si128())))
+			break;
+		_mm_storeu_si128((__m128i *) (dst + i), _mm_sub_epi8(c, _mm_and_si128(lower, _mm_set1_epi8(0x20))));
+	}
+	return i;
+}
+#else
+#define	bin2hex_simd(src, dst, length, backwards)	0
+#define	bin2whex_simd(src, dst, length, backwards)	0
+#define	hex2bin_simd(src, dst, length)	0
+#define	hex2uhex_simd(src, dst, length)	0
+#endif /* USE_SSE2 */
+
+#define	def_bin2hex(type, simd_func) \
 	(const char *src, type *dst, SQLLEN length) \
 { \
 	const char	*src_wk; \
 	UCHAR		chr; \
 	type		*dst_wk; \
-	BOOL		backwards; \
-	int		i; \
+	BOOL		backwards, vectorize; \
+	SQLLEN		i, done; \
  \
 	backwards = FALSE; \
+	vectorize = TRUE; \
 	if ((char *) dst < src) \
 	{ \
 		if ((char *) (dst + 2 * (length - 1)) > src + length - 1) \
 			return -1; \
+		/* the blocks ahead would be overwritten before read */ \
+		if ((char *) (dst + 2 * length) > src) \
+			vectorize = FALSE; \
 	} \
 	else if ((char *) dst < src + length) \
 		backwards = TRUE; \
+	done = vectorize ? simd_func(src, dst, length, backwards) : 0; \
 	if (backwards) \
 	{ \
-		for (i = 0, src_wk = src + length - 1, dst_wk = dst + 2 * length - 1; i < length; i++, src_wk--) \
+		for (i = done, src_wk = src + length - 1 - done, dst_wk = dst + 2 * (length - done) - 1; i < length; i++, src_wk--) \
 		{ \
 			chr = *src_wk; \
 			*dst_wk-- = hextbl[chr % 16]; \
@@ -6293,7 +7747,7 @@ static const char *hextbl = "0123456789ABCDEF";
 	} \
 	else \
 	{ \
-		for (i = 0, src_wk = src, dst_wk = dst; i < length; i++, src_wk++) \
+		for (i = done, src_wk = src + done, dst_wk = dst + 2 * done; i < length; i++, src_wk++) \
 		{ \
 			chr = *src_wk; \
 			*dst_wk++ = hextbl[chr >> 4]; \
@@ -6305,11 +7759,11 @@ static const char *hextbl = "0123456789ABCDEF";
 }
 #ifdef	UNICODE_SUPPORT
 static SQLLEN
-pg_bin2whex def_bin2hex(SQLWCHAR)
+pg_bin2whex def_bin2hex(SQLWCHAR, bin2whex_simd)
 #endif /* UNICODE_SUPPORT */
 
 static SQLLEN
-pg_bin2hex def_bin2hex(char)
+pg_bin2hex def_bin2hex(char, bin2hex_simd)
 
 SQLLEN
 pg_hex2bin(const char *src, char *dst, SQLLEN length)
@@ -6321,7 +7775,8 @@ pg_hex2bin(const char *src, char *dst, SQLLEN length)
 	int		val;
 	BOOL		HByte = TRUE;
 
-	for (i = 0, src_wk = src, dst_wk = dst; i < length; i++, src_wk++)
+	i = hex2bin_simd(src, dst, length);
+	for (src_wk = src + i, dst_wk = dst + i / 2; i < length; i++, src_wk++)
 	{
 		chr = *src_wk;
 		if (!chr)
@@ -6345,6 +7800,28 @@ pg_hex2bin(const char *src, char *dst, SQLLEN length)
 	return length;
 }
 
+/*
+ * Convert the hex digits of a bytea value of the hex format to the
+ * uppercase hex digits returned to the application at one pass, instead
+ * of decoding and encoding again.
+ */
+static SQLLEN
+pg_hex2uhex(const char *src, char *dst, SQLLEN length)
+{
+	UCHAR		chr;
+	SQLLEN		i;
+
+	for (i = hex2uhex_simd(src, dst, length); i < length; i++)
+	{
+		chr = src[i];
+		if (!chr)
+			break;
+		dst[i] = (chr >= 'a' && chr <= 'f') ? chr - 'a' + 'A' : chr;
+	}
+	dst[i] = '\0';
+	return i;
+}
+
 /*-------
  *	1. get oid (from 'value')
  *	2. open the large object
@@ -6370,6 +7847,7 @@ convert_lo(StatementClass *stmt, const void *value, SQLSMALLINT fCType, PTR rgbV
 	int			result;
 	Int8			retval;
 	Int8		left64 = -1;
+	Int4		readlen, nread, ncopy;
 	struct GetBlobDataClass *gdata_blob = NULL;
 	ConnectionClass *conn = SC_get_conn(stmt);
 	ConnInfo   *ci = &(conn->connInfo);
@@ -6419,23 +7897,18 @@ convert_lo(StatementClass *stmt, const void *value, SQLSMALLINT fCType, PTR rgbV
 			}
 		}
 
-		stmt->lobj_fd = odbc_lo_open(conn, oid, INV_READ);
+		/* open it and get the size in one round trip */
+		stmt->lobj_fd = odbc_lo_open_size(conn, oid, INV_READ, &left64);
 		if (stmt->lobj_fd < 0)
 		{
 			SC_set_error(stmt, STMT_EXEC_ERROR, "Couldnt open large object for reading.", func);
 			return COPY_GENERAL_ERROR;
 		}
-
-		/* Get the size */
-		retval = odbc_lo_lseek64(conn, stmt->lobj_fd, 0L, SEEK_END);
-		if (retval >= 0)
+		if (gdata_blob)
 		{
-			left64 = odbc_lo_tell64(conn, stmt->lobj_fd);
-			if (gdata_blob)
-				gdata_blob->data_left64 = left64;
-
-			/* return to beginning */
-			odbc_lo_lseek64(conn, stmt->lobj_fd, 0L, SEEK_SET);
+			gdata_blob->data_left64 = left64;
+			gdata_blob->read_offset = 0;
+			gdata_blob->bufused = gdata_blob->bufpos = 0;
 		}
 	}
 	else if (left64 == 0)
@@ -6448,10 +7921,73 @@ convert_lo(StatementClass *stmt, const void *value, SQLSMALLINT fCType, PTR rgbV
 		return COPY_GENERAL_ERROR;
 	}
 
+	/*
+	 * The data are read at absolute offsets.  With SQLGetData, small
+	 * reads are served from chunks of LOReadAheadSize bytes read ahead
+	 * into gdata_blob->buf.
+	 */
 	if (0 >= cbValueMax)
+		readlen = 0;
+	else
+		readlen = (Int4) (factor > 1 ? (cbValueMax - 1) / factor : cbValueMax);
+	if (left64 >= 0 && readlen > left64)
+		readlen = (Int4) left64;
+	if (0 == readlen)
 		retval = 0;
+	else if (!gdata_blob)
+		retval = (Int8) odbc_lo_pread(conn, stmt->lobj_fd, 0, (char *) rgbValue, readlen);
 	else
-		retval = (Int8) odbc_lo_read(conn, stmt->lobj_fd, (char *) rgbValue, (Int4) (factor > 1 ? (cbValueMax - 1) / factor : cbValueMax));
+	{
+		for (retval = 0; retval < readlen;)
+		{
+			if (gdata_blob->bufpos < gdata_blob->bufused)
+			{
+				ncopy = gdata_blob->bufused - gdata_blob->bufpos;
+				if (ncopy > readlen - retval)
+					ncopy = (Int4) (readlen - retval);
+				memcpy((char *) rgbValue + retval, gdata_blob->buf + gdata_blob->bufpos, ncopy);
+				gdata_blob->bufpos += ncopy;
+				retval += ncopy;
+				continue;
+			}
+			if (readlen - retval >= ci->lo_read_ahead_size)
+			{
+				/* large enough to read into the application buffer */
+				nread = odbc_lo_pread(conn, stmt->lobj_fd, gdata_blob->read_offset, (char *) rgbValue + retval, (Int4) (readlen - retval));
+				if (nread < 0)
+				{
+					retval = -1;
+					break;
+				}
+				gdata_blob->read_offset += nread;
+				retval += nread;
+				break;
+			}
+			if (gdata_blob->buflen < ci->lo_read_ahead_size)
+			{
+				char	*newbuf = realloc(gdata_blob->buf, ci->lo_read_ahead_size);
+
+				if (!newbuf)
+				{
+					SC_set_error(stmt, STMT_NO_MEMORY_ERROR, "Could not allocate the large object read-ahead buffer.", func);
+					return COPY_GENERAL_ERROR;
+				}
+				gdata_blob->buf = newbuf;
+				gdata_blob->buflen = ci->lo_read_ahead_size;
+			}
+			nread = odbc_lo_pread(conn, stmt->lobj_fd, gdata_blob->read_offset, gdata_blob->buf, ci->lo_read_ahead_size);
+			if (nread <= 0)
+			{
+				if (nread < 0)
+					retval = -1;
+				break;
+			}
+			MYLOG(DETAIL_LOG_LEVEL, "read ahead %d bytes at " FORMATI64 "\n", nread, gdata_blob->read_offset);
+			gdata_blob->read_offset += nread;
+			gdata_blob->bufused = nread;
+			gdata_blob->bufpos = 0;
+		}
+	}
 	if (retval < 0)
 	{
 		odbc_lo_close(conn, stmt->lobj_fd);
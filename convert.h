@@ -10,6 +10,7 @@
 #define __CONVERT_H__
 
 #include "psqlodbc.h"
+#include "pqexpbuffer.h"
 
 #ifdef	__cplusplus
 extern "C" {
@@ -29,6 +30,12 @@ int	copy_and_convert_field(StatementClass *stmt,
 			void *value,
 			SQLSMALLINT fCType, int precision,
 			PTR rgbValue, SQLLEN cbValueMax, SQLLEN *pcbValue, SQLLEN *pIndicator);
+int	setup_columnar_fetch(StatementClass *stmt, SQLLEN rowsetSize);
+int	copy_and_convert_rowset(StatementClass *stmt, SQLLEN nrows, SQLUSMALLINT *row_status);
+void	reset_columnar_fetch(StatementClass *stmt);
+void	InitializeConvertWorkers(void);
+void	StopConvertWorkers(void);
+void	FinalizeConvertWorkers(void);
 
 int		copy_statement_with_parameters(StatementClass *stmt, BOOL);
 SQLLEN		pg_hex2bin(const char *in, char *out, SQLLEN len);
@@ -40,6 +47,7 @@ BOOL build_libpq_bind_params(StatementClass *stmt,
 						int **paramLengths,
 						int **paramFormats,
 						int *resultFormat);
+BOOL build_copy_in_row(StatementClass *stmt, PQExpBuffer buf);
 #ifdef	__cplusplus
 }
 #endif
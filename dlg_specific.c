@@ -685,6 +685,45 @@ copyConnAttributes(ConnInfo *ci, const char *attribute, const char *value)
 		ci->optional_errors = atoi(value);
 	else if (stricmp(attribute, INI_IGNORETIMEOUT) == 0 || stricmp(attribute, ABBR_IGNORETIMEOUT) == 0)
 		ci->ignore_timeout = atoi(value);
+	else if (stricmp(attribute, INI_RESULTCHUNKSIZE) == 0 || stricmp(attribute, ABBR_RESULTCHUNKSIZE) == 0)
+		ci->result_chunk_size = atoi(value);
+	else if (stricmp(attribute, INI_BINARYRESULTS) == 0 || stricmp(attribute, ABBR_BINARYRESULTS) == 0)
+		ci->binary_results = atoi(value);
+	else if (stricmp(attribute, INI_USEPIPELINE) == 0 || stricmp(attribute, ABBR_USEPIPELINE) == 0)
+		ci->use_pipeline = atoi(value);
+	else if (stricmp(attribute, INI_USECOPYINSERT) == 0 || stricmp(attribute, ABBR_USECOPYINSERT) == 0)
+		ci->use_copy_insert = atoi(value);
+	else if (stricmp(attribute, INI_CONNECTIONPOOLSIZE) == 0 || stricmp(attribute, ABBR_CONNECTIONPOOLSIZE) == 0)
+		ci->pool_size = atoi(value);
+	else if (stricmp(attribute, INI_COLLECTMETRICS) == 0 || stricmp(attribute, ABBR_COLLECTMETRICS) == 0)
+		ci->collect_metrics = atoi(value);
+	else if (stricmp(attribute, INI_PLANCACHESIZE) == 0 || stricmp(attribute, ABBR_PLANCACHESIZE) == 0)
+		ci->plan_cache_size = atoi(value);
+	else if (stricmp(attribute, INI_COLINFOCACHETTL) == 0 || stricmp(attribute, ABBR_COLINFOCACHETTL) == 0)
+		ci->coli_cache_ttl = atoi(value);
+	else if (stricmp(attribute, INI_KEYSETRELOADBATCH) == 0 || stricmp(attribute, ABBR_KEYSETRELOADBATCH) == 0)
+		ci->keyset_reload_batch = atoi(value);
+	else if (stricmp(attribute, INI_FETCHAHEAD) == 0 || stricmp(attribute, ABBR_FETCHAHEAD) == 0)
+		ci->fetch_ahead = atoi(value);
+	else if (stricmp(attribute, INI_ADAPTIVEFETCHBYTES) == 0 || stricmp(attribute, ABBR_ADAPTIVEFETCHBYTES) == 0)
+		ci->adaptive_fetch_bytes = atoi(value);
+	else if (stricmp(attribute, INI_ADAPTIVEFETCHMIN) == 0 || stricmp(attribute, ABBR_ADAPTIVEFETCHMIN) == 0)
+		ci->adaptive_fetch_min = atoi(value);
+	else if (stricmp(attribute, INI_ADAPTIVEFETCHMAX) == 0 || stricmp(attribute, ABBR_ADAPTIVEFETCHMAX) == 0)
+		ci->adaptive_fetch_max = atoi(value);
+	else if (stricmp(attribute, INI_ZEROCOPYFETCH) == 0 || stricmp(attribute, ABBR_ZEROCOPYFETCH) == 0)
+		ci->zero_copy_fetch = atoi(value);
+	else if (stricmp(attribute, INI_CONVERTTHREADS) == 0 || stricmp(attribute, ABBR_CONVERTTHREADS) == 0)
+		ci->convert_threads = atoi(value);
+	else if (stricmp(attribute, INI_QUERYCACHESIZE) == 0 || stricmp(attribute, ABBR_QUERYCACHESIZE) == 0)
+		ci->query_cache_size = atoi(value);
+	else if (stricmp(attribute, INI_LOREADAHEADSIZE) == 0 || stricmp(attribute, ABBR_LOREADAHEADSIZE) == 0)
+		ci->lo_read_ahead_size = atoi(value);
+	else if (stricmp(attribute, INI_POOLRESETQUERY) == 0 || stricmp(attribute, ABBR_POOLRESETQUERY) == 0)
+	{
+		NULL_THE_NAME(ci->pool_reset_query);
+		ci->pool_reset_query = decode_or_remove_braces(value);
+	}
 	else if (stricmp(attribute, INI_SSLMODE) == 0 || stricmp(attribute, ABBR_SSLMODE) == 0)
 	{
 		switch (value[0])
@@ -1064,6 +1103,43 @@ MYLOG(0, "drivername=%s\n", drivername);
 			ci->batch_size = DEFAULT_BATCH_SIZE;
 	if (SQLGetPrivateProfileString(DSN, INI_IGNORETIMEOUT, NULL_STRING, temp, sizeof(temp), ODBC_INI) > 0)
 		ci->ignore_timeout = atoi(temp);
+	if (SQLGetPrivateProfileString(DSN, INI_RESULTCHUNKSIZE, NULL_STRING, temp, sizeof(temp), ODBC_INI) > 0)
+		ci->result_chunk_size = atoi(temp);
+	if (SQLGetPrivateProfileString(DSN, INI_BINARYRESULTS, NULL_STRING, temp, sizeof(temp), ODBC_INI) > 0)
+		ci->binary_results = atoi(temp);
+	if (SQLGetPrivateProfileString(DSN, INI_USEPIPELINE, NULL_STRING, temp, sizeof(temp), ODBC_INI) > 0)
+		ci->use_pipeline = atoi(temp);
+	if (SQLGetPrivateProfileString(DSN, INI_USECOPYINSERT, NULL_STRING, temp, sizeof(temp), ODBC_INI) > 0)
+		ci->use_copy_insert = atoi(temp);
+	if (SQLGetPrivateProfileString(DSN, INI_CONNECTIONPOOLSIZE, NULL_STRING, temp, sizeof(temp), ODBC_INI) > 0)
+		ci->pool_size = atoi(temp);
+	if (SQLGetPrivateProfileString(DSN, INI_COLLECTMETRICS, NULL_STRING, temp, sizeof(temp), ODBC_INI) > 0)
+		ci->collect_metrics = atoi(temp);
+	if (SQLGetPrivateProfileString(DSN, INI_PLANCACHESIZE, NULL_STRING, temp, sizeof(temp), ODBC_INI) > 0)
+		ci->plan_cache_size = atoi(temp);
+	if (SQLGetPrivateProfileString(DSN, INI_COLINFOCACHETTL, NULL_STRING, temp, sizeof(temp), ODBC_INI) > 0)
+		ci->coli_cache_ttl = atoi(temp);
+	if (SQLGetPrivateProfileString(DSN, INI_KEYSETRELOADBATCH, NULL_STRING, temp, sizeof(temp), ODBC_INI) > 0)
+		ci->keyset_reload_batch = atoi(temp);
+	if (SQLGetPrivateProfileString(DSN, INI_FETCHAHEAD, NULL_STRING, temp, sizeof(temp), ODBC_INI) > 0)
+		ci->fetch_ahead = atoi(temp);
+	if (SQLGetPrivateProfileString(DSN, INI_ADAPTIVEFETCHBYTES, NULL_STRING, temp, sizeof(temp), ODBC_INI) > 0)
+		ci->adaptive_fetch_bytes = atoi(temp);
+	if (SQLGetPrivateProfileString(DSN, INI_ADAPTIVEFETCHMIN, NULL_STRING, temp, sizeof(temp), ODBC_INI) > 0)
+		ci->adaptive_fetch_min = atoi(temp);
+	if (SQLGetPrivateProfileString(DSN, INI_ADAPTIVEFETCHMAX, NULL_STRING, temp, sizeof(temp), ODBC_INI) > 0)
+		ci->adaptive_fetch_max = atoi(temp);
+	if (SQLGetPrivateProfileString(DSN, INI_ZEROCOPYFETCH, NULL_STRING, temp, sizeof(temp), ODBC_INI) > 0)
+		ci->zero_copy_fetch = atoi(temp);
+	if (SQLGetPrivateProfileString(DSN, INI_CONVERTTHREADS, NULL_STRING, temp, sizeof(temp), ODBC_INI) > 0)
+		ci->convert_threads = atoi(temp);
+	if (SQLGetPrivateProfileString(DSN, INI_QUERYCACHESIZE, NULL_STRING, temp, sizeof(temp), ODBC_INI) > 0)
+		ci->query_cache_size = atoi(temp);
+	if (SQLGetPrivateProfileString(DSN, INI_LOREADAHEADSIZE, NULL_STRING, temp, sizeof(temp), ODBC_INI) > 0)
+		ci->lo_read_ahead_size = atoi(temp);
+	SQLGetPrivateProfileString(DSN, INI_POOLRESETQUERY, ENTRY_TEST, temp, sizeof(temp), ODBC_INI);
+	if (strcmp(temp, ENTRY_TEST))	/* entry exists */
+		STRX_TO_NAME(ci->pool_reset_query, temp);
 
 	if (SQLGetPrivateProfileString(DSN, INI_SSLMODE, NULL_STRING, temp, sizeof(temp), ODBC_INI) > 0)
 		STRCPY_FIXED(ci->sslmode, temp);
@@ -1360,6 +1436,95 @@ writeDSNinfo(const ConnInfo *ci)
 								 INI_IGNORETIMEOUT,
 								 temp,
 								 ODBC_INI);
+	ITOA_FIXED(temp, ci->result_chunk_size);
+	SQLWritePrivateProfileString(DSN,
+								 INI_RESULTCHUNKSIZE,
+								 temp,
+								 ODBC_INI);
+	ITOA_FIXED(temp, ci->binary_results);
+	SQLWritePrivateProfileString(DSN,
+								 INI_BINARYRESULTS,
+								 temp,
+								 ODBC_INI);
+	ITOA_FIXED(temp, ci->use_pipeline);
+	SQLWritePrivateProfileString(DSN,
+								 INI_USEPIPELINE,
+								 temp,
+								 ODBC_INI);
+	ITOA_FIXED(temp, ci->use_copy_insert);
+	SQLWritePrivateProfileString(DSN,
+								 INI_USECOPYINSERT,
+								 temp,
+								 ODBC_INI);
+	ITOA_FIXED(temp, ci->pool_size);
+	SQLWritePrivateProfileString(DSN,
+								 INI_CONNECTIONPOOLSIZE,
+								 temp,
+								 ODBC_INI);
+	ITOA_FIXED(temp, ci->collect_metrics);
+	SQLWritePrivateProfileString(DSN,
+								 INI_COLLECTMETRICS,
+								 temp,
+								 ODBC_INI);
+	ITOA_FIXED(temp, ci->plan_cache_size);
+	SQLWritePrivateProfileString(DSN,
+								 INI_PLANCACHESIZE,
+								 temp,
+								 ODBC_INI);
+	ITOA_FIXED(temp, ci->coli_cache_ttl);
+	SQLWritePrivateProfileString(DSN,
+								 INI_COLINFOCACHETTL,
+								 temp,
+								 ODBC_INI);
+	ITOA_FIXED(temp, ci->keyset_reload_batch);
+	SQLWritePrivateProfileString(DSN,
+								 INI_KEYSETRELOADBATCH,
+								 temp,
+								 ODBC_INI);
+	ITOA_FIXED(temp, ci->fetch_ahead);
+	SQLWritePrivateProfileString(DSN,
+								 INI_FETCHAHEAD,
+								 temp,
+								 ODBC_INI);
+	ITOA_FIXED(temp, ci->adaptive_fetch_bytes);
+	SQLWritePrivateProfileString(DSN,
+								 INI_ADAPTIVEFETCHBYTES,
+								 temp,
+								 ODBC_INI);
+	ITOA_FIXED(temp, ci->adaptive_fetch_min);
+	SQLWritePrivateProfileString(DSN,
+								 INI_ADAPTIVEFETCHMIN,
+								 temp,
+								 ODBC_INI);
+	ITOA_FIXED(temp, ci->adaptive_fetch_max);
+	SQLWritePrivateProfileString(DSN,
+								 INI_ADAPTIVEFETCHMAX,
+								 temp,
+								 ODBC_INI);
+	ITOA_FIXED(temp, ci->zero_copy_fetch);
+	SQLWritePrivateProfileString(DSN,
+								 INI_ZEROCOPYFETCH,
+								 temp,
+								 ODBC_INI);
+	ITOA_FIXED(temp, ci->convert_threads);
+	SQLWritePrivateProfileString(DSN,
+								 INI_CONVERTTHREADS,
+								 temp,
+								 ODBC_INI);
+	ITOA_FIXED(temp, ci->query_cache_size);
+	SQLWritePrivateProfileString(DSN,
+								 INI_QUERYCACHESIZE,
+								 temp,
+								 ODBC_INI);
+	ITOA_FIXED(temp, ci->lo_read_ahead_size);
+	SQLWritePrivateProfileString(DSN,
+								 INI_LOREADAHEADSIZE,
+								 temp,
+								 ODBC_INI);
+	SQLWritePrivateProfileString(DSN,
+								 INI_POOLRESETQUERY,
+								 SAFE_NAME(ci->pool_reset_query),
+								 ODBC_INI);
 #ifdef	_HANDLE_ENLIST_IN_DTC_
 	ITOA_FIXED(temp, ci->xa_opt);
 	SQLWritePrivateProfileString(DSN, INI_XAOPT, temp, ODBC_INI);
@@ -1740,6 +1905,7 @@ CC_conninfo_release(ConnInfo *conninfo)
 	NULL_THE_NAME(conninfo->password);
 	NULL_THE_NAME(conninfo->conn_settings);
 	NULL_THE_NAME(conninfo->pqopt);
+	NULL_THE_NAME(conninfo->pool_reset_query);
 	finalize_globals(&conninfo->drivers);
 }
 
@@ -1773,6 +1939,23 @@ CC_conninfo_init(ConnInfo *conninfo, UInt4 option)
 	conninfo->keepalive_interval = -1;
 	conninfo->batch_size = DEFAULT_BATCH_SIZE;
 	conninfo->ignore_timeout = DEFAULT_IGNORETIMEOUT;
+	conninfo->result_chunk_size = DEFAULT_RESULTCHUNKSIZE;
+	conninfo->binary_results = DEFAULT_BINARYRESULTS;
+	conninfo->use_pipeline = DEFAULT_USEPIPELINE;
+	conninfo->use_copy_insert = DEFAULT_USECOPYINSERT;
+	conninfo->pool_size = DEFAULT_CONNECTIONPOOLSIZE;
+	conninfo->collect_metrics = DEFAULT_COLLECTMETRICS;
+	conninfo->plan_cache_size = DEFAULT_PLANCACHESIZE;
+	conninfo->coli_cache_ttl = DEFAULT_COLINFOCACHETTL;
+	conninfo->keyset_reload_batch = DEFAULT_KEYSETRELOADBATCH;
+	conninfo->fetch_ahead = DEFAULT_FETCHAHEAD;
+	conninfo->adaptive_fetch_bytes = DEFAULT_ADAPTIVEFETCHBYTES;
+	conninfo->adaptive_fetch_min = DEFAULT_ADAPTIVEFETCHMIN;
+	conninfo->adaptive_fetch_max = DEFAULT_ADAPTIVEFETCHMAX;
+	conninfo->zero_copy_fetch = DEFAULT_ZEROCOPYFETCH;
+	conninfo->convert_threads = DEFAULT_CONVERTTHREADS;
+	conninfo->query_cache_size = DEFAULT_QUERYCACHESIZE;
+	conninfo->lo_read_ahead_size = DEFAULT_LOREADAHEADSIZE;
 	conninfo->wcs_debug = -1;
 #ifdef	_HANDLE_ENLIST_IN_DTC_
 	conninfo->xa_opt = -1;
@@ -1874,6 +2057,24 @@ CC_copy_conninfo(ConnInfo *ci, const ConnInfo *sci)
 	CORR_VALCPY(keepalive_interval);
 	CORR_VALCPY(batch_size);
 	CORR_VALCPY(ignore_timeout);
+	CORR_VALCPY(result_chunk_size);
+	CORR_VALCPY(binary_results);
+	CORR_VALCPY(use_pipeline);
+	CORR_VALCPY(use_copy_insert);
+	CORR_VALCPY(pool_size);
+	CORR_VALCPY(collect_metrics);
+	CORR_VALCPY(plan_cache_size);
+	CORR_VALCPY(coli_cache_ttl);
+	CORR_VALCPY(keyset_reload_batch);
+	CORR_VALCPY(fetch_ahead);
+	CORR_VALCPY(adaptive_fetch_bytes);
+	CORR_VALCPY(adaptive_fetch_min);
+	CORR_VALCPY(adaptive_fetch_max);
+	CORR_VALCPY(zero_copy_fetch);
+	CORR_VALCPY(convert_threads);
+	CORR_VALCPY(query_cache_size);
+	CORR_VALCPY(lo_read_ahead_size);
+	NAME_TO_NAME(ci->pool_reset_query, sci->pool_reset_query);
 #ifdef	_HANDLE_ENLIST_IN_DTC_
 	CORR_VALCPY(xa_opt);
 #endif
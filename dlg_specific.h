@@ -160,6 +160,7 @@ extern "C" {
 #define ABBR_SSLMODE			"CA"
 #define INI_EXTRAOPTIONS		"AB"
 #define INI_LOGDIR			"Logdir"
+#define INI_LOGBUFFERSIZE		"LogBufferSize"
 #define INI_KEEPALIVETIME		"KeepaliveTime"
 #define ABBR_KEEPALIVETIME		"D1"
 #define INI_KEEPALIVEINTERVAL		"KeepaliveInterval"
@@ -172,6 +173,42 @@ extern "C" {
 #define ABBR_BATCHSIZE			"D8"
 #define INI_IGNORETIMEOUT		"IgnoreTimeout"
 #define ABBR_IGNORETIMEOUT		"D9"
+#define INI_RESULTCHUNKSIZE		"ResultChunkSize"
+#define ABBR_RESULTCHUNKSIZE		"E1"
+#define INI_BINARYRESULTS		"BinaryResults"
+#define ABBR_BINARYRESULTS		"E2"
+#define INI_USEPIPELINE			"UsePipeline"
+#define ABBR_USEPIPELINE		"E3"
+#define INI_USECOPYINSERT		"UseCopyInsert"
+#define ABBR_USECOPYINSERT		"E4"
+#define INI_CONNECTIONPOOLSIZE		"ConnectionPoolSize"
+#define ABBR_CONNECTIONPOOLSIZE		"E5"
+#define INI_POOLRESETQUERY		"PoolResetQuery"
+#define ABBR_POOLRESETQUERY		"E6"
+#define INI_COLLECTMETRICS		"CollectMetrics"
+#define ABBR_COLLECTMETRICS		"E7"
+#define INI_PLANCACHESIZE		"PlanCacheSize"
+#define ABBR_PLANCACHESIZE		"E8"
+#define INI_COLINFOCACHETTL		"ColumnInfoCacheTTL"
+#define ABBR_COLINFOCACHETTL		"E9"
+#define INI_KEYSETRELOADBATCH		"KeysetReloadBatch"
+#define ABBR_KEYSETRELOADBATCH		"F1"
+#define INI_FETCHAHEAD			"FetchAhead"
+#define ABBR_FETCHAHEAD			"F2"
+#define INI_ADAPTIVEFETCHBYTES		"AdaptiveFetchBytes"
+#define ABBR_ADAPTIVEFETCHBYTES		"F3"
+#define INI_ADAPTIVEFETCHMIN		"AdaptiveFetchMin"
+#define ABBR_ADAPTIVEFETCHMIN		"F4"
+#define INI_ADAPTIVEFETCHMAX		"AdaptiveFetchMax"
+#define ABBR_ADAPTIVEFETCHMAX		"F5"
+#define INI_ZEROCOPYFETCH		"ZeroCopyFetch"
+#define ABBR_ZEROCOPYFETCH		"F6"
+#define INI_CONVERTTHREADS		"ConvertThreads"
+#define ABBR_CONVERTTHREADS		"F7"
+#define INI_QUERYCACHESIZE		"QueryCacheSize"
+#define ABBR_QUERYCACHESIZE		"F8"
+#define INI_LOREADAHEADSIZE		"LOReadAheadSize"
+#define ABBR_LOREADAHEADSIZE		"F9"
 #define INI_DTCLOG			"Dtclog"
 /* "PreferLibpq", abbreviated "D4", used to mean whether to prefer libpq.
  * libpq is now required
@@ -243,6 +280,7 @@ extern "C" {
 #define DEFAULT_UNIQUEINDEX			1		/* dont recognize */
 #define DEFAULT_COMMLOG				0		/* dont log */
 #define DEFAULT_DEBUG				0
+#define DEFAULT_LOGBUFFERSIZE			0	/* KB, 0 to write directly */
 #define DEFAULT_UNKNOWNSIZES			UNKNOWNS_AS_MAX
 
 
@@ -273,6 +311,24 @@ extern "C" {
 #define DEFAULT_OPTIONAL_ERRORS		0
 #define DEFAULT_BATCH_SIZE		100
 #define DEFAULT_IGNORETIMEOUT		0
+#define DEFAULT_RESULTCHUNKSIZE		1	/* row by row */
+#define DEFAULT_BINARYRESULTS		0
+#define DEFAULT_USEPIPELINE		0
+#define DEFAULT_USECOPYINSERT		0
+#define DEFAULT_CONNECTIONPOOLSIZE	0	/* no pooling */
+#define DEFAULT_POOLRESETQUERY		"DISCARD ALL"
+#define DEFAULT_COLLECTMETRICS		0
+#define DEFAULT_PLANCACHESIZE		0
+#define DEFAULT_COLINFOCACHETTL		0	/* no sharing */
+#define DEFAULT_KEYSETRELOADBATCH	512
+#define DEFAULT_FETCHAHEAD		0	/* no read-ahead */
+#define DEFAULT_ADAPTIVEFETCHBYTES	0	/* use Fetch */
+#define DEFAULT_ADAPTIVEFETCHMIN	100
+#define DEFAULT_ADAPTIVEFETCHMAX	100000
+#define DEFAULT_ZEROCOPYFETCH		0
+#define DEFAULT_CONVERTTHREADS		0	/* no worker threads */
+#define DEFAULT_QUERYCACHESIZE		0
+#define DEFAULT_LOREADAHEADSIZE		0	/* read by the application buffer */
 
 #ifdef	_HANDLE_ENLIST_IN_DTC_
 #define DEFAULT_XAOPT			1
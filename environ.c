@@ -19,6 +19,8 @@
 #include "connection.h"
 #include "dlg_specific.h"
 #include "statement.h"
+#include "qresult.h"
+#include "convert.h"
 #include <stdlib.h>
 #include <string.h>
 #include "pgapifunc.h"
@@ -29,9 +31,46 @@
 
 
 /* The one instance of the handles */
+static int envs_count = 0;
 static int conns_count = 0;
 static ConnectionClass **conns = NULL;
 
+/*
+ * The idle libpq connections parked by the driver side connection pool,
+ * keyed by their connection parameters.
+ */
+typedef struct PooledConn_
+{
+	struct PooledConn_	*next;
+	char	   *key;
+	void	   *pqconn;
+} PooledConn;
+static PooledConn *pooled_conns = NULL;
+
+/*
+ * The column information of tables shared by the connections to the same
+ * database as the same user, hashed by the names and by the oid of the
+ * tables. The entries are protected by common_cs and the results in them
+ * are never modified while they are shared.
+ */
+#define	SHARED_COLI_BUCKETS	256
+struct SharedColInfo_
+{
+	SharedColInfo	*name_next;
+	SharedColInfo	*oid_next;
+	Int4		refcnt;		/* the connections using the entry */
+	BOOL		unlinked;	/* removed from the hash tables ? */
+	char	   *key;
+	char	   *schema_name;
+	char	   *table_name;
+	OID		table_oid;
+	UInt4		name_hash;
+	time_t		stored;
+	QResultClass	*result;
+};
+static SharedColInfo *shared_coli_names[SHARED_COLI_BUCKETS];
+static SharedColInfo *shared_coli_oids[SHARED_COLI_BUCKETS];
+
 #if defined(WIN_MULTITHREAD_SUPPORT)
 CRITICAL_SECTION	conns_cs;
 CRITICAL_SECTION	common_cs; /* commonly used for short term blocking */
@@ -369,6 +408,10 @@ PGAPI_ConnectError(HDBC hdbc,
 			case CONN_ILLEGAL_TRANSACT_STATE:
 				pg_sqlstate_set(env, szSqlState, "25000", "S1010");
 				break;
+			case CONN_SEQUENCE_ERROR:
+				pg_sqlstate_set(env, szSqlState, "HY010", "S1010");
+				/* function sequence error */
+				break;
 			case CONN_VALUE_OUT_OF_RANGE:
 				pg_sqlstate_set(env, szSqlState, "HY019", "22003");
 				break;
@@ -498,6 +541,9 @@ EN_Constructor(void)
 	rv->errornumber = 0;
 	rv->flag = 0;
 	INIT_ENV_CS(rv);
+	ENTER_CONNS_CS;
+	envs_count++;
+	LEAVE_CONNS_CS;
 cleanup:
 #ifdef WIN32
 	if (NULL == rv)
@@ -510,11 +556,59 @@ cleanup:
 }
 
 
+/* Close all the parked connections, called in ENTER_CONNS_CS */
+static void
+close_pooled_conns(void)
+{
+	PooledConn	*pconn;
+
+	while (pconn = pooled_conns, NULL != pconn)
+	{
+		pooled_conns = pconn->next;
+		QLOG(0, "PQfinish: %p\n", pconn->pqconn);
+		PQfinish(pconn->pqconn);
+		free(pconn->key);
+		free(pconn);
+	}
+}
+
+static void	unlink_shared_col_info(SharedColInfo *shared);
+static void	free_shared_col_info(SharedColInfo *shared);
+
+/* Free all the shared column information, called in ENTER_CONNS_CS */
+static void
+clear_shared_col_info(void)
+{
+	SharedColInfo	*shared, *garbage = NULL;
+	int		i;
+
+	ENTER_COMMON_CS;
+	for (i = 0; i < SHARED_COLI_BUCKETS; i++)
+	{
+		while (shared = shared_coli_names[i], NULL != shared)
+		{
+			unlink_shared_col_info(shared);
+			if (0 >= shared->refcnt)
+			{
+				shared->name_next = garbage;
+				garbage = shared;
+			}
+		}
+	}
+	LEAVE_COMMON_CS;
+	while (shared = garbage, NULL != shared)
+	{
+		garbage = shared->name_next;
+		free_shared_col_info(shared);
+	}
+}
+
 char
 EN_Destructor(EnvironmentClass *self)
 {
 	int		lf, nullcnt;
 	char		rv = 1;
+	BOOL		last_env;
 
 	MYLOG(0, "entering self=%p\n", self);
 	if (!self)
@@ -546,8 +640,14 @@ EN_Destructor(EnvironmentClass *self)
 		free(conns);
 		conns = NULL;
 		conns_count = 0;
+		close_pooled_conns();
+		clear_shared_col_info();
 	}
+	last_env = (--envs_count <= 0);
 	LEAVE_CONNS_CS;
+	/* Don't leave the convert workers to DllMain */
+	if (last_env)
+		StopConvertWorkers();
 	DELETE_ENV_CS(self);
 	free(self);
 
@@ -638,6 +738,274 @@ EN_remove_connection(EnvironmentClass *self, ConnectionClass *conn)
 }
 
 
+/*
+ * Park the idle libpq connection pqconn in the connection pool.
+ * Returns FALSE if max_idle connections with the same key are parked
+ * already, then the caller should close pqconn.
+ */
+BOOL
+EN_park_pqconn(const char *key, void *pqconn, int max_idle)
+{
+	PooledConn	*pconn;
+	int			count = 0;
+	BOOL		ret = FALSE;
+
+	ENTER_CONNS_CS;
+	for (pconn = pooled_conns; NULL != pconn; pconn = pconn->next)
+	{
+		if (strcmp(pconn->key, key) == 0)
+			count++;
+	}
+	if (count >= max_idle)
+		goto cleanup;
+	if (pconn = (PooledConn *) malloc(sizeof(PooledConn)), NULL == pconn)
+		goto cleanup;
+	if (pconn->key = strdup(key), NULL == pconn->key)
+	{
+		free(pconn);
+		goto cleanup;
+	}
+	pconn->pqconn = pqconn;
+	pconn->next = pooled_conns;
+	pooled_conns = pconn;
+	ret = TRUE;
+	MYLOG(0, "parked pqconn=%p idle count=%d\n", pqconn, count + 1);
+cleanup:
+	LEAVE_CONNS_CS;
+	return ret;
+}
+
+/*
+ * Take a parked libpq connection with the key out of the connection pool.
+ * Returns NULL if there's none.
+ */
+void *
+EN_take_pqconn(const char *key)
+{
+	PooledConn	*pconn, **prev;
+	void	   *pqconn = NULL;
+
+	ENTER_CONNS_CS;
+	for (prev = &pooled_conns; NULL != (pconn = *prev); prev = &pconn->next)
+	{
+		if (strcmp(pconn->key, key) == 0)
+		{
+			*prev = pconn->next;
+			pqconn = pconn->pqconn;
+			free(pconn->key);
+			free(pconn);
+			break;
+		}
+	}
+	LEAVE_CONNS_CS;
+	MYLOG(0, "took pqconn=%p\n", pqconn);
+	return pqconn;
+}
+
+
+/* Remove the entry from the hash tables, called in ENTER_COMMON_CS */
+static void
+unlink_shared_col_info(SharedColInfo *shared)
+{
+	SharedColInfo	**prev;
+
+	if (shared->unlinked)
+		return;
+	for (prev = &shared_coli_names[shared->name_hash % SHARED_COLI_BUCKETS]; NULL != *prev; prev = &(*prev)->name_next)
+	{
+		if (*prev == shared)
+		{
+			*prev = shared->name_next;
+			break;
+		}
+	}
+	for (prev = &shared_coli_oids[shared->table_oid % SHARED_COLI_BUCKETS]; NULL != *prev; prev = &(*prev)->oid_next)
+	{
+		if (*prev == shared)
+		{
+			*prev = shared->oid_next;
+			break;
+		}
+	}
+	shared->name_next = shared->oid_next = NULL;
+	shared->unlinked = TRUE;
+}
+
+static void
+free_shared_col_info(SharedColInfo *shared)
+{
+	if (shared->result)
+		QR_Destructor(shared->result);
+	if (shared->key)
+		free(shared->key);
+	if (shared->schema_name)
+		free(shared->schema_name);
+	if (shared->table_name)
+		free(shared->table_name);
+	free(shared);
+}
+
+/*
+ * Look up the shared column information of the table by the oid, or by
+ * the names if table_oid is 0. The entries older than ttl seconds are
+ * discarded. Returns the entry referenced for the caller, who must call
+ * EN_release_shared_col_info() when it's no longer used, or NULL if
+ * not found.
+ */
+SharedColInfo *
+EN_find_shared_col_info(const char *key, const char *schema_name, const char *table_name, OID table_oid, int ttl, QResultClass **result)
+{
+	SharedColInfo	*shared, *garbage = NULL;
+	UInt4		name_hash = 0;
+	time_t		now = time(NULL);
+
+	if (0 == table_oid)
+		name_hash = hash_names_icase(schema_name, table_name);
+	ENTER_COMMON_CS;
+	if (0 != table_oid)
+		shared = shared_coli_oids[table_oid % SHARED_COLI_BUCKETS];
+	else
+		shared = shared_coli_names[name_hash % SHARED_COLI_BUCKETS];
+	for (; NULL != shared; shared = (0 != table_oid ? shared->oid_next : shared->name_next))
+	{
+		if (0 != table_oid)
+		{
+			if (shared->table_oid != table_oid)
+				continue;
+		}
+		else if (shared->name_hash != name_hash ||
+				 stricmp(shared->table_name, table_name) != 0 ||
+				 stricmp(shared->schema_name, schema_name) != 0)
+			continue;
+		if (strcmp(shared->key, key) != 0)
+			continue;
+		if (now - shared->stored >= ttl)
+		{
+			MYLOG(0, "expired shared col_info table='%s'\n", shared->table_name);
+			unlink_shared_col_info(shared);
+			if (0 >= shared->refcnt)
+				garbage = shared;
+			shared = NULL;
+		}
+		break;
+	}
+	if (NULL != shared)
+	{
+		shared->refcnt++;
+		*result = shared->result;
+	}
+	LEAVE_COMMON_CS;
+	if (NULL != garbage)
+		free_shared_col_info(garbage);
+	MYLOG(0, "found shared col_info=%p\n", shared);
+	return shared;
+}
+
+/*
+ * Share the column information of the table with the other connections.
+ * Returns the entry, which owns result from now on, referenced for the
+ * caller like EN_find_shared_col_info(), or NULL on failure.
+ */
+SharedColInfo *
+EN_share_col_info(const char *key, const char *schema_name, const char *table_name, OID table_oid, QResultClass *result)
+{
+	SharedColInfo	*shared, *old, *garbage = NULL;
+	UInt4		name_hash = hash_names_icase(schema_name, table_name);
+
+	if (shared = (SharedColInfo *) calloc(1, sizeof(SharedColInfo)), NULL == shared)
+		return NULL;
+	shared->key = strdup(key);
+	shared->schema_name = strdup(schema_name);
+	shared->table_name = strdup(table_name);
+	if (NULL == shared->key ||
+	    NULL == shared->schema_name ||
+	    NULL == shared->table_name)
+	{
+		free_shared_col_info(shared);
+		return NULL;
+	}
+	shared->result = result;
+	shared->table_oid = table_oid;
+	shared->name_hash = name_hash;
+	shared->stored = time(NULL);
+	shared->refcnt = 1;
+	/* the result outlives the connection */
+	QR_set_conn(result, NULL);
+
+	ENTER_COMMON_CS;
+	/* replace the entry another connection may have shared meanwhile */
+	for (old = shared_coli_oids[table_oid % SHARED_COLI_BUCKETS]; NULL != old; old = old->oid_next)
+	{
+		if (old->table_oid == table_oid &&
+		    strcmp(old->key, key) == 0)
+		{
+			unlink_shared_col_info(old);
+			if (0 >= old->refcnt)
+				garbage = old;
+			break;
+		}
+	}
+	shared->name_next = shared_coli_names[name_hash % SHARED_COLI_BUCKETS];
+	shared_coli_names[name_hash % SHARED_COLI_BUCKETS] = shared;
+	shared->oid_next = shared_coli_oids[table_oid % SHARED_COLI_BUCKETS];
+	shared_coli_oids[table_oid % SHARED_COLI_BUCKETS] = shared;
+	LEAVE_COMMON_CS;
+	if (NULL != garbage)
+		free_shared_col_info(garbage);
+	MYLOG(0, "shared col_info=%p table='%s'\n", shared, table_name);
+	return shared;
+}
+
+/* Release the reference to the shared column information */
+void
+EN_release_shared_col_info(SharedColInfo *shared)
+{
+	BOOL	discard;
+
+	ENTER_COMMON_CS;
+	shared->refcnt--;
+	discard = (shared->unlinked && 0 >= shared->refcnt);
+	LEAVE_COMMON_CS;
+	if (discard)
+		free_shared_col_info(shared);
+}
+
+/*
+ * Discard the shared column information of the database, e.g. after
+ * a table definition was changed. The entries in use are freed when
+ * they are released.
+ */
+void
+EN_clear_shared_col_info(const char *key)
+{
+	SharedColInfo	*shared, *next, *garbage = NULL;
+	int		i;
+
+	ENTER_COMMON_CS;
+	for (i = 0; i < SHARED_COLI_BUCKETS; i++)
+	{
+		for (shared = shared_coli_names[i]; NULL != shared; shared = next)
+		{
+			next = shared->name_next;
+			if (strcmp(shared->key, key) != 0)
+				continue;
+			unlink_shared_col_info(shared);
+			if (0 >= shared->refcnt)
+			{
+				shared->name_next = garbage;
+				garbage = shared;
+			}
+		}
+	}
+	LEAVE_COMMON_CS;
+	while (shared = garbage, NULL != shared)
+	{
+		garbage = shared->name_next;
+		free_shared_col_info(shared);
+	}
+}
+
+
 void
 EN_log_error(const char *func, char *desc, EnvironmentClass *self)
 {
@@ -40,6 +40,12 @@ char		EN_Destructor(EnvironmentClass *self);
 char		EN_get_error(EnvironmentClass *self, int *number, char **message);
 char		EN_add_connection(EnvironmentClass *self, ConnectionClass *conn);
 char		EN_remove_connection(EnvironmentClass *self, ConnectionClass *conn);
+BOOL		EN_park_pqconn(const char *key, void *pqconn, int max_idle);
+void	   *EN_take_pqconn(const char *key);
+SharedColInfo *EN_find_shared_col_info(const char *key, const char *schema_name, const char *table_name, OID table_oid, int ttl, QResultClass **result);
+SharedColInfo *EN_share_col_info(const char *key, const char *schema_name, const char *table_name, OID table_oid, QResultClass *result);
+void		EN_release_shared_col_info(SharedColInfo *shared);
+void		EN_clear_shared_col_info(const char *key);
 void		EN_log_error(const char *func, char *desc, EnvironmentClass *self);
 int	getConnCount(void);
 ConnectionClass * const *getConnList(void);
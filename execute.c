@@ -464,7 +464,12 @@ MYLOG(DETAIL_LOG_LEVEL, "prepare_before_exec=%d srv=%d\n", prepare_before_exec,
 			free(stmt_with_params);
 			stmt_with_params = stmt->stmt_with_params = NULL;
 		}
-		if (INVALID_EXPBUFFER ||
+		if (PIPELINE_EXEC == stmt->exec_type)
+		{
+			if (0 == stmt->count_of_deffered)
+				RETURN(SQL_SUCCESS);
+		}
+		else if (INVALID_EXPBUFFER ||
 		    !stmt->stmt_deffered.data[0])
 			RETURN(SQL_SUCCESS);
 	}
@@ -480,7 +485,12 @@ MYLOG(DETAIL_LOG_LEVEL, "prepare_before_exec=%d srv=%d\n", prepare_before_exec,
 		}
 		stmt_with_params = stmt->stmt_with_params;
 		if (!stmt_with_params) // Extended Protocol
-			exec_type = DIRECT_EXEC;
+		{
+			if (PIPELINE_EXEC != exec_type)
+				exec_type = DIRECT_EXEC;
+		}
+		else if (PIPELINE_EXEC == exec_type) // pipeline mode needs the extended protocol
+			exec_type = stmt->exec_type = DIRECT_EXEC;
 	}
 
 	MYLOG(0, "   stmt_with_params = '%s'\n", stmt->stmt_with_params);
@@ -517,21 +527,35 @@ MYLOG(0, "about to begin SC_execute exec_type=%d\n", exec_type);
 	{
 		retval = SC_execute(stmt);
 		stmt->count_of_deffered = 0;
+		if (SQL_STILL_EXECUTING == retval)
+		{
+			/* replayed when the query sent asynchronously completes */
+			stmt->exec_current_row = -1;
+			*exec_end = TRUE;
+			RETURN(retval)
+		}
 	}
-	else if (DEFFERED_EXEC == exec_type &&
+	else if ((DEFFERED_EXEC == exec_type || PIPELINE_EXEC == exec_type) &&
 		 stmt->exec_current_row < end_row &&
 		 stmt->count_of_deffered + 1 < stmt->batch_size)
 	{
-		if (INVALID_EXPBUFFER)
+		if (PIPELINE_EXEC != exec_type && INVALID_EXPBUFFER)
 			initPQExpBuffer(&stmt->stmt_deffered);
-		if (INVALID_EXPBUFFER)
+		if (PIPELINE_EXEC != exec_type && INVALID_EXPBUFFER)
 		{
 			retval = SQL_ERROR;
 			SC_set_error(stmt, STMT_NO_MEMORY_ERROR, "Out of memory", __FUNCTION__); 
 		}
 		else
 		{
-			if (NULL != stmt_with_params)
+			if (PIPELINE_EXEC == exec_type)
+			{
+				/* the parameters of the row are bound when the pipeline is sent */
+				if (0 == stmt->count_of_deffered)
+					stmt->pipeline_start_row = stmt->exec_current_row;
+				stmt->pipeline_end_row = stmt->exec_current_row;
+			}
+			else if (NULL != stmt_with_params)
 			{
 				if (stmt->stmt_deffered.data[0])
 					appendPQExpBuffer(&stmt->stmt_deffered, ";%s", stmt_with_params);
@@ -547,7 +571,16 @@ MYLOG(0, "about to begin SC_execute exec_type=%d\n", exec_type);
 	}
 	else
 	{
-		if (VALID_EXPBUFFER)
+		if (PIPELINE_EXEC == stmt->exec_type)
+		{
+			if (LAST_EXEC != exec_type)
+			{
+				if (0 == stmt->count_of_deffered)
+					stmt->pipeline_start_row = stmt->exec_current_row;
+				stmt->pipeline_end_row = stmt->exec_current_row;
+			}
+		}
+		else if (VALID_EXPBUFFER)
 		{
 			if (NULL != stmt_with_params)
 				appendPQExpBuffer(&stmt->stmt_deffered, ";%s", stmt_with_params);
@@ -805,6 +838,14 @@ CC_is_in_trans(conn), SC_is_rb_stmt(stmt), SC_is_tc_stmt(stmt));
 	{
 		case SQL_NEED_DATA:
 			break;
+		case SQL_STILL_EXECUTING:
+			/* don't hold the connection while the query is in flight */
+			if (stmt->lock_CC_for_rb)
+			{
+				stmt->lock_CC_for_rb = FALSE;
+				LEAVE_CONN_CS(conn);
+			}
+			return ret;
 		case SQL_ERROR:
 			start_stmt = TRUE;
 			break;
@@ -863,6 +904,54 @@ cleanup:
 	return ret;
 }
 
+/*
+ *	Asynchronous execution (SQL_ATTR_ASYNC_ENABLE) of SQLExecDirect and
+ *	SQLExecute.
+ *
+ *	The first call sends the query and returns SQL_STILL_EXECUTING. The
+ *	following calls collect the results without blocking and, once all of
+ *	them have arrived, replay the execution to process them. Statements
+ *	which don't send a simple query (server side prepared, declare/fetch,
+ *	arrays of parameters etc) complete synchronously, which ODBC allows.
+ *
+ *	Returns TRUE while the query of the statement is still executing.
+ */
+BOOL
+StartAsyncExec(StatementClass *stmt)
+{
+	ConnectionClass	*conn = SC_get_conn(stmt);
+	BOOL		completed;
+
+	if (CC_is_async_executing(conn, stmt))
+	{
+		ENTER_CONN_CS(conn);
+		completed = CC_poll_async_query(conn, FALSE);
+		LEAVE_CONN_CS(conn);
+		return !completed;
+	}
+	if (SQL_ASYNC_ENABLE_ON == stmt->options.async_enable &&
+	    SC_get_APDF(stmt)->paramset_size <= 1)
+		stmt->async_request = TRUE;
+	return FALSE;
+}
+
+RETCODE
+EndAsyncExec(StatementClass *stmt, RETCODE ret)
+{
+	ConnectionClass	*conn = SC_get_conn(stmt);
+
+	stmt->async_request = FALSE;
+	if (SQL_STILL_EXECUTING != ret &&
+	    CC_is_async_executing(conn, stmt))
+	{
+		/* the replayed execution didn't reach the query */
+		ENTER_CONN_CS(conn);
+		CC_discard_async_query(conn);
+		LEAVE_CONN_CS(conn);
+	}
+	return ret;
+}
+
 /*
  * Given a SQL statement, see if it is an INSERT INTO statement and extract
  * the name of the table (with schema) of the table that was inserted to.
@@ -920,6 +1009,225 @@ SC_setInsertedTable(StatementClass *stmt, RETCODE retval)
 		NULL_THE_NAME(conn->schemaIns);
 }
 
+/*
+ *	Are there data at execution parameters in the parameter rows ?
+ *	The rows of a pipeline or a COPY are bound after all of them were
+ *	processed, when the data put by SQLPutData() was already released.
+ */
+static BOOL
+has_data_at_exec_rows(StatementClass *stmt, SQLLEN start_row, SQLLEN end_row, Int4 num_p)
+{
+	APDFields	*apdopts = SC_get_APDF(stmt);
+	SQLULEN	offset = apdopts->param_offset_ptr ? *apdopts->param_offset_ptr : 0;
+	SQLINTEGER	bind_size = apdopts->param_bind_type;
+	SQLLEN		row, *pcVal;
+	int		i;
+
+	if (num_p > apdopts->allocated)
+		num_p = apdopts->allocated;
+	for (i = 0; i < num_p; i++)
+	{
+		if (NULL == apdopts->parameters[i].used)
+			continue;
+		for (row = start_row; row <= end_row; row++)
+		{
+			if (bind_size > 0)
+				pcVal = LENADDR_SHIFT(apdopts->parameters[i].used, offset + bind_size * row);
+			else
+				pcVal = LENADDR_SHIFT(apdopts->parameters[i].used, offset) + row;
+			if (*pcVal == SQL_DATA_AT_EXEC || *pcVal <= SQL_LEN_DATA_AT_EXEC_OFFSET)
+				return TRUE;
+		}
+	}
+	return FALSE;
+}
+
+static const char *
+skip_spaces(const char *p)
+{
+	while (isspace((UCHAR) *p))
+		p++;
+	return p;
+}
+
+static const char *
+match_keyword(const char *p, const char *keyword)
+{
+	size_t	len = strlen(keyword);
+
+	if (strnicmp(p, keyword, len) != 0 ||
+		isalnum((UCHAR) p[len]) || '_' == p[len])
+		return NULL;
+	return skip_spaces(p + len);
+}
+
+/*
+ *	COPY FROM STDIN is allowed only for tables and doesn't apply the rules,
+ *	so the INSERT is executed as it is for views and tables with INSERT
+ *	rules. Triggers on tables are fired by COPY as well.
+ */
+static BOOL
+is_copy_in_target(ConnectionClass *conn, const char *table, size_t table_len)
+{
+	PQExpBufferData	query = {0};
+	QResultClass	*res;
+	BOOL		ret = FALSE;
+	const char	*value;
+
+	if (!PG_VERSION_GE(conn, 9.4))	/* to_regclass() */
+		return FALSE;
+	initPQExpBuffer(&query);
+	appendPQExpBufferStr(&query, "SELECT c.relkind IN ('r', 'p') AND NOT EXISTS (SELECT 1 FROM pg_catalog.pg_rewrite r WHERE r.ev_class = c.oid AND r.ev_type = '3') FROM pg_catalog.pg_class c WHERE c.oid = pg_catalog.to_regclass('");
+	appendBinaryPQExpBuffer(&query, table, table_len);
+	appendPQExpBufferStr(&query, "')");
+	if (PQExpBufferDataBroken(query))
+		return FALSE;
+	res = CC_send_query(conn, query.data, NULL, READ_ONLY_QUERY, NULL);
+	if (QR_command_maybe_successful(res) &&
+		1 == QR_get_num_total_tuples(res) &&
+		NULL != (value = QR_get_value_backend_text(res, 0, 0)) &&
+		't' == value[0])
+		ret = TRUE;
+	QR_Destructor(res);
+	termPQExpBuffer(&query);
+	MYLOG(0, "%.*s %s a target of COPY\n", (int) table_len, table, ret ? "is" : "isn't");
+	return ret;
+}
+
+/*
+ *	Convert an INSERT statement of the form
+ *
+ *		INSERT INTO table (column, ...) VALUES (?, ...)
+ *
+ *	into the equivalent COPY table (column, ...) FROM STDIN command.
+ *	Returns FALSE for any other statement, including the ones with
+ *	literals, comments, escapes, RETURNING or ON CONFLICT clauses, which
+ *	must be executed as they are. The column list is required because
+ *	COPY needs the values of all the columns without it.
+ */
+static BOOL
+build_copy_in_query(ConnectionClass *conn, const char *statement, SQLSMALLINT num_params, PQExpBuffer copyq)
+{
+	const char	*p, *table, *columns;
+	size_t		table_len, columns_len;
+	int			nmarkers = 0;
+
+	for (p = statement; *p; p++)
+	{
+		if (0 != (*p & 0x80) ||
+			'\'' == *p || '\\' == *p || '{' == *p ||
+			('-' == *p && '-' == p[1]) ||
+			('/' == *p && '*' == p[1]))
+			return FALSE;
+	}
+	p = skip_spaces(statement);
+	if (p = match_keyword(p, "insert"), NULL == p)
+		return FALSE;
+	if (p = match_keyword(p, "into"), NULL == p)
+		return FALSE;
+	/* (schema-qualified) table name */
+	for (table = p; *p && '(' != *p && !isspace((UCHAR) *p); p++)
+	{
+		if ('"' == *p)
+		{
+			for (p++; '"' != *p; p++)
+			{
+				if (!*p)
+					return FALSE;
+			}
+		}
+		else if (!isalnum((UCHAR) *p) && NULL == strchr("_$.", *p))
+			return FALSE;
+	}
+	if (table_len = p - table, 0 == table_len)
+		return FALSE;
+	/* column list */
+	p = skip_spaces(p);
+	if ('(' != *p)
+		return FALSE;
+	for (columns = p++; ')' != *p; p++)
+	{
+		if ('"' == *p)
+		{
+			/* a quoted identifier may contain anything, "" is a quote */
+			for (p++; '"' != *p || '"' == p[1]; p++)
+			{
+				if (!*p)
+					return FALSE;
+				if ('"' == *p)
+					p++;
+			}
+		}
+		else if (!*p || '(' == *p || '?' == *p)
+			return FALSE;
+	}
+	columns_len = ++p - columns;
+	p = skip_spaces(p);
+	if (p = match_keyword(p, "values"), NULL == p)
+		return FALSE;
+	/* one row of parameter markers */
+	if ('(' != *p)
+		return FALSE;
+	for (p = skip_spaces(p + 1);; p = skip_spaces(p + 1))
+	{
+		if ('?' != *p)
+			return FALSE;
+		nmarkers++;
+		p = skip_spaces(p + 1);
+		if (')' == *p)
+			break;
+		if (',' != *p)
+			return FALSE;
+	}
+	p = skip_spaces(p + 1);
+	if (';' == *p)
+		p = skip_spaces(p + 1);
+	if (*p || nmarkers != num_params)
+		return FALSE;
+	if (!is_copy_in_target(conn, table, table_len))
+		return FALSE;
+
+	initPQExpBuffer(copyq);
+	appendPQExpBufferStr(copyq, "COPY ");
+	appendBinaryPQExpBuffer(copyq, table, table_len);
+	appendPQExpBufferChar(copyq, ' ');
+	appendBinaryPQExpBuffer(copyq, columns, columns_len);
+	appendPQExpBufferStr(copyq, " FROM STDIN");
+	if (PQExpBufferDataBroken(*copyq))
+	{
+		termPQExpBuffer(copyq);
+		return FALSE;
+	}
+	return TRUE;
+}
+
+/*
+ *	Can the parameter rows of the INSERT statement be sent by a COPY ?
+ */
+static BOOL
+can_copy_in_rows(StatementClass *stmt, SQLLEN start_row, SQLLEN end_row, SQLSMALLINT num_params, PQExpBuffer copyq)
+{
+	IPDFields	*ipdopts = SC_get_IPDF(stmt);
+	int		i;
+
+	if (!SC_get_conn(stmt)->connInfo.use_copy_insert ||
+		end_row <= start_row ||
+		STMT_TYPE_INSERT != stmt->statement_type ||
+		!stmt->external ||
+		num_params <= 0 ||
+		SC_get_APDF(stmt)->allocated < num_params ||
+		ipdopts->allocated < num_params)
+		return FALSE;
+	for (i = 0; i < num_params; i++)
+	{
+		if (SQL_PARAM_INPUT != ipdopts->parameters[i].paramType)
+			return FALSE;
+	}
+	if (has_data_at_exec_rows(stmt, start_row, end_row, num_params))
+		return FALSE;
+	return build_copy_in_query(SC_get_conn(stmt), stmt->statement, num_params, copyq);
+}
+
 /*	Execute a prepared SQL statement */
 RETCODE		SQL_API
 PGAPI_Execute(HSTMT hstmt, UWORD flag)
@@ -933,6 +1241,7 @@ PGAPI_Execute(HSTMT hstmt, UWORD flag)
 	SQLLEN		i, start_row, end_row;
 	BOOL	exec_end = FALSE, recycled = FALSE, recycle = TRUE;
 	SQLSMALLINT	num_params;
+	PQExpBufferData	copyq = {0};
 
 	MYLOG(0, "entering...%x\n", flag);
 
@@ -1024,17 +1333,27 @@ PGAPI_Execute(HSTMT hstmt, UWORD flag)
 		   parameters even in case of non-prepared statements.
 		 */
 		int	nCallParse = doNothing;
-		BOOL	maybeBatch = FALSE;
+		BOOL	maybeBatch = FALSE, maybePipeline = FALSE, useCopy;
 
-		if (end_row > start_row &&
+		useCopy = can_copy_in_rows(stmt, start_row, end_row, num_params, &copyq);
+		if (useCopy)
+			;	/* no need to prepare the INSERT statement */
+		else if (end_row > start_row &&
 		    SQL_CURSOR_FORWARD_ONLY == stmt->options.cursor_type &&
 		    SQL_CONCUR_READ_ONLY == stmt->options.scroll_concurrency &&
 		    stmt->batch_size > 1)
 			maybeBatch = TRUE;
-MYLOG(0, "prepare=%d prepared=%d  batch_size=%d start_row=" FORMAT_LEN "end_row=" FORMAT_LEN " => maybeBatch=%d\n", stmt->prepare, stmt->prepared, stmt->batch_size, start_row, end_row, maybeBatch);
-		if (NOT_YET_PREPARED == stmt->prepared)
+#ifdef	HAVE_PQENTERPIPELINEMODE
+		if (maybeBatch &&
+		    conn->connInfo.use_pipeline &&
+		    stmt->use_server_side_prepare &&
+		    !has_data_at_exec_rows(stmt, start_row, end_row, num_params))
+			maybePipeline = TRUE;
+#endif /* HAVE_PQENTERPIPELINEMODE */
+MYLOG(0, "prepare=%d prepared=%d  batch_size=%d start_row=" FORMAT_LEN "end_row=" FORMAT_LEN " => maybeBatch=%d maybePipeline=%d useCopy=%d\n", stmt->prepare, stmt->prepared, stmt->batch_size, start_row, end_row, maybeBatch, maybePipeline, useCopy);
+		if (NOT_YET_PREPARED == stmt->prepared && !useCopy)
 		{
-			if (maybeBatch)
+			if (maybeBatch && !maybePipeline)
 				stmt->use_server_side_prepare = 0;
 			switch (nCallParse = HowToPrepareBeforeExec(stmt, TRUE))
 			{
@@ -1051,7 +1370,10 @@ MYLOG(0, "prepareParameters was %s called, prepare state:%d\n", shouldParse == n
 		{
 			SC_set_Result(stmt, NULL);
 		}
-		if (0 != (PREPARE_BY_THE_DRIVER & stmt->prepare) &&
+		if (maybePipeline &&
+		    PREPARE_BY_THE_DRIVER != SC_get_prepare_method(stmt))
+			stmt->exec_type = PIPELINE_EXEC;
+		else if (0 != (PREPARE_BY_THE_DRIVER & stmt->prepare) &&
 		    maybeBatch)
 			stmt->exec_type = DEFFERED_EXEC;
 		else
@@ -1076,6 +1398,46 @@ MYLOG(0, "prepare=%d maybeBatch=%d exec_type=%d\n", stmt->prepare, maybeBatch, s
 		    PG_VERSION_LT(conn, 8.4) &&
 		    SC_can_parse_statement(stmt))
 			parse_sqlsvr(stmt);
+		if (useCopy)
+		{
+			SQLLEN	nrows;
+			SQLUSMALLINT	pstatus;
+			QResultClass	*res;
+
+			/*
+			 * The rows are inserted all or nothing by one COPY,
+			 * so they share the status of the COPY.
+			 */
+			retval = SC_execute_copy_in(stmt, copyq.data, start_row, end_row, &nrows);
+			switch (retval)
+			{
+				case SQL_SUCCESS:
+					pstatus = SQL_PARAM_SUCCESS;
+					break;
+				case SQL_SUCCESS_WITH_INFO:
+					pstatus = SQL_PARAM_SUCCESS_WITH_INFO;
+					break;
+				default:
+					pstatus = SQL_PARAM_ERROR;
+					break;
+			}
+			if (ipdopts->param_status_ptr)
+			{
+				for (i = start_row; i <= end_row; i++)
+				{
+					if (NULL == apdopts->param_operation_ptr ||
+					    SQL_PARAM_IGNORE != apdopts->param_operation_ptr[i])
+						ipdopts->param_status_ptr[i] = pstatus;
+				}
+			}
+			if (ipdopts->param_processed_ptr)
+				*ipdopts->param_processed_ptr = nrows;
+			if (res = SC_get_Result(stmt), NULL != res)
+				stmt->diag_row_count = res->recent_processed_row_count;
+			stmt->has_notice = 0;
+			stmt->exec_current_row = -1;
+			goto cleanup;
+		}
 	}
 
 next_param_row:
@@ -1188,6 +1550,8 @@ cleanup:
 MYLOG(0, "leaving retval=%d\n", retval);
 	SC_setInsertedTable(stmt, retval);
 #undef	return
+	if (copyq.data)
+		termPQExpBuffer(&copyq);
 	if (SQL_SUCCESS == retval &&
 	    STMT_OK > SC_get_errornumber(stmt))
 		retval = SQL_SUCCESS_WITH_INFO;
@@ -1289,8 +1653,9 @@ PGAPI_Cancel(HSTMT hstmt)		/* Statement to cancel. */
 	 * 1. In the middle of SQLParamData / SQLPutData
 	 *    -> cancel the statement
 	 *
-	 * 2. Running a query asynchronously. (asynchronous mode is not supported
-	 *    by psqlODBC)
+	 * 2. Running a query asynchronously.
+	 *    -> Send a query cancel request to the server, the application
+	 *       gets the error of the query when it calls the function again
 	 *
 	 * 3. Busy running a function in another thread.
 	 *    -> Send a query cancel request to the server
@@ -1322,7 +1687,8 @@ PGAPI_Cancel(HSTMT hstmt)		/* Statement to cancel. */
 		LEAVE_STMT_CS(stmt);
 		return ret;
 	}
-	else if (estmt->status == STMT_EXECUTING)
+	else if (estmt->status == STMT_EXECUTING ||
+		 CC_is_async_executing(conn, estmt))
 	{
 		/*
 		 * Busy executing in a different thread. Send a cancel request to
@@ -1396,6 +1762,64 @@ PGAPI_NativeSql(HDBC hdbc,
 }
 
 
+#define	LO_WRITE_BUFFER_SIZE	(1024 * 1024)	/* coalesce SQLPutData data
+												 * into lowrite calls of
+												 * this size */
+#define	PUTDATA_MAX_PREALLOC	(4 * 1024 * 1024)	/* allocate at most this
+												 * size for the length told
+												 * by SQL_LEN_DATA_AT_EXEC */
+
+/*
+ *	Write the SQLPutData data kept in lobj_wbuf to the large object.
+ */
+static BOOL
+flush_lo_write(StatementClass *estmt, ConnectionClass *conn)
+{
+	Int4	wrote;
+
+	if (estmt->lobj_wbufused <= 0)
+		return TRUE;
+	wrote = odbc_lo_write(conn, estmt->lobj_fd, estmt->lobj_wbuf, estmt->lobj_wbufused);
+	MYLOG(0, "lo_write: %d bytes, wrote %d bytes\n", estmt->lobj_wbufused, wrote);
+	if (wrote != estmt->lobj_wbufused)
+		return FALSE;
+	estmt->lobj_wbufused = 0;
+	return TRUE;
+}
+
+/*
+ *	Write SQLPutData data to the large object.  Small pieces are
+ *	collected in lobj_wbuf so that they cost one round trip per
+ *	LO_WRITE_BUFFER_SIZE bytes instead of one per SQLPutData call.
+ */
+static BOOL
+put_lo_data(StatementClass *estmt, ConnectionClass *conn, const char *putbuf, SQLLEN putlen)
+{
+	Int4	wrote;
+
+	if (putlen <= 0)
+		return TRUE;
+	if (estmt->lobj_wbufused + putlen > LO_WRITE_BUFFER_SIZE)
+	{
+		if (!flush_lo_write(estmt, conn))
+			return FALSE;
+		if (putlen >= LO_WRITE_BUFFER_SIZE)
+		{
+			/* large enough to be written as it is */
+			wrote = odbc_lo_write(conn, estmt->lobj_fd, (char *) putbuf, (Int4) putlen);
+			MYLOG(0, "lo_write: cbValue=" FORMAT_LEN ", wrote %d bytes\n", putlen, wrote);
+			return wrote == putlen;
+		}
+	}
+	if (!estmt->lobj_wbuf &&
+		!(estmt->lobj_wbuf = malloc(LO_WRITE_BUFFER_SIZE)))
+		return FALSE;
+	memcpy(estmt->lobj_wbuf + estmt->lobj_wbufused, putbuf, putlen);
+	estmt->lobj_wbufused += (Int4) putlen;
+	return TRUE;
+}
+
+
 /*
  *	Supplies parameter data at execution time.
  *	Used in conjuction with SQLPutData.
@@ -1445,6 +1869,14 @@ PGAPI_ParamData(HSTMT hstmt,
 	/* close the large object */
 	if (estmt->lobj_fd >= 0)
 	{
+		if (!flush_lo_write(estmt, conn))
+		{
+			odbc_lo_close(conn, estmt->lobj_fd);
+			estmt->lobj_fd = -1;
+			SC_set_error(stmt, STMT_EXEC_ERROR, "Couldnt write to large object.", func);
+			retval = SQL_ERROR;
+			goto cleanup;
+		}
 		odbc_lo_close(conn, estmt->lobj_fd);
 
 		/* commit transaction if needed */
@@ -1559,7 +1991,7 @@ PGAPI_PutData(HSTMT hstmt,
 	PutDataClass	*current_pdata;
 	char	   *putbuf, *allocbuf = NULL;
 	Int2		ctype;
-	SQLLEN		putlen;
+	SQLLEN		putlen, totallen;
 	BOOL		lenset = FALSE, handling_lo = FALSE;
 
 	MYLOG(0, "entering...\n");
@@ -1702,18 +2134,54 @@ PGAPI_PutData(HSTMT hstmt,
 				goto cleanup;
 			}
 
-			retval = odbc_lo_write(conn, estmt->lobj_fd, putbuf, (Int4) putlen);
-			MYLOG(0, "lo_write: cbValue=" FORMAT_LEN ", wrote %d bytes\n", putlen, retval);
+			estmt->lobj_wbufused = 0;
+			if (!put_lo_data(estmt, conn, putbuf, putlen))
+			{
+				SC_set_error(stmt, STMT_EXEC_ERROR, "Couldnt write to large object.", func);
+				retval = SQL_ERROR;
+				goto cleanup;
+			}
 		}
 		else
 		{
-			current_pdata->EXEC_buffer = malloc(putlen + 1);
+			/*
+			 * Allocate the whole length at once if the application
+			 * told it by SQL_LEN_DATA_AT_EXEC(length). The length is
+			 * only a hint (SQL_NEED_LONG_DATA_LEN is "N"), so at most
+			 * PUTDATA_MAX_PREALLOC bytes are allocated in advance.
+			 */
+			totallen = 0;
+			if (current_param->used)
+			{
+				SQLULEN	offset = apdopts->param_offset_ptr ? *apdopts->param_offset_ptr : 0;
+				SQLLEN	current_row = estmt->exec_current_row < 0 ? 0 : estmt->exec_current_row;
+				SQLLEN	*pcVal;
+
+				if (apdopts->param_bind_type > 0)
+					pcVal = LENADDR_SHIFT(current_param->used, offset + apdopts->param_bind_type * current_row);
+				else
+					pcVal = LENADDR_SHIFT(current_param->used, offset) + current_row;
+				if (*pcVal <= SQL_LEN_DATA_AT_EXEC_OFFSET)
+					totallen = SQL_LEN_DATA_AT_EXEC_OFFSET - *pcVal;
+			}
+			if (totallen > PUTDATA_MAX_PREALLOC)
+				totallen = PUTDATA_MAX_PREALLOC;
+			if (totallen < putlen)
+				totallen = putlen;
+			current_pdata->EXEC_buffer = malloc(totallen + 1);
+			if (!current_pdata->EXEC_buffer && totallen > putlen)
+			{
+				/* grow the buffer piece by piece instead */
+				totallen = putlen;
+				current_pdata->EXEC_buffer = malloc(totallen + 1);
+			}
 			if (!current_pdata->EXEC_buffer)
 			{
 				SC_set_error(stmt, STMT_NO_MEMORY_ERROR, "Out of memory in PGAPI_PutData (2)", func);
 				retval = SQL_ERROR;
 				goto cleanup;
 			}
+			current_pdata->EXEC_buflen = totallen + 1;
 			memcpy(current_pdata->EXEC_buffer, putbuf, putlen);
 			current_pdata->EXEC_buffer[putlen] = '\0';
 		}
@@ -1726,9 +2194,12 @@ PGAPI_PutData(HSTMT hstmt,
 		/* if (current_iparam->SQLType == SQL_LONGVARBINARY) */
 		if (handling_lo)
 		{
-			/* the large object fd is in EXEC_buffer */
-			retval = odbc_lo_write(conn, estmt->lobj_fd, putbuf, (Int4) putlen);
-			MYLOG(0, "lo_write(2): cbValue = " FORMAT_LEN ", wrote %d bytes\n", putlen, retval);
+			if (!put_lo_data(estmt, conn, putbuf, putlen))
+			{
+				SC_set_error(stmt, STMT_EXEC_ERROR, "Couldnt write to large object.", func);
+				retval = SQL_ERROR;
+				goto cleanup;
+			}
 
 			*current_pdata->EXEC_used += putlen;
 		}
@@ -1739,18 +2210,22 @@ PGAPI_PutData(HSTMT hstmt,
 			{
 				SQLLEN	used = *current_pdata->EXEC_used + putlen;
 				SQLLEN allocsize;
-				char *buffer;
+				char *buffer = current_pdata->EXEC_buffer;
 
-				for (allocsize = (1 << 4); allocsize <= used; allocsize <<= 1) ;
 				MYLOG(0, "        cbValue = " FORMAT_LEN ", old_pos = " FORMAT_LEN ", *used = " FORMAT_LEN "\n", putlen, old_pos, used);
-
-				/* dont lose the old pointer in case out of memory */
-				buffer = realloc(current_pdata->EXEC_buffer, allocsize);
-				if (!buffer)
+				if (used >= current_pdata->EXEC_buflen)
 				{
-					SC_set_error(stmt, STMT_NO_MEMORY_ERROR,"Out of memory in PGAPI_PutData (3)", func);
-					retval = SQL_ERROR;
-					goto cleanup;
+					for (allocsize = (1 << 4); allocsize <= used; allocsize <<= 1) ;
+
+					/* dont lose the old pointer in case out of memory */
+					buffer = realloc(current_pdata->EXEC_buffer, allocsize);
+					if (!buffer)
+					{
+						SC_set_error(stmt, STMT_NO_MEMORY_ERROR,"Out of memory in PGAPI_PutData (3)", func);
+						retval = SQL_ERROR;
+						goto cleanup;
+					}
+					current_pdata->EXEC_buflen = allocsize;
 				}
 
 				memcpy(&buffer[old_pos], putbuf, putlen);
@@ -813,8 +813,14 @@ MYLOG(0, "CONVERT_FUNCTIONS=" FORMAT_ULEN "\n", value);
 			break;
 		case SQL_ASYNC_MODE:
 			len = 4;
-			value = SQL_AM_NONE;
+			value = SQL_AM_STATEMENT;
 			break;
+#ifdef	USE_ASYNC_NOTIFICATION
+		case SQL_ASYNC_NOTIFICATION:
+			len = 4;
+			value = SQL_ASYNC_NOTIFICATION_CAPABLE;
+			break;
+#endif /* USE_ASYNC_NOTIFICATION */
 		case SQL_BATCH_ROW_COUNT:
 			len = 4;
 			value = SQL_BRC_EXPLICIT;
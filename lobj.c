@@ -15,6 +15,7 @@
 #include "lobj.h"
 
 #include "connection.h"
+#include "misc.h"
 
 
 OID
@@ -225,3 +226,85 @@ odbc_lo_tell64(ConnectionClass *conn, int fd)
 	else
 		return retval;
 }
+
+
+/*
+ * Open a large object and get its size in one round trip.
+ */
+int
+odbc_lo_open_size(ConnectionClass *conn, int lobjId, int mode, Int8 *size)
+{
+	char		query[128];
+	LO_ARG		argv[2], results[2];
+	BOOL		lseek64 = !PG_VERSION_LT(conn, 9.3);
+
+	SPRINTF_FIXED(query, "SELECT fd, pg_catalog.%s(fd, 0, %d) FROM pg_catalog.lo_open($1, $2) fd", lseek64 ? "lo_lseek64" : "lo_lseek", SEEK_END);
+
+	argv[0].isint = 1;
+	argv[0].len = 4;
+	argv[0].u.integer = lobjId;
+
+	argv[1].isint = 1;
+	argv[1].len = 4;
+	argv[1].u.integer = mode;
+
+	results[0].isint = 1;
+	results[0].len = 4;
+	results[1].isint = 2;
+	results[1].len = 8;
+
+	if (!CC_send_function_query(conn, query, argv, 2, results, 2))
+		return -1;
+
+	*size = results[1].u.integer64;
+	return results[0].u.integer;
+}
+
+
+/*
+ * Read len bytes at the offset of a large object in one round trip,
+ * whatever the current position of fd is.
+ */
+Int4
+odbc_lo_pread(ConnectionClass *conn, int fd, Int8 offset, char *buf, Int4 len)
+{
+	char		query[128];
+	LO_ARG		argv[3], results[1];
+
+	argv[0].isint = 1;
+	argv[0].len = 4;
+	argv[0].u.integer = fd;
+
+	argv[1].isint = 1;
+	argv[1].len = 4;
+	argv[1].u.integer = len;
+
+	if (PG_VERSION_LT(conn, 9.3))
+	{
+		argv[2].isint = 1;
+		argv[2].len = 4;
+		argv[2].u.integer = (Int4) offset;
+		if (offset != (Int8) argv[2].u.integer)
+		{
+			CC_set_error(conn, CONN_VALUE_OUT_OF_RANGE, "large object lseek64 is unavailable for the server", __FUNCTION__);
+			return -1;
+		}
+	}
+	else
+	{
+		argv[2].isint = 2;
+		argv[2].len = sizeof(offset);
+		argv[2].u.integer64 = offset;
+	}
+	/* the function in FROM positions fd before loread() is called */
+	SPRINTF_FIXED(query, "SELECT pg_catalog.loread($1, $2) FROM pg_catalog.%s($1, $3, %d) pos", argv[2].isint == 2 ? "lo_lseek64" : "lo_lseek", SEEK_SET);
+
+	results[0].isint = 0;
+	results[0].len = len;
+	results[0].u.ptr = buf;
+
+	if (!CC_send_function_query(conn, query, argv, 3, results, 1))
+		return -1;
+
+	return results[0].len;
+}
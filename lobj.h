@@ -37,4 +37,6 @@ Int4		odbc_lo_tell(ConnectionClass *conn, int fd);
 
 Int8		odbc_lo_lseek64(ConnectionClass *conn, int fd, Int8 offset, Int4 len);
 Int8		odbc_lo_tell64(ConnectionClass *conn, int fd);
+int		odbc_lo_open_size(ConnectionClass *conn, int lobjId, int mode, Int8 *size);
+Int4		odbc_lo_pread(ConnectionClass *conn, int fd, Int8 offset, char *buf, Int4 len);
 #endif
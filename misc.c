@@ -20,6 +20,13 @@
 #include <string.h>
 #include <ctype.h>
 #include <time.h>
+#ifdef	USE_AVX2
+#ifdef	_MSC_VER
+#include <intrin.h>
+#else
+#include <immintrin.h>
+#endif /* _MSC_VER */
+#endif /* USE_AVX2 */
 
 #ifndef WIN32
 #include <pwd.h>
@@ -151,6 +158,72 @@ my_trim(char *s)
 	return s;
 }
 
+/*
+ * get_clock_usec returns a monotonic clock in microseconds.
+ * It's used to measure the elapsed time.
+ */
+SQLBIGINT
+get_clock_usec(void)
+{
+#ifdef	WIN32
+	static LARGE_INTEGER	freq = {0};
+	LARGE_INTEGER	count;
+
+	if (0 == freq.QuadPart)
+		QueryPerformanceFrequency(&freq);
+	QueryPerformanceCounter(&count);
+	return (count.QuadPart / freq.QuadPart) * 1000000 +
+		(count.QuadPart % freq.QuadPart) * 1000000 / freq.QuadPart;
+#else
+	struct timespec	ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (SQLBIGINT) ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+#endif /* WIN32 */
+}
+
+/*
+ * hash_bytes returns the 32-bit FNV-1a hash value of the data.
+ * It's used to look up the caches of the connection.
+ */
+UInt4
+hash_bytes(const void *data, size_t len)
+{
+	const UCHAR	*p = (const UCHAR *) data;
+	UInt4	hval = 2166136261U;
+
+	for (; len > 0; len--, p++)
+	{
+		hval ^= *p;
+		hval *= 16777619U;
+	}
+	return hval;
+}
+
+/*
+ * hash_names_icase returns the hash value of the pair of schema and table
+ * names, case insensitively as stricmp() compares them.
+ */
+UInt4
+hash_names_icase(const char *schema_name, const char *table_name)
+{
+	const UCHAR	*p;
+	UInt4	hval = 2166136261U;
+
+	for (p = (const UCHAR *) schema_name; *p; p++)
+	{
+		hval ^= tolower(*p);
+		hval *= 16777619U;
+	}
+	hval *= 16777619U;	/* the separator */
+	for (p = (const UCHAR *) table_name; *p; p++)
+	{
+		hval ^= tolower(*p);
+		hval *= 16777619U;
+	}
+	return hval;
+}
+
 /*
  * snprintfcat is a extension to snprintf
  * It add format to buf at given pos
@@ -312,3 +385,42 @@ quote_table(const pgNAME schema, const pgNAME table, char *buf, int buf_size)
 
 	return buf;
 }
+
+#ifdef	USE_SSE2
+static int simd_level = -1;
+
+/*
+ * The SIMD level the CPU supports, 1: SSE2, 2: AVX2.
+ */
+int
+get_simd_level(void)
+{
+	if (simd_level < 0)
+	{
+		int	level = 1;
+#if defined(USE_AVX2)
+#ifdef	_MSC_VER
+		int	info[4];
+
+		__cpuid(info, 1);
+		/* OSXSAVE and AVX, then the OS must save the YMM registers */
+		if ((info[2] & (1 << 27)) != 0 &&
+		    (info[2] & (1 << 28)) != 0 &&
+		    (_xgetbv(0) & 6) == 6)
+		{
+			__cpuidex(info, 7, 0);
+			if ((info[1] & (1 << 5)) != 0)
+				level = 2;
+		}
+#else
+		__builtin_cpu_init();
+		if (__builtin_cpu_supports("avx2"))
+			level = 2;
+#endif /* _MSC_VER */
+#endif /* USE_AVX2 */
+		MYLOG(0, "simd level=%d\n", level);
+		simd_level = level;
+	}
+	return simd_level;
+}
+#endif /* USE_SSE2 */
@@ -32,6 +32,23 @@ char *quote_table(const pgNAME schema, const pgNAME table, char *buf, int nuf_si
 
 #define	GET_SCHEMA_NAME(nspname) 	(nspname)
 
+/*
+ * SIMD kernels on x86: SSE2 is the baseline on x86-64, AVX2 is used
+ * only if get_simd_level() finds that the CPU supports it.
+ */
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define	USE_SSE2
+#if defined(_MSC_VER) || ((defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__)))
+#define	USE_AVX2
+#ifdef	_MSC_VER
+#define	AVX2_TARGET
+#else
+#define	AVX2_TARGET	__attribute__((target("avx2")))
+#endif /* _MSC_VER */
+#endif
+int	get_simd_level(void);
+#endif /* USE_SSE2 */
+
 /* defines for return value of my_strcpy */
 #define STRCPY_SUCCESS		1
 #define STRCPY_FAIL			0
@@ -39,6 +56,9 @@ char *quote_table(const pgNAME schema, const pgNAME table, char *buf, int nuf_si
 #define STRCPY_NULL			(-2)
 
 ssize_t			my_strcpy(char *dst, ssize_t dst_len, const char *src, ssize_t src_len);
+SQLBIGINT	get_clock_usec(void);
+UInt4		hash_bytes(const void *data, size_t len);
+UInt4		hash_names_icase(const char *schema_name, const char *table_name);
 
 /*
  *	Macros to safely strcpy, strcat or sprintf to fixed arrays.
@@ -209,6 +209,436 @@ static int	mylog_on = 0, qlog_on = 0;
 #define QLOGDIR				"c:"
 #endif /* WIN32 */
 
+/*
+ *	Log buffer
+ *
+ *	When LogBufferSize > 0 (it's 0 by default), mylog and qlog don't write
+ *	to the log files directly. Each thread formats its lines on its own stack and copies
+ *	them into a ring buffer of fixed size slots without taking any lock.
+ *	A background writer thread drains the ring buffers to the log files
+ *	in large blocks. When a ring buffer is full the lines are dropped and
+ *	the number of dropped lines is written to the log file later.
+ *
+ *	The ring buffer is a bounded MPSC queue. Each slot has a sequence
+ *	number which tells whether it is free (seq == pos), published
+ *	(seq == pos + 1) or still drained from the previous lap. A line longer
+ *	than a slot occupies consecutive slots reserved at once.
+ */
+#if defined(__GNUC__)
+#define	LOGBUF_ATOMIC_LOAD(p)		__atomic_load_n(p, __ATOMIC_ACQUIRE)
+#define	LOGBUF_ATOMIC_STORE(p, v)	__atomic_store_n(p, v, __ATOMIC_RELEASE)
+#define	LOGBUF_ATOMIC_CAS(p, e, d)	__atomic_compare_exchange_n(p, &(e), d, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)
+#define	LOGBUF_ATOMIC_INC(p)		__atomic_add_fetch(p, 1, __ATOMIC_RELAXED)
+#elif defined(_MSC_VER)
+#define	LOGBUF_ATOMIC_LOAD(p)		((unsigned int) InterlockedCompareExchange((volatile LONG *) (p), 0, 0))
+#define	LOGBUF_ATOMIC_STORE(p, v)	InterlockedExchange((volatile LONG *) (p), (LONG) (v))
+#define	LOGBUF_ATOMIC_CAS(p, e, d)	((LONG) (e) == InterlockedCompareExchange((volatile LONG *) (p), (LONG) (d), (LONG) (e)))
+#define	LOGBUF_ATOMIC_INC(p)		InterlockedIncrement((volatile LONG *) (p))
+#endif /* __GNUC__ */
+
+#if defined(LOGBUF_ATOMIC_CAS) && (defined(WIN_MULTITHREAD_SUPPORT) || defined(POSIX_MULTITHREAD_SUPPORT))
+#define	USE_LOG_BUFFER
+#endif
+
+#ifdef	USE_LOG_BUFFER
+#ifndef	va_copy
+#define	va_copy(dst, src)	((dst) = (src))
+#endif /* va_copy */
+
+#define	LOGBUF_SLOT_SIZE	256
+#define	LOGBUF_LINE_LEN		4096	/* formatted on the stack up to this */
+#define	LOGBUF_BLOCK_SIZE	65536	/* written to the file at once */
+#define	LOGBUF_FLUSH_INTERVAL	100	/* msec */
+
+typedef struct
+{
+	volatile unsigned int	seq;
+	unsigned int	len;
+	char		data[LOGBUF_SLOT_SIZE - 2 * sizeof(unsigned int)];
+} LogSlot;
+
+typedef struct
+{
+	LogSlot		*slots;
+	unsigned int	mask;	/* the number of slots - 1 */
+	volatile unsigned int	head;	/* the next slot to reserve */
+	volatile unsigned int	tail;	/* the next slot to drain */
+	volatile unsigned int	dropped;	/* the number of dropped lines */
+	unsigned int	reported;	/* dropped lines already reported */
+} LogRing;
+
+enum {
+	LOGBUF_OFF = 0
+	,LOGBUF_STARTING
+	,LOGBUF_RUNNING
+	,LOGBUF_DISABLED
+};
+
+static int	logbuf_size = DEFAULT_LOGBUFFERSIZE;	/* KB */
+static volatile unsigned int	logbuf_state = LOGBUF_OFF;
+static volatile unsigned int	logbuf_stop = 0;
+static LogRing	mylog_ring, qlog_ring;
+#if defined(WIN_MULTITHREAD_SUPPORT)
+static HANDLE	logbuf_thread = NULL, logbuf_event = NULL;
+#define	LOGBUF_WAKEUP	SetEvent(logbuf_event)
+#elif defined(POSIX_MULTITHREAD_SUPPORT)
+static pthread_t	logbuf_thread;
+static pthread_mutex_t	logbuf_mutex;
+static pthread_cond_t	logbuf_cond;
+#define	LOGBUF_WAKEUP	pthread_cond_signal(&logbuf_cond)
+#endif /* WIN_MULTITHREAD_SUPPORT */
+
+static BOOL
+logring_init(LogRing *ring, size_t size)
+{
+	unsigned int	i, nslots;
+
+	/* the number of slots must be a power of 2 */
+	for (nslots = 16; (size_t) nslots * 2 * LOGBUF_SLOT_SIZE <= size; nslots *= 2)
+		;
+	if (ring->slots = malloc(sizeof(LogSlot) * nslots), NULL == ring->slots)
+		return FALSE;
+	for (i = 0; i < nslots; i++)
+		ring->slots[i].seq = i;
+	ring->mask = nslots - 1;
+	ring->head = ring->tail = 0;
+	ring->dropped = ring->reported = 0;
+
+	return TRUE;
+}
+
+static void
+logring_free(LogRing *ring)
+{
+	if (ring->slots)
+	{
+		free(ring->slots);
+		ring->slots = NULL;
+	}
+}
+
+/*
+ *	Copy a line into the ring buffer. Returns FALSE if there's no room.
+ */
+static BOOL
+logring_put(LogRing *ring, const char *line, size_t len)
+{
+	unsigned int	nslots, pos, last, seq, i;
+	int		diff;
+	size_t		cpylen;
+	LogSlot		*slot;
+
+	nslots = (unsigned int) ((len + sizeof(slot->data) - 1) / sizeof(slot->data));
+	if (0 == nslots)
+		return TRUE;
+	if (nslots > (ring->mask + 1) / 2)
+		nslots = (ring->mask + 1) / 2; /* truncate a too long line */
+	for (;;)
+	{
+		pos = LOGBUF_ATOMIC_LOAD(&ring->head);
+		last = pos + nslots - 1;
+		/*
+		 * The slots are drained in order, so the whole range is free
+		 * if the last slot is.
+		 */
+		seq = LOGBUF_ATOMIC_LOAD(&ring->slots[last & ring->mask].seq);
+		diff = (int) (seq - last);
+		if (0 == diff)
+		{
+			if (LOGBUF_ATOMIC_CAS(&ring->head, pos, pos + nslots))
+				break;
+		}
+		else if (diff < 0)	/* full */
+		{
+			LOGBUF_ATOMIC_INC(&ring->dropped);
+			LOGBUF_WAKEUP;
+			return FALSE;
+		}
+	}
+	for (i = 0; i < nslots; i++)
+	{
+		slot = ring->slots + ((pos + i) & ring->mask);
+		cpylen = len < sizeof(slot->data) ? len : sizeof(slot->data);
+		memcpy(slot->data, line, cpylen);
+		slot->len = (unsigned int) cpylen;
+		line += cpylen;
+		len -= cpylen;
+		LOGBUF_ATOMIC_STORE(&slot->seq, pos + i + 1);
+	}
+	/* wake up the writer early if the ring buffer is getting full */
+	if (pos + nslots - LOGBUF_ATOMIC_LOAD(&ring->tail) > (ring->mask + 1) / 2)
+		LOGBUF_WAKEUP;
+
+	return TRUE;
+}
+
+/*
+ *	Write the published lines in the ring buffer to fp (or discard them
+ *	if fp is NULL). The caller must hold the critical section of the log.
+ */
+static void
+logring_drain(LogRing *ring, FILE *fp)
+{
+	char		block[LOGBUF_BLOCK_SIZE];
+	size_t		blen = 0;
+	unsigned int	pos = ring->tail, dropped;
+	LogSlot		*slot;
+
+	for (;; pos++)
+	{
+		slot = ring->slots + (pos & ring->mask);
+		if ((int) (LOGBUF_ATOMIC_LOAD(&slot->seq) - (pos + 1)) < 0)
+			break;	/* not published yet */
+		if (blen + slot->len > sizeof(block))
+		{
+			if (fp)
+				fwrite(block, 1, blen, fp);
+			blen = 0;
+		}
+		memcpy(block + blen, slot->data, slot->len);
+		blen += slot->len;
+		LOGBUF_ATOMIC_STORE(&slot->seq, pos + ring->mask + 1);
+		LOGBUF_ATOMIC_STORE(&ring->tail, pos + 1);
+	}
+	if (!fp)
+		return;
+	if (blen > 0)
+		fwrite(block, 1, blen, fp);
+	dropped = LOGBUF_ATOMIC_LOAD(&ring->dropped);
+	if (dropped != ring->reported)
+	{
+		fprintf(fp, "*** %u log lines dropped because the log buffer was full ***\n", dropped - ring->reported);
+		ring->reported = dropped;
+		blen++;
+	}
+	if (blen > 0)
+		fflush(fp);
+}
+
+/*
+ *	Format a line on the stack and put it into the ring buffer.
+ */
+static void
+logring_vprintf(LogRing *ring, const char *prefix, const char *fmt, va_list args)
+{
+	char		localbuf[LOGBUF_LINE_LEN], *line = localbuf;
+	size_t		plen = strlen(prefix), size;
+	int		len;
+	va_list		cargs;
+
+	memcpy(localbuf, prefix, plen);
+	va_copy(cargs, args);
+	len = vsnprintf(localbuf + plen, sizeof(localbuf) - plen, fmt, cargs);
+	va_end(cargs);
+	if (len < 0 || plen + len >= sizeof(localbuf))
+	{
+		size = len < 0 ? sizeof(localbuf) * 4 : plen + len + 1;
+		if (line = malloc(size), NULL != line)
+		{
+			memcpy(line, prefix, plen);
+			len = vsnprintf(line + plen, size - plen, fmt, args);
+		}
+		if (NULL == line || len < 0 || plen + len >= size)
+		{
+			/* truncate */
+			if (line)
+				free(line);
+			line = localbuf;
+			len = (int) (sizeof(localbuf) - plen - 1);
+		}
+	}
+	logring_put(ring, line, plen + len);
+	if (line != localbuf)
+		free(line);
+}
+
+static FILE *MLOGFP, *QLOGFP;
+static void MLOG_open();
+static void QLOG_open();
+
+/*
+ *	Drain the ring buffers. The log files are opened only when the log
+ *	is enabled and the lines of a disabled log are discarded.
+ */
+static void
+logbuf_drain_all(void)
+{
+	ENTER_MYLOG_CS;
+	if (!MLOGFP && mylog_on > 0)
+	{
+		MLOG_open();
+		if (!MLOGFP)
+			mylog_on = 0;
+	}
+	logring_drain(&mylog_ring, MLOGFP);
+	LEAVE_MYLOG_CS;
+	ENTER_QLOG_CS;
+	if (!QLOGFP && qlog_on > 0)
+	{
+		QLOG_open();
+		if (!QLOGFP)
+			qlog_on = 0;
+	}
+	logring_drain(&qlog_ring, QLOGFP);
+	LEAVE_QLOG_CS;
+}
+
+#if defined(WIN_MULTITHREAD_SUPPORT)
+static unsigned __stdcall
+logbuf_writer(void *arg)
+{
+	for (;;)
+	{
+		WaitForSingleObject(logbuf_event, LOGBUF_FLUSH_INTERVAL);
+		if (LOGBUF_ATOMIC_LOAD(&logbuf_stop))
+			break;
+		logbuf_drain_all();
+	}
+	return 0;
+}
+#elif defined(POSIX_MULTITHREAD_SUPPORT)
+static void *
+logbuf_writer(void *arg)
+{
+	struct timespec	ts;
+
+	for (;;)
+	{
+		clock_gettime(CLOCK_REALTIME, &ts);
+		ts.tv_nsec += LOGBUF_FLUSH_INTERVAL * 1000000L;
+		if (ts.tv_nsec >= 1000000000L)
+		{
+			ts.tv_sec++;
+			ts.tv_nsec -= 1000000000L;
+		}
+		pthread_mutex_lock(&logbuf_mutex);
+		if (!LOGBUF_ATOMIC_LOAD(&logbuf_stop))
+			pthread_cond_timedwait(&logbuf_cond, &logbuf_mutex, &ts);
+		pthread_mutex_unlock(&logbuf_mutex);
+		if (LOGBUF_ATOMIC_LOAD(&logbuf_stop))
+			break;
+		logbuf_drain_all();
+	}
+	return NULL;
+}
+
+/*
+ *	A forked child has no writer thread. Hold the log locks across fork()
+ *	so that the child doesn't inherit them locked by the writer thread,
+ *	and let the child write its lines directly.
+ */
+static void
+logbuf_atfork_prepare(void)
+{
+	ENTER_MYLOG_CS;
+	ENTER_QLOG_CS;
+}
+
+static void
+logbuf_atfork_parent(void)
+{
+	LEAVE_QLOG_CS;
+	LEAVE_MYLOG_CS;
+}
+
+static void
+logbuf_atfork_child(void)
+{
+	/* the lines left in the ring buffers are written by the parent */
+	LOGBUF_ATOMIC_STORE(&logbuf_state, LOGBUF_DISABLED);
+	LEAVE_QLOG_CS;
+	LEAVE_MYLOG_CS;
+}
+#endif /* WIN_MULTITHREAD_SUPPORT */
+
+/*
+ *	Start the writer thread at the first log line.
+ *	Returns TRUE if the lines should go to the ring buffers.
+ */
+static BOOL
+logbuf_running(void)
+{
+	unsigned int	state = LOGBUF_ATOMIC_LOAD(&logbuf_state);
+	size_t		size;
+
+	if (LOGBUF_RUNNING == state)
+		return TRUE;
+	if (LOGBUF_OFF != state ||
+	    !LOGBUF_ATOMIC_CAS(&logbuf_state, state, LOGBUF_STARTING))
+		return FALSE;	/* write it directly for now */
+
+	size = (size_t) logbuf_size * 1024;
+	if (!logring_init(&mylog_ring, size) ||
+	    !logring_init(&qlog_ring, size))
+		goto error;
+	logbuf_stop = 0;
+#if defined(WIN_MULTITHREAD_SUPPORT)
+	if (logbuf_event = CreateEvent(NULL, FALSE, FALSE, NULL), NULL == logbuf_event)
+		goto error;
+	if (logbuf_thread = (HANDLE) _beginthreadex(NULL, 0, logbuf_writer, NULL, 0, NULL), NULL == logbuf_thread)
+	{
+		CloseHandle(logbuf_event);
+		logbuf_event = NULL;
+		goto error;
+	}
+#elif defined(POSIX_MULTITHREAD_SUPPORT)
+	pthread_mutex_init(&logbuf_mutex, NULL);
+	pthread_cond_init(&logbuf_cond, NULL);
+	if (0 != pthread_atfork(logbuf_atfork_prepare, logbuf_atfork_parent, logbuf_atfork_child) ||
+	    0 != pthread_create(&logbuf_thread, NULL, logbuf_writer, NULL))
+	{
+		pthread_cond_destroy(&logbuf_cond);
+		pthread_mutex_destroy(&logbuf_mutex);
+		goto error;
+	}
+#endif /* WIN_MULTITHREAD_SUPPORT */
+	LOGBUF_ATOMIC_STORE(&logbuf_state, LOGBUF_RUNNING);
+	return TRUE;
+
+error:
+	logring_free(&mylog_ring);
+	logring_free(&qlog_ring);
+	LOGBUF_ATOMIC_STORE(&logbuf_state, LOGBUF_DISABLED);
+	return FALSE;
+}
+
+/*
+ *	Stop the writer thread and flush the ring buffers.
+ *	Lines put by threads which are still logging may be lost.
+ *	Nothing is done in a forked child, which has no writer thread.
+ */
+static void
+logbuf_finalize(void)
+{
+	if (LOGBUF_RUNNING != LOGBUF_ATOMIC_LOAD(&logbuf_state))
+		return;
+	LOGBUF_ATOMIC_STORE(&logbuf_state, LOGBUF_DISABLED);
+	LOGBUF_ATOMIC_STORE(&logbuf_stop, 1);
+#if defined(WIN_MULTITHREAD_SUPPORT)
+	SetEvent(logbuf_event);
+	/*
+	 * This is called from DllMain with the loader lock held and the
+	 * exiting thread may wait for the lock. Don't wait forever.
+	 */
+	WaitForSingleObject(logbuf_thread, 10 * LOGBUF_FLUSH_INTERVAL);
+	CloseHandle(logbuf_thread);
+	logbuf_thread = NULL;
+	CloseHandle(logbuf_event);
+	logbuf_event = NULL;
+#elif defined(POSIX_MULTITHREAD_SUPPORT)
+	pthread_mutex_lock(&logbuf_mutex);
+	pthread_cond_signal(&logbuf_cond);
+	pthread_mutex_unlock(&logbuf_mutex);
+	pthread_join(logbuf_thread, NULL);
+	pthread_cond_destroy(&logbuf_cond);
+	pthread_mutex_destroy(&logbuf_mutex);
+#endif /* WIN_MULTITHREAD_SUPPORT */
+	logbuf_drain_all();
+	logring_free(&mylog_ring);
+	logring_free(&qlog_ring);
+}
+#endif /* USE_LOG_BUFFER */
+
 
 int	get_mylog(void)
 {
@@ -315,13 +745,37 @@ mylog_misc(unsigned int option, const char *fmt, va_list args)
 	// va_list		args;
 	int		gerrno;
 	BOOL	log_threadid = option;
+	char	prefix[64];
 
 	gerrno = GENERAL_ERRNO;
-	ENTER_MYLOG_CS;
 #ifdef	LOGGING_PROCESS_TIME
 	if (!start_time)
 		start_time = timeGetTime();
 #endif /* LOGGING_PROCESS_TIME */
+	prefix[0] = '\0';
+	if (log_threadid)
+	{
+#ifdef	WIN_MULTITHREAD_SUPPORT
+#ifdef	LOGGING_PROCESS_TIME
+		DWORD	proc_time = timeGetTime() - start_time;
+		SPRINTF_FIXED(prefix, "[%u-%d.%03d]", GetCurrentThreadId(), proc_time / 1000, proc_time % 1000);
+#else
+		SPRINTF_FIXED(prefix, "[%u]", GetCurrentThreadId());
+#endif /* LOGGING_PROCESS_TIME */
+#endif /* WIN_MULTITHREAD_SUPPORT */
+#if defined(POSIX_MULTITHREAD_SUPPORT)
+		SPRINTF_FIXED(prefix, "[%lx]", (unsigned long int) pthread_self());
+#endif /* POSIX_MULTITHREAD_SUPPORT */
+	}
+#ifdef	USE_LOG_BUFFER
+	if (logbuf_running())
+	{
+		logring_vprintf(&mylog_ring, prefix, fmt, args);
+		GENERAL_ERRNO_SET(gerrno);
+		return 1;
+	}
+#endif /* USE_LOG_BUFFER */
+	ENTER_MYLOG_CS;
 	// va_start(args, fmt);
 
 	if (!MLOGFP)
@@ -334,19 +788,7 @@ mylog_misc(unsigned int option, const char *fmt, va_list args)
 	if (MLOGFP)
 	{
 		if (log_threadid)
-		{
-#ifdef	WIN_MULTITHREAD_SUPPORT
-#ifdef	LOGGING_PROCESS_TIME
-		DWORD	proc_time = timeGetTime() - start_time;
-		fprintf(MLOGFP, "[%u-%d.%03d]", GetCurrentThreadId(), proc_time / 1000, proc_time % 1000);
-#else
-		fprintf(MLOGFP, "[%u]", GetCurrentThreadId());
-#endif /* LOGGING_PROCESS_TIME */
-#endif /* WIN_MULTITHREAD_SUPPORT */
-#if defined(POSIX_MULTITHREAD_SUPPORT)
-		fprintf(MLOGFP, "[%lx]", (unsigned long int) pthread_self());
-#endif /* POSIX_MULTITHREAD_SUPPORT */
-		}
+			fputs(prefix, MLOGFP);
 		vfprintf(MLOGFP, fmt, args);
 		fflush(MLOGFP);
 	}
@@ -403,43 +845,62 @@ static void mylog_finalize(void)
 
 static FILE *QLOGFP = NULL;
 
+static void QLOG_open()
+{
+	char		filebuf[80];
+
+	if (QLOGFP) return;
+
+	generate_filename(logdir ? logdir : QLOGDIR, QLOGFILE, filebuf, sizeof(filebuf));
+	QLOGFP = fopen(filebuf, PG_BINARY_A);
+	if (!QLOGFP)
+	{
+		generate_homefile(QLOGFILE, filebuf, sizeof(filebuf));
+		QLOGFP = fopen(filebuf, PG_BINARY_A);
+	}
+}
+
 static int
 qlog_misc(unsigned int option, const char *fmt, va_list args)
 {
-	char		filebuf[80];
 	int		gerrno;
+	char		prefix[32];
 
 	if (!qlog_on)	return 0;
 
 	gerrno = GENERAL_ERRNO;
-	ENTER_QLOG_CS;
 #ifdef	LOGGING_PROCESS_TIME
 	if (!start_time)
 		start_time = timeGetTime();
 #endif /* LOGGING_PROCESS_TIME */
+	prefix[0] = '\0';
+	if (option)
+	{
+#ifdef	LOGGING_PROCESS_TIME
+		DWORD	proc_time = timeGetTime() - start_time;
+		SPRINTF_FIXED(prefix, "[%d.%03d]", proc_time / 1000, proc_time % 1000);
+#endif /* LOGGING_PROCESS_TIME */
+	}
+#ifdef	USE_LOG_BUFFER
+	if (logbuf_running())
+	{
+		logring_vprintf(&qlog_ring, prefix, fmt, args);
+		GENERAL_ERRNO_SET(gerrno);
+		return 1;
+	}
+#endif /* USE_LOG_BUFFER */
+	ENTER_QLOG_CS;
 
 	if (!QLOGFP)
 	{
-		generate_filename(logdir ? logdir : QLOGDIR, QLOGFILE, filebuf, sizeof(filebuf));
-		QLOGFP = fopen(filebuf, PG_BINARY_A);
-		if (!QLOGFP)
-		{
-			generate_homefile(QLOGFILE, filebuf, sizeof(filebuf));
-			QLOGFP = fopen(filebuf, PG_BINARY_A);
-		}
+		QLOG_open();
 		if (!QLOGFP)
 			qlog_on = 0;
 	}
 
 	if (QLOGFP)
 	{
-		if (option)
-		{
-#ifdef	LOGGING_PROCESS_TIME
-		DWORD	proc_time = timeGetTime() - start_time;
-		fprintf(QLOGFP, "[%d.%03d]", proc_time / 1000, proc_time % 1000);
-#endif /* LOGGING_PROCESS_TIME */
-		}
+		fputs(prefix, QLOGFP);
 		vfprintf(QLOGFP, fmt, args);
 		fflush(QLOGFP);
 	}
@@ -585,6 +1046,13 @@ void InitializeLogging(void)
 	getLogDir(dir, sizeof(dir));
 	if (dir[0])
 		logdir = strdup(dir);
+#ifdef	USE_LOG_BUFFER
+	SQLGetPrivateProfileString(DBMS_NAME, INI_LOGBUFFERSIZE, "", dir, sizeof(dir), ODBCINST_INI);
+	if (dir[0])
+		logbuf_size = atoi(dir);
+	if (logbuf_size <= 0)
+		logbuf_state = LOGBUF_DISABLED;
+#endif /* USE_LOG_BUFFER */
 	mylog_initialize();
 	qlog_initialize();
 	start_logging();
@@ -592,6 +1060,9 @@ void InitializeLogging(void)
 
 void FinalizeLogging(void)
 {
+#ifdef	USE_LOG_BUFFER
+	logbuf_finalize();
+#endif /* USE_LOG_BUFFER */
 	mylog_finalize();
 	qlog_finalize();
 	if (logdir)
@@ -316,11 +316,14 @@ SQLExecDirect(HSTMT StatementHandle,
 	flag |= PODBC_WITH_HOLD;
 	if (SC_opencheck(stmt, func))
 		ret = SQL_ERROR;
+	else if (StartAsyncExec(stmt))
+		ret = SQL_STILL_EXECUTING;
 	else
 	{
 		StartRollbackState(stmt);
 		ret = PGAPI_ExecDirect(StatementHandle, StatementText, TextLength, flag);
 		ret = DiscardStatementSvp(stmt, ret, FALSE);
+		ret = EndAsyncExec(stmt, ret);
 	}
 	LEAVE_STMT_CS(stmt);
 	return ret;
@@ -344,12 +347,15 @@ SQLExecute(HSTMT StatementHandle)
 	flag |= PODBC_WITH_HOLD;
 	if (SC_opencheck(stmt, func))
 		ret = SQL_ERROR;
+	else if (StartAsyncExec(stmt))
+		ret = SQL_STILL_EXECUTING;
 	else
 	{
 		StartRollbackState(stmt);
 		stmt->exec_current_row = -1;
 		ret = PGAPI_Execute(StatementHandle, flag);
 		ret = DiscardStatementSvp(stmt, ret, FALSE);
+		ret = EndAsyncExec(stmt, ret);
 	}
 	LEAVE_STMT_CS(stmt);
 	return ret;
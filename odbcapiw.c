@@ -336,13 +336,18 @@ SQLExecDirectW(HSTMT StatementHandle,
 	ENTER_STMT_CS(stmt);
 	SC_clear_error(stmt);
 	flag |= PODBC_WITH_HOLD;
-	StartRollbackState(stmt);
 	if (SC_opencheck(stmt, func))
 		ret = SQL_ERROR;
+	else if (StartAsyncExec(stmt))
+		ret = SQL_STILL_EXECUTING;
 	else
+	{
+		StartRollbackState(stmt);
 		ret = PGAPI_ExecDirect(StatementHandle,
 							   (SQLCHAR *) stxt, (SQLINTEGER) slen, flag);
-	ret = DiscardStatementSvp(stmt, ret, FALSE);
+		ret = DiscardStatementSvp(stmt, ret, FALSE);
+		ret = EndAsyncExec(stmt, ret);
+	}
 	LEAVE_STMT_CS(stmt);
 	if (stxt)
 		free(stxt);
@@ -30,6 +30,7 @@
 
 #include "statement.h"
 #include "connection.h"
+#include "environ.h"
 #include "qresult.h"
 #include "pgtypes.h"
 #include "pgapifunc.h"
@@ -716,7 +717,6 @@ static BOOL
 getCOLIfromTable(ConnectionClass *conn, pgNAME *schema_name, pgNAME table_name,
 COL_INFO **coli)
 {
-	int	colidx;
 	BOOL	found = FALSE;
 
 	*coli = NULL;
@@ -731,19 +731,12 @@ COL_INFO **coli)
 		 * check the current_schema() when no
 		 * explicit schema name is specified.
 		 */
-		if (curschema)
+		if (curschema &&
+		    NULL != (*coli = CC_find_col_info(conn, curschema, GET_NAME(table_name))))
 		{
-			for (colidx = 0; colidx < conn->ntables; colidx++)
-			{
-				if (!NAMEICMP(conn->col_info[colidx]->table_name, table_name) &&
-					!stricmp(SAFE_NAME(conn->col_info[colidx]->schema_name), curschema))
-				{
-					MYLOG(0, "FOUND col_info table='%s' current schema='%s'\n", PRINT_NAME(table_name), curschema);
-					found = TRUE;
-					STR_TO_NAME(*schema_name, curschema);
-					break;
-				}
-			}
+			MYLOG(0, "FOUND col_info table='%s' current schema='%s'\n", PRINT_NAME(table_name), curschema);
+			found = TRUE;
+			STR_TO_NAME(*schema_name, curschema);
 		}
 		if (!found)
 		{
@@ -772,20 +765,11 @@ COL_INFO **coli)
 				return FALSE;
 		}
 	}
-	if (!found && NAME_IS_VALID(*schema_name))
+	if (!found && NAME_IS_VALID(*schema_name) &&
+	    NULL != (*coli = CC_find_col_info(conn, GET_NAME(*schema_name), GET_NAME(table_name))))
 	{
-		for (colidx = 0; colidx < conn->ntables; colidx++)
-		{
-			if (!NAMEICMP(conn->col_info[colidx]->table_name, table_name) &&
-			    !NAMEICMP(conn->col_info[colidx]->schema_name, *schema_name))
-			{
-				MYLOG(0, "FOUND col_info table='%s' schema='%s'\n", PRINT_NAME(table_name), PRINT_NAME(*schema_name));
-				found = TRUE;
-				break;
-			}
-		}
+		MYLOG(0, "FOUND col_info table='%s' schema='%s'\n", PRINT_NAME(table_name), PRINT_NAME(*schema_name));
 	}
-	*coli = found ? conn->col_info[colidx] : NULL;
 	return TRUE; /* success */
 }
 
@@ -795,13 +779,32 @@ getColumnsInfo(ConnectionClass *conn, TABLE_INFO *wti, OID greloid, StatementCla
 	BOOL		found = FALSE;
 	RETCODE		result;
 	HSTMT		hcol_stmt = NULL;
-	StatementClass	*col_stmt;
-	QResultClass	*res;
+	StatementClass	*col_stmt = NULL;
+	QResultClass	*res = NULL;
+	char		share_key[512];
+	BOOL		share;
+	SharedColInfo	*shared = NULL;
 
 	MYLOG(0, "entering Getting PG_Columns for table %u(%s)\n", greloid, PRINT_NAME(wti->table_name));
 
 	if (NULL == conn)
 		conn = SC_get_conn(stmt);
+
+	/*
+	 * Look up the column information shared by the other connections
+	 * before querying the catalog. Temporary tables are never shared.
+	 */
+	share = (CC_get_coli_share_key(conn, share_key, sizeof(share_key)) &&
+			 (0 != greloid || NAME_IS_VALID(wti->schema_name)) &&
+			 strnicmp(SAFE_NAME(wti->schema_name), "pg_temp_", 8) != 0);
+	if (share &&
+	    NULL != (shared = EN_find_shared_col_info(share_key, SAFE_NAME(wti->schema_name), SAFE_NAME(wti->table_name), greloid, conn->connInfo.coli_cache_ttl, &res)))
+	{
+		MYLOG(0, "      Shared\n");
+		result = SQL_SUCCESS;
+		goto store;
+	}
+
 	result = PGAPI_AllocStmt(conn, &hcol_stmt, 0);
 	if (!SQL_SUCCEEDED(result))
 	{
@@ -825,6 +828,7 @@ getColumnsInfo(ConnectionClass *conn, TABLE_INFO *wti, OID greloid, StatementCla
 
 	MYLOG(0, "        Past PG_Columns\n");
 	res = SC_get_Curres(col_stmt);
+store:
 	if (SQL_SUCCEEDED(result)
 		&& res != NULL && QR_get_num_cached_tuples(res) > 0)
 	{
@@ -834,19 +838,9 @@ getColumnsInfo(ConnectionClass *conn, TABLE_INFO *wti, OID greloid, StatementCla
 		time_t		acctime = 0;
 
 		MYLOG(0, "      Success\n");
-		if (greloid != 0)
-		{
-			for (k = 0; k < conn->ntables; k++)
-			{
-				tcoli = conn->col_info[k];
-				if (tcoli->table_oid == greloid)
-				{
-					coli = tcoli;
-					coli_exist = TRUE;
-					break;
-				}
-			}
-		}
+		if (greloid != 0 &&
+		    NULL != (coli = CC_find_col_info_by_oid(conn, greloid)))
+			coli_exist = TRUE;
 		if (!coli_exist)
 		{
 			for (k = 0; k < conn->ntables; k++)
@@ -916,6 +910,8 @@ getColumnsInfo(ConnectionClass *conn, TABLE_INFO *wti, OID greloid, StatementCla
 		col_info_initialize(coli);
 
 		coli->result = res;
+		coli->shared = shared;
+		shared = NULL;
 		if (res && QR_get_num_cached_tuples(res) > 0)
 		{
 			int num_tuples = QR_get_num_cached_tuples(res);
@@ -958,10 +954,19 @@ MYLOG(DETAIL_LOG_LEVEL, "#2 %p->table_name=%s(%u)\n", wti, PRINT_NAME(wti->table
 		 * The connection will now free the result structures, so
 		 * make sure that the statement doesn't free it
 		 */
-		SC_init_Result(col_stmt);
+		if (col_stmt)
+		{
+			SC_init_Result(col_stmt);
+			if (share &&
+			    0 != coli->table_oid &&
+			    NAME_IS_VALID(coli->schema_name) &&
+			    strnicmp(GET_NAME(coli->schema_name), "pg_temp_", 8) != 0)
+				coli->shared = EN_share_col_info(share_key, GET_NAME(coli->schema_name), GET_NAME(coli->table_name), coli->table_oid, res);
+		}
 
 		if (!coli_exist)
 			conn->ntables++;
+		CC_index_col_info(conn);
 
 if (res && QR_get_num_cached_tuples(res) > 0)
 MYLOG(DETAIL_LOG_LEVEL, "oid item == %s\n", (const char *) QR_get_value_backend_text(res, 0, 3));
@@ -973,6 +978,8 @@ MYLOG(DETAIL_LOG_LEVEL, "oid item == %s\n", (const char *) QR_get_value_backend_
 		wti->col_info = coli;
 	}
 cleanup:
+	if (shared)
+		EN_release_shared_col_info(shared);
 	if (hcol_stmt)
 		PGAPI_FreeStmt(hcol_stmt, SQL_DROP);
 	return found;
@@ -1025,18 +1032,12 @@ MYLOG(DETAIL_LOG_LEVEL, "fi=%p greloid=%d col_info=%p\n", wti, greloid, wti->col
 	}
 	if (greloid != 0)
 	{
-		int	colidx;
-
-		for (colidx = 0; colidx < conn->ntables; colidx++)
+		if (coli = CC_find_col_info_by_oid(conn, greloid), NULL != coli)
 		{
-			if (conn->col_info[colidx]->table_oid == greloid)
-			{
-				MYLOG(0, "FOUND col_info table=%ul\n", greloid);
-				found = TRUE;
-				wti->col_info = conn->col_info[colidx];
-				wti->col_info->refcnt++;
-				break;
-			}
+			MYLOG(0, "FOUND col_info table=%ul\n", greloid);
+			found = TRUE;
+			wti->col_info = coli;
+			wti->col_info->refcnt++;
 		}
 	}
 	else
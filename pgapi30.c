@@ -405,7 +405,8 @@ PGAPI_GetConnectAttr(HDBC ConnectionHandle,
 	switch (Attribute)
 	{
 		case SQL_ATTR_ASYNC_ENABLE:
-			*((SQLINTEGER *) Value) = SQL_ASYNC_ENABLE_OFF;
+			*((SQLULEN *) Value) = conn->stmtOptions.async_enable;
+			len = sizeof(SQLULEN);
 			break;
 		case SQL_ATTR_AUTO_IPD:
 			*((SQLINTEGER *) Value) = SQL_FALSE;
@@ -464,6 +465,14 @@ PGAPI_GetConnectAttr(HDBC ConnectionHandle,
 		case SQL_ATTR_PGOPT_IGNORETIMEOUT:
 			*((SQLINTEGER *) Value) = conn->connInfo.ignore_timeout;
 			break;
+		case SQL_ATTR_PGOPT_METRICS:
+			len = (SQLINTEGER) CC_metrics_report(conn, (char *) Value, BufferLength > 0 ? BufferLength : 0);
+			if (len >= BufferLength)
+			{
+				CC_set_error(conn, CONN_TRUNCATED, "The buffer was too small for the metrics.", __FUNCTION__);
+				ret = SQL_SUCCESS_WITH_INFO;
+			}
+			break;
 		default:
 			ret = PGAPI_GetConnectOption(ConnectionHandle, (UWORD) Attribute, Value, &len, BufferLength);
 	}
@@ -1634,6 +1643,16 @@ PGAPI_GetStmtAttr(HSTMT StatementHandle,
 		case SQL_ATTR_METADATA_ID:		/* 10014 */
 			*((SQLUINTEGER *) Value) = stmt->options.metadata_id;
 			break;
+#ifdef	USE_ASYNC_NOTIFICATION
+		case SQL_ATTR_ASYNC_STMT_PCALLBACK:
+			*((SQLPOINTER *) Value) = stmt->async_callback;
+			len = sizeof(SQLPOINTER);
+			break;
+		case SQL_ATTR_ASYNC_STMT_PCONTEXT:
+			*((SQLPOINTER *) Value) = stmt->async_context;
+			len = sizeof(SQLPOINTER);
+			break;
+#endif /* USE_ASYNC_NOTIFICATION */
 		case SQL_ATTR_ENABLE_AUTO_IPD:	/* 15 */
 			*((SQLUINTEGER *) Value) = SQL_FALSE;
 			break;
@@ -1703,7 +1722,6 @@ PGAPI_SetConnectAttr(HDBC ConnectionHandle,
 			if (SQL_FALSE != Value)
 				unsupported = TRUE;
 			break;
-		case SQL_ATTR_ASYNC_ENABLE:
 		case SQL_ATTR_CONNECTION_DEAD:
 		case SQL_ATTR_CONNECTION_TIMEOUT:
 			unsupported = TRUE;
@@ -1799,6 +1817,12 @@ PGAPI_SetConnectAttr(HDBC ConnectionHandle,
 			conn->connInfo.ignore_timeout = CAST_PTR(SQLINTEGER, Value);
 			MYLOG(0, "ignore_timeout => %d\n", conn->connInfo.ignore_timeout);
 			break;
+		case SQL_ATTR_PGOPT_METRICS:
+			/* turn on/off collecting the metrics and reset them */
+			conn->connInfo.collect_metrics = (0 != CAST_PTR(SQLINTEGER, Value));
+			CC_reset_metrics(conn);
+			MYLOG(0, "collect_metrics => %d\n", conn->connInfo.collect_metrics);
+			break;
 		default:
 			if (Attribute < 65536)
 				ret = PGAPI_SetConnectOption(ConnectionHandle, (SQLUSMALLINT) Attribute, (SQLLEN) Value);
@@ -1952,6 +1976,15 @@ PGAPI_SetStmtAttr(HSTMT StatementHandle,
 		case SQL_ATTR_METADATA_ID:		/* 10014 */
 			stmt->options.metadata_id = CAST_UPTR(SQLUINTEGER, Value);
 			break;
+#ifdef	USE_ASYNC_NOTIFICATION
+		/* set by the driver manager for the notification */
+		case SQL_ATTR_ASYNC_STMT_PCALLBACK:
+			stmt->async_callback = Value;
+			break;
+		case SQL_ATTR_ASYNC_STMT_PCONTEXT:
+			stmt->async_context = Value;
+			break;
+#endif /* USE_ASYNC_NOTIFICATION */
 		case SQL_ATTR_APP_ROW_DESC:		/* 10010 */
 			if (SQL_NULL_HDESC == Value)
 			{
@@ -316,6 +316,7 @@ enum {
 	,SQL_ATTR_PGOPT_MSJET = 65549
 	,SQL_ATTR_PGOPT_BATCHSIZE = 65550
 	,SQL_ATTR_PGOPT_IGNORETIMEOUT = 65551
+	,SQL_ATTR_PGOPT_METRICS = 65552
 };
 RETCODE SQL_API PGAPI_SetConnectAttr(HDBC ConnectionHandle,
 			SQLINTEGER Attribute, PTR Value,
@@ -1896,6 +1896,29 @@ pgtype_unsigned(const ConnectionClass *conn, OID type)
 	}
 }
 
+/*
+ *	Can the values of the type be received in binary format and
+ *	decoded by copy_and_convert_field() ?
+ */
+BOOL
+pgtype_binary_transferable(const ConnectionClass *conn, OID type)
+{
+	switch (type)
+	{
+		case PG_TYPE_BOOL:
+		case PG_TYPE_INT2:
+		case PG_TYPE_INT4:
+		case PG_TYPE_INT8:
+		case PG_TYPE_OID:
+		case PG_TYPE_FLOAT4:
+		case PG_TYPE_FLOAT8:
+			return TRUE;
+
+		default:
+			return FALSE;
+	}
+}
+
 
 const char *
 pgtype_literal_prefix(const ConnectionClass *conn, OID type)
@@ -127,6 +127,7 @@ Int2		pgtype_case_sensitive(const ConnectionClass *conn, OID type);
 Int2		pgtype_money(const ConnectionClass *conn, OID type);
 Int2		pgtype_searchable(const ConnectionClass *conn, OID type);
 Int2		pgtype_unsigned(const ConnectionClass *conn, OID type);
+BOOL		pgtype_binary_transferable(const ConnectionClass *conn, OID type);
 const char	*pgtype_literal_prefix(const ConnectionClass *conn, OID type);
 const char	*pgtype_literal_suffix(const ConnectionClass *conn, OID type);
 const char	*pgtype_create_params(const ConnectionClass *conn, OID type);
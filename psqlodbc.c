@@ -22,6 +22,7 @@
 #include "dlg_specific.h"
 #include "environ.h"
 #include "misc.h"
+#include "convert.h"
 #include <string.h>
 
 #ifdef WIN32
@@ -90,12 +91,14 @@ int	initialize_global_cs(void)
 	InitializeLogging();
 	INIT_CONNS_CS;
 	INIT_COMMON_CS;
+	InitializeConvertWorkers();
 
 	return 0;
 }
 
 static void finalize_global_cs(void)
 {
+	FinalizeConvertWorkers();
 	DELETE_COMMON_CS;
 	DELETE_CONNS_CS;
 	FinalizeLogging();
@@ -290,6 +290,10 @@ extern int posix_snprintf(char *buf, size_t size, const char *format, ...);
 #ifndef	SQL_ATTR_IMP_PARAM_DESC
 #define	SQL_ATTR_IMP_PARAM_DESC	10013
 #endif
+/* ODBC 3.8 notification of the asynchronous execution completion */
+#if defined(WIN32) && defined(SQL_ATTR_ASYNC_STMT_PCALLBACK)
+#define	USE_ASYNC_NOTIFICATION
+#endif /* WIN32 && SQL_ATTR_ASYNC_STMT_PCALLBACK */
 
 /* Driver stuff */
 
@@ -371,6 +375,8 @@ BOOL isSqlServr(void);
 #define FETCH_MAX					100 /* default number of rows to cache
 										 * for declare/fetch */
 #define TUPLE_MALLOC_INC			100
+#define TUPLE_CHUNK_SIZE			(64 * 1024) /* allocation unit of
+										 * the tuple data pool */
 #define MAX_CONNECTIONS				128 /* conns per environment
 										 * (arbitrary)	*/
 
@@ -430,6 +436,10 @@ typedef struct IRDFields_ IRDFields;
 typedef struct IPDFields_ IPDFields;
 
 typedef struct col_info COL_INFO;
+typedef struct plan_info PLAN_INFO;
+typedef struct query_template QUERY_TEMPLATE;
+typedef struct async_query ASYNC_QUERY;
+typedef struct SharedColInfo_ SharedColInfo;
 typedef struct lo_arg LO_ARG;
 
 typedef struct QResultHold_struct {
@@ -540,6 +550,7 @@ typedef struct StatementOptions_
 	void			*bookmark_ptr;
 	SQLUINTEGER		metadata_id;
 	SQLULEN			stmt_timeout;
+	SQLULEN			async_enable;
 } StatementOptions;
 
 /*	Used to pass extra query info to send_query */
@@ -551,6 +562,23 @@ typedef struct QueryInfo_
 	const char	*cursor;
 } QueryInfo;
 
+/*	Used to collect the performance metrics (CollectMetrics) */
+typedef struct
+{
+	Int8	executes;	/* number of executions */
+	Int8	exec_usec;	/* time spent in sending queries and receiving results */
+	Int8	rows;		/* rows received */
+	Int8	bytes;		/* bytes of the field values received */
+	Int8	convert_usec;	/* time spent in copy_and_convert_field */
+} PG_Metrics;
+
+/*	The metrics of the executions of a query (CollectMetrics) */
+typedef struct
+{
+	char		*name;	/* the normalized query */
+	PG_Metrics	metrics;
+} PG_QueryMetrics;
+
 /*	Used to save the error information */
 typedef struct
 {
@@ -624,6 +652,7 @@ typedef struct
 	char		pqopt_in_str;
 	pgNAME		conn_settings;
 	pgNAME		pqopt;
+	pgNAME		pool_reset_query;
 	signed char	allow_keyset;
 	signed char	updatable_cursors;
 	signed char	lf_conversion;
@@ -648,6 +677,23 @@ typedef struct
 	Int4		keepalive_idle;
 	Int4		keepalive_interval;
 	Int4		batch_size;
+	Int4		result_chunk_size;
+	Int4		pool_size;
+	char		binary_results;
+	char		use_pipeline;
+	char		use_copy_insert;
+	char		collect_metrics;
+	Int4		plan_cache_size;
+	Int4		coli_cache_ttl;
+	Int4		keyset_reload_batch;
+	Int4		fetch_ahead;
+	Int4		adaptive_fetch_bytes;
+	Int4		adaptive_fetch_min;
+	Int4		adaptive_fetch_max;
+	char		zero_copy_fetch;
+	Int4		convert_threads;
+	Int4		query_cache_size;
+	Int4		lo_read_ahead_size;
 #ifdef	_HANDLE_ENLIST_IN_DTC_
 	signed char	xa_opt;
 #endif /* _HANDLE_ENLIST_IN_DTC_ */
@@ -24,10 +24,11 @@
 #include "misc.h"
 #include <stdio.h>
 #include <string.h>
+#include <stddef.h>
 #include <limits.h>
 
 static BOOL QR_prepare_for_tupledata(QResultClass *self);
-static BOOL QR_read_tuples_from_pgres(QResultClass *, PGresult **pgres);
+static BOOL QR_read_tuples_from_pgres(QResultClass *, StatementClass *, PGresult **pgres, BOOL *held);
 
 /*
  *	Used for building a Manual Result only
@@ -189,6 +190,7 @@ QR_Constructor(void)
 		}
 		QR_set_fields(rv, fields);
 		rv->backend_tuples = NULL;
+		rv->tuple_chunks = NULL;
 		rv->sqlstate[0] = '\0';
 		rv->message = NULL;
 		rv->messageref = NULL;
@@ -237,6 +239,16 @@ QR_Constructor(void)
 		rv->dl_count = 0;
 		rv->deleted = NULL;
 		rv->deleted_keyset = NULL;
+		rv->prefetched = NULL;
+		rv->num_prefetched = 0;
+		rv->prefetch_size = 0;
+		rv->prefetch_eof = FALSE;
+		rv->prefetch_rolled_back = FALSE;
+		rv->last_fetch_rows = 0;
+		rv->last_fetch_bytes = 0;
+		rv->last_fetch_usec = 0;
+		rv->fetch_row_bytes = 0;
+		rv->adaptive_fetch_size = 0;
 	}
 
 	MYLOG(0, "leaving %p\n", rv);
@@ -487,6 +499,21 @@ QR_free_memory(QResultClass *self)
 		self->dataFilled = FALSE;
 		self->tupleField = NULL;
 	}
+	QR_release_tuple_pool(self, FALSE);
+	if (NULL != self->conn && self == self->conn->prefetch_res)
+		CC_finish_prefetch(self->conn);
+	if (self->prefetched)
+	{
+		int	i;
+
+		for (i = 0; i < self->num_prefetched; i++)
+			PQclear(self->prefetched[i]);
+		free(self->prefetched);
+		self->prefetched = NULL;
+		self->num_prefetched = 0;
+	}
+	self->prefetch_eof = FALSE;
+	self->prefetch_rolled_back = FALSE;
 	if (self->keyset)
 	{
 		ConnectionClass	*conn = QR_get_conn(self);
@@ -594,6 +621,7 @@ QR_from_PGresult(QResultClass *self, StatementClass *stmt, ConnectionClass *conn
 	Int2		dummy1, dummy2;
 	int			cidx;
 	BOOL		reached_eof_now = FALSE;
+	BOOL		held;
 
 	if (NULL != conn)
 		/* First, get column information */
@@ -607,6 +635,8 @@ QR_from_PGresult(QResultClass *self, StatementClass *stmt, ConnectionClass *conn
 	QR_set_num_fields(self, new_num_fields);
 	if (NULL == QR_get_fields(self)->coli_array)
 		return FALSE;
+	if (new_num_fields > 0 && 1 == PQfformat(*pgres, 0))
+		QR_set_binary_format(self);
 
 	/* now read in the descriptions */
 	for (lf = 0; lf < new_num_fields; lf++)
@@ -668,8 +698,13 @@ MYLOG(DETAIL_LOG_LEVEL, "[%d].PGType %u->%u\n", i, PIC_get_pgtype(ipdopts->param
 
 	/* Then, get the data itself */
 	num_cached_rows = self->num_cached_rows;
-	if (!QR_read_tuples_from_pgres(self, pgres))
+	if (!QR_read_tuples_from_pgres(self, stmt, pgres, &held))
+	{
+		/* the tuple pool owns it even on failure */
+		if (held)
+			*pgres = NULL;
 		return FALSE;
+	}
 
 MYLOG(DETAIL_LOG_LEVEL, "!!%p->cursTup=" FORMAT_LEN " total_read=" FORMAT_ULEN "\n", self, self->cursTuple, self->num_total_read);
 	if (!QR_once_reached_eof(self) && self->cursTuple >= (Int4) self->num_total_read)
@@ -697,6 +732,9 @@ MYLOG(DETAIL_LOG_LEVEL, "!!%p->cursTup=" FORMAT_LEN " total_read=" FORMAT_ULEN "
 	 * a FETCH.)
 	 */
 	QR_set_command(self, PQcmdStatus(*pgres));
+	/* the tuple pool owns it now */
+	if (held)
+		*pgres = NULL;
 	QR_set_cursor(self, cursor);
 	if (NULL == cursor)
 		QR_set_reached_eof(self);
@@ -931,6 +969,57 @@ SQLLEN	QR_move_cursor_to_last(QResultClass *self, StatementClass *stmt)
 	return	moved;
 }
 
+/*
+ *	Size the next FETCH so that it brings about AdaptiveFetchBytes bytes,
+ *	using the bytes per row of the blocks read so far.
+ */
+#define	ADAPTIVE_FETCH_SLOW_USEC	1000000
+static Int4
+QR_adaptive_fetch_size(QResultClass *self, const ConnInfo *ci)
+{
+	Int4	cur_size = self->adaptive_fetch_size > 0 ? self->adaptive_fetch_size : ci->drivers.fetch_max;
+	Int4	min_size = ci->adaptive_fetch_min > 0 ? ci->adaptive_fetch_min : 1;
+	Int4	max_size = ci->adaptive_fetch_max > min_size ? ci->adaptive_fetch_max : min_size;
+	SQLLEN	row_bytes;
+	Int8	fetch_size;
+
+	/* resize once per FETCH */
+	if (0 >= self->last_fetch_rows)
+		return cur_size;
+	row_bytes = (SQLLEN) (self->last_fetch_bytes / self->last_fetch_rows) + 1;
+	/* smooth out the blocks of unusual rows */
+	if (0 < self->fetch_row_bytes)
+		row_bytes = (3 * self->fetch_row_bytes + row_bytes) / 4;
+	self->fetch_row_bytes = row_bytes;
+	self->last_fetch_rows = 0;
+
+	fetch_size = ci->adaptive_fetch_bytes / self->fetch_row_bytes;
+	/*
+	 * Grow gradually, and not at all if a FETCH already keeps the
+	 * application waiting long for the next block.
+	 */
+	if (fetch_size > cur_size)
+	{
+		if (self->last_fetch_usec > ADAPTIVE_FETCH_SLOW_USEC)
+			fetch_size = cur_size;
+		else if (fetch_size > 2 * (Int8) cur_size)
+			fetch_size = 2 * (Int8) cur_size;
+	}
+	if (fetch_size < min_size)
+		fetch_size = min_size;
+	else if (fetch_size > max_size)
+		fetch_size = max_size;
+	MYLOG(DETAIL_LOG_LEVEL, "fetch size %d -> " FORMATI64 " (" FORMAT_LEN " bytes per row, last FETCH " FORMATI64 "usec)\n", cur_size, fetch_size, self->fetch_row_bytes, self->last_fetch_usec);
+	self->adaptive_fetch_size = (Int4) fetch_size;
+
+	return self->adaptive_fetch_size;
+}
+
+/*	Only the blocks of forward-only cursors are read ahead */
+#define	QR_reads_ahead(self, stmt)	(SQL_CURSOR_FORWARD_ONLY == (stmt)->options.cursor_type && !QR_haskeyset(self))
+/*	A FETCH read ahead is checked for completion every this many rows */
+#define	PREFETCH_POLL_ROWS	64
+
 /*	This function is called by fetch_tuples() AND SQLFetch() */
 int
 QR_next_tuple(QResultClass *self, StatementClass *stmt)
@@ -944,7 +1033,9 @@ QR_next_tuple(QResultClass *self, StatementClass *stmt)
 	SQLLEN		num_backend_rows = self->num_cached_rows, num_rows_in;
 	Int4		num_fields = self->num_fields, fetch_size, req_size;
 	SQLLEN		offset = 0, end_tuple;
-	char		boundary_adjusted = FALSE;
+	char		boundary_adjusted = FALSE, prefetched;
+	Int4		block_size;
+	Int8		start_usec = 0;
 	TupleField *the_tuples = self->backend_tuples;
 	QResultClass	*res;
 
@@ -964,9 +1055,13 @@ MYLOG(DETAIL_LOG_LEVEL, "in total_read=" FORMAT_ULEN " cursT=" FORMAT_LEN " curr
 	req_size = QR_get_reqsize(self);
 	/* Determine the optimum cache size.  */
 	ci = &(conn->connInfo);
-	fetch_size = ci->drivers.fetch_max;
+	if (0 < ci->adaptive_fetch_bytes && NULL != QR_get_cursor(self))
+		fetch_size = QR_adaptive_fetch_size(self, ci);
+	else
+		fetch_size = ci->drivers.fetch_max;
 	if ((Int4)req_size > fetch_size)
 		fetch_size = req_size;
+	block_size = fetch_size;
 	if (QR_once_reached_eof(self) && self->cursTuple >= (Int4) QR_get_num_total_read(self))
 		curr_eof = TRUE;
 #define	return	DONT_CALL_RETURN_FROM_HERE???
@@ -1069,6 +1164,17 @@ MYLOG(DETAIL_LOG_LEVEL, "moved=" FORMAT_ULEN " ? " FORMAT_ULEN "\n", moved, move
 MYLOG(DETAIL_LOG_LEVEL, "tupleField=%p\n", self->tupleField);
 		/* move to next row */
 		QR_inc_next_in_cache(self);
+		/*
+		 * Read ahead while the cached block is processed. A completed
+		 * FETCH is collected and followed by another one until
+		 * FetchAhead blocks are stashed.
+		 */
+		if (0 < ci->fetch_ahead && !QR_once_reached_eof(self) &&
+		    NULL != QR_get_cursor(self) && !self->prefetch_eof &&
+		    self->num_prefetched < ci->fetch_ahead &&
+		    (NULL == conn->prefetch_res || 0 == fetch_number % PREFETCH_POLL_ROWS) &&
+		    QR_reads_ahead(self, stmt))
+			CC_prefetch(conn, self, block_size);
 		RETURN(TRUE)
 	}
 	else if (QR_once_reached_eof(self))
@@ -1102,16 +1208,21 @@ MYLOG(DETAIL_LOG_LEVEL, "tupleField=%p\n", self->tupleField);
 		RETURN(-1)		/* end of tuples */
 	}
 
+	/* the next block may be read ahead already */
+	prefetched = QR_has_prefetch(self, conn);
 	if (QR_get_rowstart_in_cache(self) >= num_backend_rows ||
 		QR_is_moving(self))
 	{
 		TupleField *tuple = self->backend_tuples;
 
+		if (prefetched)
+			fetch_size = self->prefetch_size;
 		/* not a correction */
 		self->cache_size = fetch_size;
 		/* clear obsolete tuples */
 MYLOG(DETAIL_LOG_LEVEL, "clear obsolete " FORMAT_LEN " tuples\n", num_backend_rows);
 		ClearCachedRows(tuple, num_fields, num_backend_rows);
+		QR_release_tuple_pool(self, TRUE);
 		self->dataFilled = FALSE;
 		QR_stop_movement(self);
 		self->move_offset = 0;
@@ -1131,6 +1242,8 @@ MYLOG(DETAIL_LOG_LEVEL, "clear obsolete " FORMAT_LEN " tuples\n", num_backend_ro
 			MYLOG(0, "corrupted fetch_size end_tuple=" FORMAT_LEN " <= cached_rows=" FORMAT_LEN "\n", end_tuple, num_backend_rows);
 			RETURN(-1)
 		}
+		if (prefetched)
+			fetch_size = self->prefetch_size;
 		/* and enlarge the cache size */
 		self->cache_size += fetch_size;
 		offset = self->fetch_number;
@@ -1159,7 +1272,14 @@ MYLOG(DETAIL_LOG_LEVEL, "clear obsolete " FORMAT_LEN " tuples\n", num_backend_ro
 	qi.fetch_size = fetch_size;
 	qi.result_in = self;
 	qi.cursor = NULL;
-	res = CC_send_query(conn, fetch, &qi, READ_ONLY_QUERY, stmt);
+	if (0 < ci->adaptive_fetch_bytes)
+		start_usec = get_clock_usec();
+	if (prefetched)
+		res = CC_receive_prefetched(conn, &qi, stmt);
+	else
+		res = CC_send_query(conn, fetch, &qi, READ_ONLY_QUERY, stmt);
+	if (0 < start_usec)
+		self->last_fetch_usec = get_clock_usec() - start_usec;
 	if (!QR_command_maybe_successful(res))
 	{
 		if (!QR_get_message(self))
@@ -1179,6 +1299,10 @@ MYLOG(DETAIL_LOG_LEVEL, "reached_eof_now=%d\n", reached_eof_now);
 	cur_fetch = self->num_cached_rows - num_rows_in;
 	if (!ret)
 		RETURN(ret)
+	/* have the server work on the next block while this one is processed */
+	if (!reached_eof_now && cur_fetch >= fetch_size &&
+	    QR_reads_ahead(self, stmt))
+		CC_prefetch(conn, self, block_size);
 
 	{
 		SQLLEN	start_idx = 0;
@@ -1304,15 +1428,139 @@ MYLOG(DETAIL_LOG_LEVEL, "returning %d offset=" FORMAT_LEN "\n", ret, offset);
 	return ret;
 }
 
+/*
+ *	Tuple data pool.
+ *
+ *	The field values read from the backend are carved out of large
+ *	chunks instead of being malloc'ed one by one, and are released
+ *	all at once when the tuple cache is cleared.  TupleFields whose
+ *	value points into the pool have the pooled member set, so that
+ *	ClearCachedRows() etc. never free() them individually.
+ *	With ZeroCopyFetch the pool holds the PGresults themselves and the
+ *	values point into them.
+ */
+struct TupleChunk_
+{
+	TupleChunk	*next;
+	PGresult	*pgres;		/* a PGresult held instead of data */
+	size_t		size;		/* usable bytes in data[] */
+	size_t		used;
+	char		data[1];
+};
+
+static char *
+QR_alloc_tuple_value(QResultClass *self, size_t size)
+{
+	TupleChunk	*chunk = self->tuple_chunks;
+	char		*buf;
+
+	if (NULL == chunk || chunk->size - chunk->used < size)
+	{
+		TupleChunk	*newchunk;
+		size_t		alsize = TUPLE_CHUNK_SIZE;
+		BOOL		dedicated = FALSE;
+
+		/* a large value gets a chunk of its own */
+		if (size > alsize / 4)
+		{
+			alsize = size;
+			dedicated = TRUE;
+		}
+		if (newchunk = (TupleChunk *) malloc(offsetof(TupleChunk, data) + alsize), NULL == newchunk)
+			return NULL;
+		newchunk->pgres = NULL;
+		newchunk->size = alsize;
+		newchunk->used = 0;
+		if (dedicated && NULL != chunk)
+		{
+			/* keep on carving small values out of the current chunk */
+			newchunk->next = chunk->next;
+			chunk->next = newchunk;
+		}
+		else
+		{
+			newchunk->next = chunk;
+			self->tuple_chunks = newchunk;
+		}
+		chunk = newchunk;
+	}
+	buf = chunk->data + chunk->used;
+	chunk->used += size;
+
+	return buf;
+}
+
+/*
+ *	Keep the PGresult the TupleFields point into until the pool is released.
+ */
+static BOOL
+QR_hold_pgres(QResultClass *self, PGresult *pgres)
+{
+	TupleChunk	*chunk = self->tuple_chunks, *newchunk;
+
+	if (newchunk = (TupleChunk *) malloc(offsetof(TupleChunk, data)), NULL == newchunk)
+		return FALSE;
+	newchunk->pgres = pgres;
+	newchunk->size = newchunk->used = 0;
+	/* keep on carving values out of the current chunk */
+	if (NULL != chunk)
+	{
+		newchunk->next = chunk->next;
+		chunk->next = newchunk;
+	}
+	else
+	{
+		newchunk->next = NULL;
+		self->tuple_chunks = newchunk;
+	}
+	return TRUE;
+}
+
+/*
+ *	Release the tuple data pool at once.
+ *	The caller must have cleared all the TupleFields pointing into it.
+ *	If reuse is TRUE, one chunk is kept for the next group of rows.
+ */
+void
+QR_release_tuple_pool(QResultClass *self, BOOL reuse)
+{
+	TupleChunk	*chunk = self->tuple_chunks, *next;
+
+	self->tuple_chunks = NULL;
+	if (reuse && NULL != chunk && TUPLE_CHUNK_SIZE == chunk->size)
+	{
+		next = chunk->next;
+		chunk->next = NULL;
+		chunk->used = 0;
+		self->tuple_chunks = chunk;
+		chunk = next;
+	}
+	for (; NULL != chunk; chunk = next)
+	{
+		next = chunk->next;
+		if (NULL != chunk->pgres)
+			PQclear(chunk->pgres);
+		free(chunk);
+	}
+}
+
 /*
  * Read tuples from a libpq PGresult object into QResultClass.
  *
  * The result status of the passed-in PGresult should be either
- * PGRES_TUPLES_OK, or PGRES_SINGLE_TUPLE. If it's PGRES_SINGLE_TUPLE,
- * this function will call PQgetResult() to read all the available tuples.
+ * PGRES_TUPLES_OK, PGRES_SINGLE_TUPLE or PGRES_TUPLES_CHUNK. If it's not
+ * PGRES_TUPLES_OK, this function will call PQgetResult() to read all the
+ * available tuples.
+ * The rows and bytes received are added to the metrics of the connection
+ * and the query of stmt when CollectMetrics is on.
+ * With ZeroCopyFetch the field values of forward-only read-only results
+ * aren't copied, the PGresults are held in the tuple pool instead and
+ * *held tells that the caller mustn't PQclear() the last one (even if
+ * this function fails). The PGresults of the single-row mode are copied
+ * as usual, holding one per row would take more memory than the values.
  */
 static BOOL
-QR_read_tuples_from_pgres(QResultClass *self, PGresult **pgres)
+QR_read_tuples_from_pgres(QResultClass *self, StatementClass *stmt, PGresult **pgres, BOOL *held)
 {
 	Int2		field_lf;
 	int			len;
@@ -1327,9 +1575,16 @@ QR_read_tuples_from_pgres(QResultClass *self, PGresult **pgres)
 	int			nrows;
 	int			resStatus;
 	int		numTotalRows = 0;
+	Int8		numBytes = 0;
+	BOOL		zero_copy;
 
+	*held = FALSE;
 	/* set the current row to read the fields into */
 	effective_cols = QR_NumPublicResultCols(self);
+	zero_copy = (NULL != stmt && self->conn->connInfo.zero_copy_fetch &&
+				 !QR_haskeyset(self) &&
+				 SQL_CURSOR_FORWARD_ONLY == stmt->options.cursor_type &&
+				 SQL_CONCUR_READ_ONLY == stmt->options.scroll_concurrency);
 
 	flds = QR_get_fields(self);
 
@@ -1341,6 +1596,9 @@ nextrow:
 			QLOG(0, "\tok: - 'T' - %s\n", PQcmdStatus(*pgres));
 			break;
 		case PGRES_SINGLE_TUPLE:
+#ifdef	HAVE_PQSETCHUNKEDROWSMODE
+		case PGRES_TUPLES_CHUNK:
+#endif /* HAVE_PQSETCHUNKEDROWSMODE */
 			break;
 
 		case PGRES_NONFATAL_ERROR:
@@ -1354,6 +1612,9 @@ nextrow:
 
 	nrows = PQntuples(*pgres);
 	numTotalRows += nrows;
+	/* the values point into *pgres if it can be held, else are copied */
+	*held = (zero_copy && PGRES_SINGLE_TUPLE != resStatus && nrows > 0 &&
+		 QR_hold_pgres(self, *pgres));
 
 	for (rowno = 0; rowno < nrows; rowno++)
 	{
@@ -1381,6 +1642,7 @@ nextrow:
 			if (isnull)
 			{
 				this_tuplefield[field_lf].len = 0;
+				this_tuplefield[field_lf].pooled = FALSE;
 				this_tuplefield[field_lf].value = 0;
 				QPRINTF(TUPLE_LOG_LEVEL, " (null)");
 				continue;
@@ -1389,16 +1651,28 @@ nextrow:
 			{
 				len = PQgetlength(*pgres, rowno, field_lf);
 				value = PQgetvalue(*pgres, rowno, field_lf);
+				numBytes += len;
 				if (field_lf >= effective_cols)
 					buffer = tidoidbuf;
-				else
+				else if (*held)
+					buffer = value;	/* libpq terminates it with a null */
+				else if (buffer = QR_alloc_tuple_value(self, len + 1), NULL == buffer)
+				{
+					QR_set_rstatus(self, PORES_NO_MEMORY_ERROR);
+					QR_free_memory(self);
+					QR_set_messageref(self, "Out of memory in allocating item buffer.");
+					return FALSE;
+				}
+				if (buffer != value)
 				{
-					QR_MALLOC_return_with_error(buffer, char, len + 1, self, "Out of memory in allocating item buffer.", FALSE);
+					memcpy(buffer, value, len);
+					buffer[len] = '\0';
 				}
-				memcpy(buffer, value, len);
-				buffer[len] = '\0';
 
-				QPRINTF(TUPLE_LOG_LEVEL, " '%s'(%d)", buffer, len);
+				if (QR_is_binary_format(self) && field_lf < effective_cols)
+					QPRINTF(TUPLE_LOG_LEVEL, " (binary)(%d)", len);	/* not a string */
+				else
+					QPRINTF(TUPLE_LOG_LEVEL, " '%s'(%d)", buffer, len);
 
 				if (field_lf >= effective_cols)
 				{
@@ -1420,6 +1694,7 @@ nextrow:
 				else
 				{
 					this_tuplefield[field_lf].len = len;
+					this_tuplefield[field_lf].pooled = TRUE;
 					this_tuplefield[field_lf].value = buffer;
 
 					/*
@@ -1429,9 +1704,11 @@ nextrow:
 					 * is only 100 rows. Bpchar can be handled since the strlen of
 					 * all rows is fixed, assuming there are not 100 nulls in a
 					 * row!
+					 * The length of a binary value isn't the display size.
 					 */
 
-					if (flds && flds->coli_array && CI_get_display_size(flds, field_lf) < len)
+					if (flds && flds->coli_array && !QR_is_binary_format(self) &&
+						CI_get_display_size(flds, field_lf) < len)
 						CI_get_display_size(flds, field_lf) = len;
 				}
 			}
@@ -1449,10 +1726,12 @@ nextrow:
 			self->num_total_read = self->cursTuple + 1;
 	}
 
-	if (resStatus == PGRES_SINGLE_TUPLE)
+	if (resStatus != PGRES_TUPLES_OK)
 	{
-		/* Process next row */
-		PQclear(*pgres);
+		/* Process next row(s) */
+		if (!*held)
+			PQclear(*pgres);
+		*held = FALSE;
 
 		*pgres = PQgetResult(self->conn->pqconn);
 		goto nextrow;
@@ -1461,6 +1740,16 @@ nextrow:
 	self->dataFilled = TRUE;
 	self->tupleField = self->backend_tuples + (self->fetch_number * self->num_fields);
 MYLOG(DETAIL_LOG_LEVEL, "tupleField=%p\n", self->tupleField);
+	self->last_fetch_rows = numTotalRows;
+	self->last_fetch_bytes = numBytes;
+	if (CC_collects_metrics(self->conn))
+	{
+		PG_Metrics	metrics = {0};
+
+		metrics.rows = numTotalRows;
+		metrics.bytes = numBytes;
+		CC_add_metrics(self->conn, stmt, &metrics);
+	}
 
 	QR_set_rstatus(self, PORES_TUPLES_OK);
 
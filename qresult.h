@@ -50,6 +50,8 @@ enum
 	,FQR_NEEDS_SURVIVAL_CHECK = (1L << 3) /* check if the cursor is open */
 };
 
+typedef struct TupleChunk_ TupleChunk;
+
 struct QResultClass_
 {
 	ColumnInfoClass *fields;	/* the Column information */
@@ -84,6 +86,7 @@ struct QResultClass_
 
 	TupleField *backend_tuples;	/* data from the backend (the tuple cache) */
 	TupleField *tupleField;		/* current backend tuple being retrieved */
+	TupleChunk *tuple_chunks;	/* pool the backend_tuples values are carved from */
 
 	char	pstatus;		/* processing status */
 	char	aborted;		/* was aborted ? */
@@ -112,6 +115,17 @@ struct QResultClass_
 	SQLLEN		*updated;	/* updated index info */
 	KeySet		*updated_keyset;	/* uddated keyset info */
 	TupleField	*updated_tuples;	/* uddated data by myself */
+	PGresult	**prefetched;	/* FETCH results read ahead */
+	Int4		num_prefetched;	/* count of prefetched results */
+	Int4		prefetch_size;	/* block size of the prefetched FETCHes */
+	char		prefetch_eof;	/* a prefetched FETCH reached the end */
+	char		prefetch_rolled_back;	/* the failed prefetched FETCH was
+						 * rolled back to its savepoint */
+	Int4		last_fetch_rows;	/* rows read by the last FETCH */
+	Int8		last_fetch_bytes;	/* bytes of the field values read by the last FETCH */
+	Int8		last_fetch_usec;	/* time the last FETCH took */
+	SQLLEN		fetch_row_bytes;	/* average bytes per row (AdaptiveFetchBytes) */
+	Int4		adaptive_fetch_size;	/* the fetch count sized by AdaptiveFetchBytes */
 };
 
 enum {
@@ -119,13 +133,16 @@ enum {
 	,FQR_WITHHOLD	= (1L << 1)
 	,FQR_HOLDPERMANENT = (1L << 2) /* the cursor is alive across transactions */
 	,FQR_SYNCHRONIZEKEYS = (1L<<3) /* synchronize the keyset range with that of cthe tuples cache */
+	,FQR_BINARY_FORMAT = (1L<<4) /* the values are in binary format */
 };
 
 #define	QR_haskeyset(self)		(0 != (self->flags & FQR_HASKEYSET))
 #define	QR_is_withhold(self)		(0 != (self->flags & FQR_WITHHOLD))
 #define	QR_is_permanent(self)		(0 != (self->flags & FQR_HOLDPERMANENT))
 #define	QR_synchronize_keys(self)	(0 != (self->flags & FQR_SYNCHRONIZEKEYS))
+#define	QR_is_binary_format(self)	(0 != (self->flags & FQR_BINARY_FORMAT))
 #define QR_get_fields(self)		(self->fields)
+#define	QR_has_prefetch(self, conn)	(0 < (self)->num_prefetched || (self) == (conn)->prefetch_res)
 
 
 /*	These functions are for retrieving data from the qresult */
@@ -163,6 +180,7 @@ enum {
 #define QR_set_aborted(self, aborted_)		( self->aborted = aborted_)
 #define QR_set_haskeyset(self)		(self->flags |= FQR_HASKEYSET)
 #define QR_set_synchronize_keys(self)	(self->flags |= FQR_SYNCHRONIZEKEYS)
+#define QR_set_binary_format(self)	(self->flags |= FQR_BINARY_FORMAT)
 #define QR_set_no_cursor(self)		((self)->flags &= ~(FQR_WITHHOLD | FQR_HOLDPERMANENT), (self)->pstatus &= ~FQR_NEEDS_SURVIVAL_CHECK)
 #define QR_set_withhold(self)		(self->flags |= FQR_WITHHOLD)
 #define QR_set_permanent(self)		(self->flags |= FQR_HOLDPERMANENT)
@@ -230,6 +248,7 @@ void		QR_close_result(QResultClass *self, BOOL destroy);
 void		QR_reset_for_re_execute(QResultClass *self);
 BOOL		QR_from_PGresult(QResultClass *self, StatementClass *stmt, ConnectionClass *conn, const char *cursor, PGresult **pgres);
 void		QR_free_memory(QResultClass *self);
+void		QR_release_tuple_pool(QResultClass *self, BOOL reuse);
 void		QR_set_command(QResultClass *self, const char *msg);
 void		QR_set_message(QResultClass *self, const char *msg);
 void		QR_add_message(QResultClass *self, const char *msg);
@@ -923,6 +923,7 @@ PGAPI_GetData(HSTMT hstmt,
 	char		get_bookmark = FALSE;
 	SQLSMALLINT	target_type;
 	int		precision = -1;
+	Int8		start_usec;
 #ifdef	WITH_UNIXODBC
 	SQLCHAR		dum_rgb[2] = "\0\0";
 #endif	/* WITH_UNIXODBC */
@@ -1090,8 +1091,16 @@ MYLOG(DETAIL_LOG_LEVEL, "currT=" FORMAT_LEN " base=" FORMAT_LEN " rowset=" FORMA
 
 	SC_set_current_col(stmt, icol);
 
+	start_usec = METRICS_START(SC_get_conn(stmt));
 	result = copy_and_convert_field(stmt, field_type, atttypmod, value,
 			target_type, precision, rgbValue, cbValueMax, pcbValue, pcbValue);
+	if (start_usec > 0)
+	{
+		PG_Metrics	metrics = {0};
+
+		metrics.convert_usec = get_clock_usec() - start_usec;
+		CC_add_metrics(SC_get_conn(stmt), stmt, &metrics);
+	}
 
 	switch (result)
 	{
@@ -1427,6 +1436,7 @@ PGAPI_ExtendedFetch(HSTMT hstmt,
 	UWORD		pstatus;
 	BOOL		currp_is_valid, reached_eof, useCursor;
 	SQLLEN		reqsize = rowsetSize;
+	int		columnar_cols = 0;
 
 	MYLOG(0, "entering stmt=%p rowsetSize=" FORMAT_LEN "\n", stmt, rowsetSize);
 
@@ -1842,6 +1852,8 @@ MYLOG(DETAIL_LOG_LEVEL, "num_tuples=" FORMAT_LEN "\n", num_tuples);
 
 	truncated = error = FALSE;
 
+	/* Convert the plain bound columns per column after the loop below */
+	columnar_cols = setup_columnar_fetch(stmt, rowsetSize);
 	currp = -1;
 	stmt->bind_row = 0;		/* set the binding location */
 	result = SC_fetch(stmt);
@@ -1906,12 +1918,16 @@ MYLOG(DETAIL_LOG_LEVEL, "just skipping deleted row " FORMAT_LEN "\n", currp);
 				{
 					rgfRowStatus[i] = pstatus;
 				}
+				else if (SQL_SUCCESS_WITH_INFO == result)
+					rgfRowStatus[i] = SQL_ROW_SUCCESS_WITH_INFO;
 				else
 					rgfRowStatus[i] = SQL_ROW_SUCCESS;
 				/* refresh the status */
 				/* if (SQL_ROW_DELETED != pstatus) */
 				res->keyset[currp].status &= (~KEYSET_INFO_PUBLIC);
 			}
+			else if (SQL_SUCCESS_WITH_INFO == result)
+				*(rgfRowStatus + i) = SQL_ROW_SUCCESS_WITH_INFO;
 			else
 				*(rgfRowStatus + i) = SQL_ROW_SUCCESS;
 		}
@@ -1925,6 +1941,18 @@ MYLOG(DETAIL_LOG_LEVEL, "just skipping deleted row " FORMAT_LEN "\n", currp);
 	}
 	if (SQL_ERROR == result)
 		goto cleanup;
+	if (columnar_cols > 0)
+	{
+		switch (SC_set_copy_result(stmt, copy_and_convert_rowset(stmt, i, rgfRowStatus), func))
+		{
+			case SQL_SUCCESS_WITH_INFO:
+				truncated = TRUE;
+				break;
+			case SQL_ERROR:
+				error = TRUE;
+				break;
+		}
+	}
 
 	/* Save the fetch count for SQLSetPos */
 	stmt->last_fetch_count = i;
@@ -1964,6 +1992,8 @@ MYLOG(DETAIL_LOG_LEVEL, "pcrow=" FORMAT_LEN "\n", i);
 
 cleanup:
 #undef	return
+	if (columnar_cols > 0)
+		reset_columnar_fetch(stmt);
 	return result;
 }
 
@@ -2131,9 +2161,11 @@ SQLLEN ClearCachedRows(TupleField *tuple, int num_fields, SQLLEN num_rows)
 		if (tuple->value)
 		{
 MYLOG(DETAIL_LOG_LEVEL, "freeing tuple[" FORMAT_LEN "][" FORMAT_LEN "].value=%p\n", i / num_fields, i % num_fields, tuple->value);
-			free(tuple->value);
+			if (!tuple->pooled)
+				free(tuple->value);
 			tuple->value = NULL;
 		}
+		tuple->pooled = FALSE;
 		tuple->len = -1;
 	}
 	return i;
@@ -2147,9 +2179,11 @@ MYLOG(DETAIL_LOG_LEVEL, "entering %p num_fields=%d num_rows=" FORMAT_LEN "\n", o
 	{
 		if (otuple->value)
 		{
-			free(otuple->value);
+			if (!otuple->pooled)
+				free(otuple->value);
 			otuple->value = NULL;
 		}
+		otuple->pooled = FALSE;
 		if (ituple->value)
 {
 			otuple->value = strdup(ituple->value);
@@ -2173,15 +2207,22 @@ MYLOG(DETAIL_LOG_LEVEL, "entering %p num_fields=%d num_rows=" FORMAT_LEN "\n", o
 	{
 		if (otuple->value)
 		{
-			free(otuple->value);
+			if (!otuple->pooled)
+				free(otuple->value);
 			otuple->value = NULL;
 		}
+		otuple->pooled = FALSE;
 		if (ituple->value)
 		{
-			otuple->value = ituple->value;
+			/* the pool of the source result doesn't survive it */
+			if (ituple->pooled)
+				otuple->value = strdup(ituple->value);
+			else
+				otuple->value = ituple->value;
 			ituple->value = NULL;
 MYLOG(DETAIL_LOG_LEVEL, "[%d,%d] %s copied\n", i / num_fields, i % num_fields, (const char *) otuple->value);
 		}
+		ituple->pooled = FALSE;
 		otuple->len = ituple->len;
 		ituple->len = -1;
 	}
@@ -3327,40 +3368,151 @@ SC_pos_reload(StatementClass *stmt, SQLULEN global_ridx, UInt2 *count, Int4 logK
 }
 
 static	const int	pre_fetch_count = 32;
+
+/*
+ * The hash table from the keys (oid, blocknum, offset) of the rows to
+ * reload to their global indexes, so that the reloaded rows are put back
+ * in the cache without scanning the whole rowset for each of them.
+ */
+typedef struct
+{
+	SQLLEN	*slots;		/* global index + 1, 0 means an empty slot */
+	SQLLEN	mask;
+} KeysetHash;
+
+static UInt4
+KH_hash(OID oid, UInt4 blocknum, UInt2 offset)
+{
+	UInt4	keys[3];
+
+	keys[0] = oid;
+	keys[1] = blocknum;
+	keys[2] = offset;
+	return hash_bytes(keys, sizeof(keys));
+}
+
+static BOOL
+KH_init(KeysetHash *kh, StatementClass *stmt, const QResultClass *res, SQLLEN limitrow)
+{
+	SQLLEN	i, kres_ridx, size, pos;
+	const KeySet	*keyset;
+
+	for (size = 16; size < 2 * (limitrow - SC_get_rowset_start(stmt)); size *= 2)
+		;
+	if (kh->slots = (SQLLEN *) calloc(size, sizeof(SQLLEN)), NULL == kh->slots)
+		return FALSE;
+	kh->mask = size - 1;
+	for (i = SC_get_rowset_start(stmt), kres_ridx = GIdx2KResIdx(i, stmt, res); i < limitrow; i++, kres_ridx++)
+	{
+		keyset = res->keyset + kres_ridx;
+		if (0 == (keyset->status & CURS_NEEDS_REREAD))
+			continue;
+		for (pos = KH_hash(keyset->oid, keyset->blocknum, keyset->offset) & kh->mask; 0 != kh->slots[pos]; pos = (pos + 1) & kh->mask)
+			;
+		kh->slots[pos] = i + 1;
+	}
+	return TRUE;
+}
+
+/* Returns the global index of the row with the keys, or -1 if none */
+static SQLLEN
+KH_lookup(const KeysetHash *kh, StatementClass *stmt, const QResultClass *res, OID oid, UInt4 blocknum, UInt2 offset)
+{
+	SQLLEN	pos, gidx;
+	const KeySet	*keyset;
+
+	for (pos = KH_hash(oid, blocknum, offset) & kh->mask; 0 != kh->slots[pos]; pos = (pos + 1) & kh->mask)
+	{
+		gidx = kh->slots[pos] - 1;
+		keyset = res->keyset + GIdx2KResIdx(gidx, stmt, res);
+		if (keyset->oid == oid &&
+		    keyset->blocknum == blocknum &&
+		    keyset->offset == offset)
+			return gidx;
+	}
+	return -1;
+}
+
+/* Move the reloaded rows in qres to their places in the cache of res */
+static void
+MoveReloadedRows(StatementClass *stmt, QResultClass *res, QResultClass *qres, const KeysetHash *kh)
+{
+	SQLLEN		j, k, l;
+	TupleField	*tuple, *tuplew;
+	UInt4		blocknum;
+	UInt2		offset;
+
+	for (j = 0; j < QR_get_num_total_read(qres); j++)
+	{
+		getTid(qres, j, &blocknum, &offset);
+		if (k = KH_lookup(kh, stmt, res, getOid(qres, j), blocknum, offset), k < 0)
+			continue;
+		l = GIdx2CacheIdx(k, stmt, res);
+		tuple = res->backend_tuples + res->num_fields * l;
+		tuplew = qres->backend_tuples + qres->num_fields * j;
+		MoveCachedRows(tuple, tuplew, res->num_fields, 1);
+		res->keyset[GIdx2KResIdx(k, stmt, res)].status &= ~CURS_NEEDS_REREAD;
+	}
+}
+
+/*
+ * Reload the rows which need to be reread by the prepared statement
+ * "_KEYSET_<res>", which looks up an array of ctids. At most
+ * KeysetReloadBatch rows are reloaded by one execution.
+ */
 static SQLLEN LoadFromKeyset(StatementClass *stmt, QResultClass * res, int rows_per_fetch, SQLLEN limitrow)
 {
 	CSTR	func = "LoadFromKeyset";
 	ConnectionClass	*conn = SC_get_conn(stmt);
 	SQLLEN	i;
-	int	j, rowc, rcnt = 0;
-	OID	oid;
+	int	rowc, rcnt = 0;
 	UInt4	blocknum;
 	SQLLEN	kres_ridx;
 	UInt2	offset;
-	PQExpBufferData	qval = {0};
-	int	keys_per_fetch = 10;
-
+	PQExpBufferData	qval;
+	int	keys_per_fetch = conn->connInfo.keyset_reload_batch;
+	KeysetHash	kh = {0};
+	QResultClass	*qres;
+
+	if (keys_per_fetch <= 0)
+		keys_per_fetch = DEFAULT_KEYSETRELOADBATCH;
+	initPQExpBuffer(&qval);
 #define	return	DONT_CALL_RETURN_FROM_HERE???
-	for (i = SC_get_rowset_start(stmt), kres_ridx = GIdx2KResIdx(i, stmt, res), rowc = 0;; i++, kres_ridx++)
+	if (!KH_init(&kh, stmt, res, limitrow))
 	{
-		if (i >= limitrow)
+		rcnt = -1;
+		SC_set_error(stmt, STMT_NO_MEMORY_ERROR, "Out of memory in LoadFromKeyset()", func);
+		goto cleanup;
+	}
+	if (0 == res->reload_count)
+	{
+		printfPQExpBuffer(&qval, "PREPARE \"_KEYSET_%p\"(tid[]) as %s where ctid = any($1)", res, stmt->load_statement);
+		if (PQExpBufferDataBroken(qval))
 		{
-			if (!rowc)
-				break;
-			if (res->reload_count > 0)
-			{
-				for (j = rowc; j < keys_per_fetch; j++)
-				{
-					appendPQExpBufferStr(&qval, j ? ",NULL" : "NULL");
-				}
-			}
-			rowc = -1; /* end of loop */
+			rcnt = -1;
+			SC_set_error(stmt, STMT_NO_MEMORY_ERROR, "Out of memory in LoadFromKeyset()", func);
+			goto cleanup;
 		}
-		if (rowc < 0 || rowc >= keys_per_fetch)
+		qres = CC_send_query(conn, qval.data, NULL, READ_ONLY_QUERY, stmt);
+		if (!QR_command_maybe_successful(qres))
 		{
-			QResultClass	*qres;
-
-			appendPQExpBufferStr(&qval, ")");
+			SC_set_error(stmt, STMT_EXEC_ERROR, "Prepare for Data Load Error", func);
+			rcnt = -1;
+			SC_set_Result(stmt, qres);
+			goto cleanup;
+		}
+		QR_Destructor(qres);
+		res->reload_count = 1;	/* the plan is prepared */
+	}
+	for (i = SC_get_rowset_start(stmt), kres_ridx = GIdx2KResIdx(i, stmt, res), rowc = 0;; i++, kres_ridx++)
+	{
+		if (i < limitrow &&
+		    0 == (res->keyset[kres_ridx].status & CURS_NEEDS_REREAD))
+			continue;
+		if (rowc > 0 &&
+		    (i >= limitrow || rowc >= keys_per_fetch))
+		{
+			appendPQExpBufferStr(&qval, "}')");
 			if (PQExpBufferDataBroken(qval))
 			{
 				rcnt = -1;
@@ -3368,134 +3520,30 @@ static SQLLEN LoadFromKeyset(StatementClass *stmt, QResultClass * res, int rows_
 				goto cleanup;
 			}
 			qres = CC_send_query(conn, qval.data, NULL, CREATE_KEYSET | READ_ONLY_QUERY, stmt);
-			if (QR_command_maybe_successful(qres))
-			{
-				SQLLEN		j, k, l;
-				Int2		m;
-				TupleField	*tuple, *tuplew;
-				UInt4		bln;
-				UInt2		off;
-
-				for (j = 0; j < QR_get_num_total_read(qres); j++)
-				{
-					oid = getOid(qres, j);
-					getTid(qres, j, &blocknum, &offset);
-					for (k = SC_get_rowset_start(stmt); k < limitrow; k++)
-					{
-						getTid(res, k, &bln, &off);
-						if (oid == getOid(res, k) &&
-						    bln == blocknum &&
-						    off == offset)
-						{
-							l = GIdx2CacheIdx(k, stmt, res);
-							tuple = res->backend_tuples + res->num_fields * l;
-							tuplew = qres->backend_tuples + qres->num_fields * j;
-							for (m = 0; m < res->num_fields; m++, tuple++, tuplew++)
-							{
-								if (tuple->len > 0 && tuple->value)
-									free(tuple->value);
-								tuple->value = tuplew->value;
-								tuple->len = tuplew->len;
-								tuplew->value = NULL;
-								tuplew->len = -1;
-							}
-							res->keyset[k].status &= ~CURS_NEEDS_REREAD;
-							break;
-						}
-					}
-				}
-			}
-			else
+			if (!QR_command_maybe_successful(qres))
 			{
 				SC_set_error(stmt, STMT_EXEC_ERROR, "Data Load Error", func);
 				rcnt = -1;
 				QR_Destructor(qres);
-				break;
+				goto cleanup;
 			}
+			MoveReloadedRows(stmt, res, qres, &kh);
 			QR_Destructor(qres);
-			if (rowc < 0)
-				break;
 			rowc = 0;
 		}
+		if (i >= limitrow)
+			break;
 		if (!rowc)
-		{
-			if (PQExpBufferDataBroken(qval))
-			{
-				initPQExpBuffer(&qval);
-
-				if (res->reload_count > 0)
-					keys_per_fetch = res->reload_count;
-				else
-				{
-					char	planname[32];
-					int	j;
-					QResultClass	*qres;
-
-					if (rows_per_fetch >= pre_fetch_count * 2)
-						keys_per_fetch = pre_fetch_count;
-					else
-						keys_per_fetch = rows_per_fetch;
-					if (!keys_per_fetch)
-						keys_per_fetch = 2;
-					SPRINTF_FIXED(planname, "_KEYSET_%p", res);
-					printfPQExpBuffer(&qval, "PREPARE \"%s\"", planname);
-					for (j = 0; j < keys_per_fetch; j++)
-					{
-						appendPQExpBufferStr(&qval, j ? ",tid" : "(tid");
-					}
-					appendPQExpBuffer(&qval, ") as %s where ctid in ", stmt->load_statement);
-					for (j = 0; j < keys_per_fetch; j++)
-					{
-						if (j == 0)
-							appendPQExpBufferStr(&qval, "($1");
-						else
-							appendPQExpBuffer(&qval, ",$%d", j + 1);
-					}
-					appendPQExpBufferStr(&qval, ")");
-					if (PQExpBufferDataBroken(qval))
-					{
-						rcnt = -1;
-						SC_set_error(stmt, STMT_NO_MEMORY_ERROR, "Out of memory in LoadFromKeyset()", func);
-						goto cleanup;
-					}
-					qres = CC_send_query(conn, qval.data, NULL, READ_ONLY_QUERY, stmt);
-					if (QR_command_maybe_successful(qres))
-					{
-						res->reload_count = keys_per_fetch;
-					}
-					else
-					{
-						SC_set_error(stmt, STMT_EXEC_ERROR, "Prepare for Data Load Error", func);
-						rcnt = -1;
-						SC_set_Result(stmt, qres);
-						break;
-					}
-					QR_Destructor(qres);
-				}
-			}
-			if (res->reload_count > 0)
-			{
-				printfPQExpBuffer(&qval, "EXECUTE \"_KEYSET_%p\"(", res);
-			}
-			else
-			{
-				printfPQExpBuffer(&qval, "%s where ctid in (", stmt->load_statement);
-			}
-		}
-		if (rcnt >= 0 &&
-		    0 != (res->keyset[kres_ridx].status & CURS_NEEDS_REREAD))
-		{
-			getTid(res, kres_ridx, &blocknum, &offset);
-			if (rowc)
-				appendPQExpBuffer(&qval, ",'(%u,%u)'", blocknum, offset);
-			else
-				appendPQExpBuffer(&qval, "'(%u,%u)'", blocknum, offset);
-			rowc++;
-			rcnt++;
-		}
+			printfPQExpBuffer(&qval, "EXECUTE \"_KEYSET_%p\"('{", res);
+		getTid(res, kres_ridx, &blocknum, &offset);
+		appendPQExpBuffer(&qval, rowc ? ",\"(%u,%u)\"" : "\"(%u,%u)\"", blocknum, offset);
+		rowc++;
+		rcnt++;
 	}
 cleanup:
 #undef	return
+	if (kh.slots)
+		free(kh.slots);
 	if (!PQExpBufferDataBroken(qval))
 		termPQExpBuffer(&qval);
 	return rcnt;
@@ -3505,7 +3553,7 @@ static SQLLEN LoadFromKeyset_inh(StatementClass *stmt, QResultClass * res, int r
 {
 	ConnectionClass	*conn = SC_get_conn(stmt);
 	SQLLEN	i;
-	int	j, rowc, rcnt = 0;
+	int	rowc, rcnt = 0;
 	OID	oid, new_oid;
 	UInt4	blocknum;
 	SQLLEN	kres_ridx;
@@ -3514,10 +3562,17 @@ static SQLLEN LoadFromKeyset_inh(StatementClass *stmt, QResultClass * res, int r
 	int	keys_per_fetch = 10;
 	const char *load_stmt = stmt->load_statement;
 	const ssize_t	from_pos = stmt->load_from_pos;
+	KeysetHash	kh = {0};
 
 MYLOG(0, "entering in rows_per_fetch=%d limitrow=" FORMAT_LEN "\n", rows_per_fetch, limitrow);
 	new_oid = 0;
 #define	return	DONT_CALL_RETURN_FROM_HERE???
+	if (!KH_init(&kh, stmt, res, limitrow))
+	{
+		rcnt = -1;
+		SC_set_error(stmt, STMT_NO_MEMORY_ERROR, "Out of memory in LoadFromKeyset_inh()", __FUNCTION__);
+		goto cleanup;
+	}
 	for (i = SC_get_rowset_start(stmt), kres_ridx = GIdx2KResIdx(i, stmt, res), rowc = 0, oid = 0;; i++, kres_ridx++)
 	{
 		if (i >= limitrow)
@@ -3546,43 +3601,7 @@ MYLOG(0, "entering in rows_per_fetch=%d limitrow=" FORMAT_LEN "\n", rows_per_fet
 			}
 			qres = CC_send_query(conn, qval.data, NULL, CREATE_KEYSET | READ_ONLY_QUERY, stmt);
 			if (QR_command_maybe_successful(qres))
-			{
-				SQLLEN		k, l;
-				Int2		m;
-				TupleField	*tuple, *tuplew;
-				UInt4		bln;
-				UInt2		off;
-				OID		tbloid;
-
-				for (j = 0; j < QR_get_num_total_read(qres); j++)
-				{
-					tbloid = getOid(qres, j);
-					getTid(qres, j, &blocknum, &offset);
-					for (k = SC_get_rowset_start(stmt); k < limitrow; k++)
-					{
-						getTid(res, k, &bln, &off);
-						if (tbloid == getOid(res, k) &&
-						    bln == blocknum &&
-						    off == offset)
-						{
-							l = GIdx2CacheIdx(k, stmt, res);
-							tuple = res->backend_tuples + res->num_fields * l;
-							tuplew = qres->backend_tuples + qres->num_fields * j;
-							for (m = 0; m < res->num_fields; m++, tuple++, tuplew++)
-							{
-								if (tuple->len > 0 && tuple->value)
-									free(tuple->value);
-								tuple->value = tuplew->value;
-								tuple->len = tuplew->len;
-								tuplew->value = NULL;
-								tuplew->len = -1;
-							}
-							res->keyset[k].status &= ~CURS_NEEDS_REREAD;
-							break;
-						}
-					}
-				}
-			}
+				MoveReloadedRows(stmt, res, qres, &kh);
 			else
 			{
 				SC_set_error(stmt, STMT_EXEC_ERROR, "Data Load Error", __FUNCTION__);
@@ -3601,12 +3620,9 @@ MYLOG(0, "entering in rows_per_fetch=%d limitrow=" FORMAT_LEN "\n", rows_per_fet
 
 			if (PQExpBufferDataBroken(qval))
 			{
-				if (rows_per_fetch >= pre_fetch_count * 2)
-					keys_per_fetch = pre_fetch_count;
-				else
-					keys_per_fetch = rows_per_fetch;
-				if (!keys_per_fetch)
-					keys_per_fetch = 2;
+				keys_per_fetch = conn->connInfo.keyset_reload_batch;
+				if (keys_per_fetch <= 0)
+					keys_per_fetch = DEFAULT_KEYSETRELOADBATCH;
 				initPQExpBuffer(&qval);
 			}
 			printfPQExpBuffer(&qval, "%.*sfrom %s where ctid in (", (int) from_pos, load_stmt, ti_quote(stmt, new_oid, table_fqn, sizeof(table_fqn)));
@@ -3623,6 +3639,8 @@ MYLOG(0, "entering in rows_per_fetch=%d limitrow=" FORMAT_LEN "\n", rows_per_fet
 	}
 cleanup:
 #undef	return
+	if (kh.slots)
+		free(kh.slots);
 	if (!PQExpBufferDataBroken(qval))
 		termPQExpBuffer(&qval);
 	return rcnt;
@@ -3834,8 +3852,14 @@ QR_get_rowstart_in_cache(res), SC_get_rowset_start(stmt), stmt->options.cursor_t
 				{
 					tuple_old[i].len = tuple_new[i].len;
 					tuple_new[i].len = -1;
-					tuple_old[i].value = tuple_new[i].value;
+					/* the pool of qres doesn't survive it */
+					if (tuple_new[i].pooled && NULL != tuple_new[i].value)
+						tuple_old[i].value = strdup(tuple_new[i].value);
+					else
+						tuple_old[i].value = tuple_new[i].value;
+					tuple_old[i].pooled = FALSE;
 					tuple_new[i].value = NULL;
+					tuple_new[i].pooled = FALSE;
 				}
 				res->num_cached_rows++;
 			}
@@ -265,6 +265,12 @@ PGAPI_FreeStmt(HSTMT hstmt,
 				SC_set_error(stmt, STMT_SEQUENCE_ERROR, "Statement is currently executing a transaction.", func);
 				return SQL_ERROR; /* stmt may be executing a transaction */
 			}
+			if (CC_is_async_executing(conn, stmt))
+			{
+				ENTER_CONN_CS(conn);
+				CC_discard_async_query(conn);
+				LEAVE_CONN_CS(conn);
+			}
 			if (conn->unnamed_prepared_stmt == stmt)
 				conn->unnamed_prepared_stmt = NULL;
 
@@ -303,12 +309,20 @@ PGAPI_FreeStmt(HSTMT hstmt,
 		 * this should discard all the results, but leave the statement
 		 * itself in place (it can be executed again)
 		 */
+		ConnectionClass *conn = SC_get_conn(stmt);
+
 		stmt->transition_status = STMT_TRANSITION_ALLOCATED;
 		if (stmt->execute_delegate)
 		{
 			PGAPI_FreeStmt(stmt->execute_delegate, SQL_DROP);
 			stmt->execute_delegate = NULL;
 		}
+		if (CC_is_async_executing(conn, stmt))
+		{
+			ENTER_CONN_CS(conn);
+			CC_discard_async_query(conn);
+			LEAVE_CONN_CS(conn);
+		}
 		if (!SC_recycle_statement(stmt))
 		{
 			return SQL_ERROR;
@@ -419,9 +433,17 @@ SC_Constructor(ConnectionClass *conn)
 		rv->ref_CC_error = FALSE;
 		rv->join_info = 0;
 		rv->curr_param_result = 0;
+		rv->binary_result = FALSE;
+		rv->plan_cached = FALSE;
+		rv->async_request = FALSE;
+#ifdef	USE_ASYNC_NOTIFICATION
+		rv->async_callback = rv->async_context = NULL;
+#endif /* USE_ASYNC_NOTIFICATION */
 		SC_init_parse_method(rv);
 
 		rv->lobj_fd = -1;
+		rv->lobj_wbuf = NULL;
+		rv->lobj_wbufused = 0;
 		INIT_NAME(rv->cursor_name);
 
 		/* Parse Stuff */
@@ -465,7 +487,9 @@ SC_Constructor(ConnectionClass *conn)
 			rv->batch_size = 1;
 		rv->exec_type = DIRECT_EXEC;
 		rv->count_of_deffered = 0;
+		rv->pipeline_start_row = rv->pipeline_end_row = -1;
 		rv->has_notice = 0;
+		rv->metrics_idx = -1;
 		INIT_STMT_CS(rv);
 	}
 	return rv;
@@ -506,6 +530,8 @@ SC_Destructor(StatementClass *self)
 	DC_Destructor((DescriptorClass *) SC_get_IPDi(self));
 	GDATA_unbind_cols(SC_get_GDTI(self), TRUE);
 	PDATA_free_params(SC_get_PDTI(self), STMT_FREE_PARAMS_ALL);
+	if (self->lobj_wbuf)
+		free(self->lobj_wbuf);
 
 	if (self->__error_message)
 		free(self->__error_message);
@@ -692,7 +718,12 @@ SC_set_prepared(StatementClass *stmt, int prepared)
 			ENTER_CONN_CS(conn);
 			if (CONN_CONNECTED == conn->status)
 			{
-				if (CC_is_in_error_trans(conn))
+				if (stmt->plan_cached)
+				{
+					/* the plan is shared through the plan cache */
+					CC_release_plan(conn, stmt->plan_name);
+				}
+				else if (CC_is_in_error_trans(conn))
 				{
 					CC_mark_a_object_to_discard(conn, 's',  stmt->plan_name);
 				}
@@ -710,7 +741,11 @@ SC_set_prepared(StatementClass *stmt, int prepared)
 		}
 	}
 	if (NOT_YET_PREPARED == prepared)
+	{
 		SC_set_planname(stmt, NULL);
+		stmt->binary_result = FALSE;
+		stmt->plan_cached = FALSE;
+	}
 	stmt->prepared = prepared;
 }
 
@@ -1660,7 +1695,7 @@ SC_fetch(StatementClass *self)
 	ARDFields	*opts;
 	GetDataInfo	*gdata;
 	int		retval;
-	RETCODE		result;
+	RETCODE		result, ret;
 
 	Int2		num_cols,
 				lf;
@@ -1786,6 +1821,9 @@ MYLOG(DETAIL_LOG_LEVEL, "stmt=%p ommitted++\n", self);
 
 		if (NULL == opts->bindings)
 			continue;
+		/* converted by copy_and_convert_rowset() */
+		if (0 != opts->bindings[lf].fetch_kernel)
+			continue;
 		if (opts->bindings[lf].buffer != NULL)
 		{
 			/* this column has a binding */
@@ -1812,52 +1850,63 @@ MYLOG(DETAIL_LOG_LEVEL, "curt=" FORMAT_LEN "\n", curt);
 
 			MYLOG(0, "copy_and_convert: retval = %d\n", retval);
 
-			switch (retval)
+			if (COPY_RESULT_TRUNCATED == retval)
 			{
-				case COPY_OK:
-					break;		/* OK, do next bound column */
+				MYLOG(DETAIL_LOG_LEVEL, "The %dth item was truncated\n", lf + 1);
+				MYLOG(DETAIL_LOG_LEVEL, "The buffer size = " FORMAT_LEN, opts->bindings[lf].buflen);
+				MYLOG(DETAIL_LOG_LEVEL, " and the value is '%s'\n", value);
+			}
+			if (SQL_SUCCESS != (ret = SC_set_copy_result(self, retval, func)))
+				result = ret;
+		}
+	}
 
-				case COPY_UNSUPPORTED_TYPE:
-					SC_set_error(self, STMT_RESTRICTED_DATA_TYPE_ERROR, "Received an unsupported type from Postgres.", func);
-					result = SQL_ERROR;
-					break;
+	return result;
+}
 
-				case COPY_UNSUPPORTED_CONVERSION:
-					SC_set_error(self, STMT_RESTRICTED_DATA_TYPE_ERROR, "Couldn't handle the necessary data type conversion.", func);
-					result = SQL_ERROR;
-					break;
 
-				case COPY_RESULT_TRUNCATED:
-					SC_set_error(self, STMT_TRUNCATED, "Fetched item was truncated.", func);
-					MYLOG(DETAIL_LOG_LEVEL, "The %dth item was truncated\n", lf + 1);
-					MYLOG(DETAIL_LOG_LEVEL, "The buffer size = " FORMAT_LEN, opts->bindings[lf].buflen);
-					MYLOG(DETAIL_LOG_LEVEL, " and the value is '%s'\n", value);
-					result = SQL_SUCCESS_WITH_INFO;
-					break;
+/*
+ *	Set the error of a copy_and_convert_field() (or
+ *	copy_and_convert_rowset()) result and return the fetch result.
+ */
+RETCODE
+SC_set_copy_result(StatementClass *self, int retval, const char *func)
+{
+	switch (retval)
+	{
+		case COPY_OK:
+			break;		/* OK, do next bound column */
 
-				case COPY_INVALID_STRING_CONVERSION:    /* invalid string */
-					SC_set_error(self, STMT_STRING_CONVERSION_ERROR, "invalid string conversion occured.", func);
-					result = SQL_ERROR;
-					break;
+		case COPY_UNSUPPORTED_TYPE:
+			SC_set_error(self, STMT_RESTRICTED_DATA_TYPE_ERROR, "Received an unsupported type from Postgres.", func);
+			return SQL_ERROR;
 
-					/* error msg already filled in */
-				case COPY_GENERAL_ERROR:
-					result = SQL_ERROR;
-					break;
+		case COPY_UNSUPPORTED_CONVERSION:
+			SC_set_error(self, STMT_RESTRICTED_DATA_TYPE_ERROR, "Couldn't handle the necessary data type conversion.", func);
+			return SQL_ERROR;
 
-					/* This would not be meaningful in SQLFetch. */
-				case COPY_NO_DATA_FOUND:
-					break;
+		case COPY_RESULT_TRUNCATED:
+			SC_set_error(self, STMT_TRUNCATED, "Fetched item was truncated.", func);
+			return SQL_SUCCESS_WITH_INFO;
 
-				default:
-					SC_set_error(self, STMT_INTERNAL_ERROR, "Unrecognized return value from copy_and_convert_field.", func);
-					result = SQL_ERROR;
-					break;
-			}
-		}
+		case COPY_INVALID_STRING_CONVERSION:    /* invalid string */
+			SC_set_error(self, STMT_STRING_CONVERSION_ERROR, "invalid string conversion occured.", func);
+			return SQL_ERROR;
+
+			/* error msg already filled in */
+		case COPY_GENERAL_ERROR:
+			return SQL_ERROR;
+
+			/* This would not be meaningful in SQLFetch. */
+		case COPY_NO_DATA_FOUND:
+			break;
+
+		default:
+			SC_set_error(self, STMT_INTERNAL_ERROR, "Unrecognized return value from copy_and_convert_field.", func);
+			return SQL_ERROR;
 	}
 
-	return result;
+	return SQL_SUCCESS;
 }
 
 
@@ -1877,7 +1926,7 @@ SC_execute(StatementClass *self)
 	BOOL		is_in_trans, issue_begin, has_out_para;
 	BOOL		use_extended_protocol;
 	int		func_cs_count = 0, i;
-	BOOL		useCursor, isSelectType;
+	BOOL		useCursor, isSelectType, async_sent = FALSE;
 	int		errnum_sav = STMT_OK, errnum;
 	char		*errmsg_sav = NULL;
 	SQLULEN		stmt_timeout;
@@ -1911,6 +1960,8 @@ SC_execute(StatementClass *self)
 		MYLOG(0, "problem with connection\n");
 		goto cleanup;
 	}
+	if (CC_collects_metrics(conn))
+		CC_count_execute(conn, self);
 	is_in_trans = CC_is_in_trans(conn);
 	if ((useCursor = SC_is_fetchcursor(self)))
 	{
@@ -2001,14 +2052,26 @@ SC_execute(StatementClass *self)
 		use_extended_protocol = TRUE;
 	}
 	isSelectType = (SC_may_use_cursor(self) || self->statement_type == STMT_TYPE_PROCCALL);
+	if (self->async_request && !useCursor)
+		qflag |= SEND_ASYNCHRONOUSLY;
 	if (use_extended_protocol)
 	{
 		QResultClass *first;
 
+		Int8	start_usec;
+
 		if (issue_begin)
 			CC_begin(conn);
 
+		start_usec = METRICS_START(conn);
 		first = libpq_bind_and_exec(self);
+		if (start_usec > 0)
+		{
+			PG_Metrics	metrics = {0};
+
+			metrics.exec_usec = get_clock_usec() - start_usec;
+			CC_add_metrics(conn, self, &metrics);
+		}
 		if (!first)
 		{
 			if (SC_get_errornumber(self) <= 0)
@@ -2018,6 +2081,9 @@ SC_execute(StatementClass *self)
 			goto cleanup;
 		}
 		rhold = (QResultHold) {first, first};
+		/* the results of pipelined rows are chained */
+		while (QR_nextr(rhold.last))
+			rhold.last = QR_nextr(rhold.last);
 	}
 	else if (isSelectType)
 	{
@@ -2100,6 +2166,12 @@ SC_execute(StatementClass *self)
 		MYLOG(0, "      it's NOT a select statement: stmt=%p\n", self);
 		rhold = CC_send_query_append(conn, self->stmt_with_params, NULL, qflag, SC_get_ancestor(self), NULL);
 	}
+	if (CC_is_async_executing(conn, SC_get_ancestor(self)))
+	{
+		/* the execution is replayed when the query completes */
+		async_sent = TRUE;
+		goto cleanup;
+	}
 
 	if (!isSelectType)
 	{
@@ -2206,7 +2278,9 @@ MYLOG(DETAIL_LOG_LEVEL, "!!%p->miscinfo=%x res=%p\n", self, self->miscinfo, firs
 	else
 	{
 		/* Bad Error -- The error message will be in the Connection */
-		if (!conn->pqconn)
+		if (0 < SC_get_errornumber(self))
+			;	/* already set when the query wasn't sent */
+		else if (!conn->pqconn)
 			SC_set_error(self, STMT_BAD_ERROR, CC_get_errormsg(conn), func);
 		else if (self->statement_type == STMT_TYPE_CREATE)
 		{
@@ -2334,6 +2408,8 @@ cleanup:
 	if (NULL != errmsg_sav)
 		free(errmsg_sav);
 
+	if (async_sent)
+		return SQL_STILL_EXECUTING;
 	if (errnum == STMT_OK)
 		return SQL_SUCCESS;
 	else if (errnum < STMT_OK)
@@ -2481,6 +2557,7 @@ RequestStart(StatementClass *stmt, ConnectionClass *conn, const char *func)
 		SC_set_error(stmt, STMT_COMMUNICATION_ERROR, "The connection has been lost", __FUNCTION__);
 		return SQL_ERROR;
 	}
+	CC_finish_prefetch(conn);
 	if (CC_started_rbpoint(conn))
 		return TRUE;
 	if (SC_is_readonly(stmt))
@@ -2547,6 +2624,327 @@ QResultClass *add_libpq_notice_receiver(StatementClass *stmt, notice_receiver_ar
 	return newres;
 }
 
+/*
+ * Store the result of an extended query protocol execution in res.
+ *
+ * Returns FALSE if the tuples couldn't be read.
+ */
+static BOOL
+libpq_receive_result(StatementClass *stmt, QResultClass *res, PGresult **pgres)
+{
+	CSTR		func = "libpq_receive_result";
+	ConnectionClass	*conn = SC_get_conn(stmt);
+	int			pgresstatus;
+	char	   *cmdtag;
+	char	   *rowcount;
+
+	pgresstatus = PQresultStatus(*pgres);
+	switch (pgresstatus)
+	{
+		case PGRES_COMMAND_OK:
+			/* portal query command, no tuples returned */
+			/* read in the return message from the backend */
+			cmdtag = PQcmdStatus(*pgres);
+			QLOG(0, "\tok: - 'C' - %s\n", cmdtag);
+			QR_set_command(res, cmdtag);
+			if (QR_command_successful(res))
+				QR_set_rstatus(res, PORES_COMMAND_OK);
+
+			/* get rowcount */
+			rowcount = PQcmdTuples(*pgres);
+			if (rowcount && rowcount[0])
+				res->recent_processed_row_count = atoi(rowcount);
+			else
+				res->recent_processed_row_count = -1;
+			break;
+
+		case PGRES_EMPTY_QUERY:
+			/* We return the empty query */
+			QR_set_rstatus(res, PORES_EMPTY_QUERY);
+			break;
+		case PGRES_NONFATAL_ERROR:
+			handle_pgres_error(conn, *pgres, "libpq_bind_and_exec", res, FALSE);
+			break;
+
+		case PGRES_BAD_RESPONSE:
+		case PGRES_FATAL_ERROR:
+			handle_pgres_error(conn, *pgres, "libpq_bind_and_exec", res, TRUE);
+			break;
+		case PGRES_TUPLES_OK:
+			if (!QR_from_PGresult(res, stmt, conn, NULL, pgres))
+				return FALSE;
+			if (res->rstatus == PORES_TUPLES_OK && res->notice)
+				QR_set_rstatus(res, PORES_NONFATAL_ERROR);
+			break;
+#ifdef	HAVE_PQENTERPIPELINEMODE
+		case PGRES_PIPELINE_ABORTED:
+			/* a preceding query of the pipeline failed */
+			QR_set_rstatus(res, PORES_FATAL_ERROR);
+			QR_set_message(res, "the query was not executed because of an error of a preceding query in the pipeline");
+			break;
+#endif /* HAVE_PQENTERPIPELINEMODE */
+		case PGRES_COPY_OUT:
+		case PGRES_COPY_IN:
+		case PGRES_COPY_BOTH:
+		default:
+			/* skip the unexpected response if possible */
+			QR_set_rstatus(res, PORES_BAD_RESPONSE);
+			CC_set_error(conn, CONNECTION_BACKEND_CRAZY, "Unexpected protocol character from backend (send_query)", func);
+			CC_on_abort(conn, CONN_DEAD);
+
+			QLOG(0, "PQexecXxxx error: - (%d) - %s\n", pgresstatus, CC_get_errormsg(conn));
+			break;
+	}
+
+	return TRUE;
+}
+
+#ifdef	HAVE_PQENTERPIPELINEMODE
+/* The bind parameters of a row sent in pipeline mode */
+typedef struct
+{
+	SQLLEN		row;
+	int			nParams;
+	Oid		   *paramTypes;
+	char	  **paramValues;
+	int		   *paramLengths;
+	int		   *paramFormats;
+	int			resultFormat;
+} PipelineRow;
+
+static void
+free_pipeline_rows(PipelineRow *prows, int count)
+{
+	int			i, j;
+
+	for (i = 0; i < count; i++)
+	{
+		if (prows[i].paramValues)
+		{
+			for (j = 0; j < prows[i].nParams; j++)
+			{
+				if (prows[i].paramValues[j] != NULL)
+					free(prows[i].paramValues[j]);
+			}
+			free(prows[i].paramValues);
+		}
+		if (prows[i].paramTypes)
+			free(prows[i].paramTypes);
+		if (prows[i].paramLengths)
+			free(prows[i].paramLengths);
+		if (prows[i].paramFormats)
+			free(prows[i].paramFormats);
+	}
+	free(prows);
+}
+
+/*
+ * Execute the parameter rows from stmt->pipeline_start_row to
+ * stmt->pipeline_end_row in libpq pipeline mode, so that all of them
+ * cost one round trip.
+ *
+ * The parameters of all the rows are built before anything is sent, and
+ * the rows are executed in the implicit transaction of one pipeline sync.
+ * The results of the rows are chained in the order of the rows. If a row
+ * fails, the other rows were rolled back together with it, and only the
+ * result of the failed row is returned.
+ */
+static QResultClass *
+libpq_pipeline_bind_and_exec(StatementClass *stmt)
+{
+	CSTR		func = "libpq_pipeline_bind_and_exec";
+	ConnectionClass	*conn = SC_get_conn(stmt);
+	APDFields	*apdopts = SC_get_APDF(stmt);
+	SQLLEN		row, save_current_row = stmt->exec_current_row;
+	PipelineRow	*prows, *prow;
+	int			i, nrows = 0, nsent = 0, sent;
+	const char *plan_name = NULL;
+	ProcessedStmt *pstmt = NULL;
+	PGresult   *pgres;
+	QResultClass	*first = NULL, *last = NULL, *failed = NULL, *res;
+	notice_receiver_arg	nrarg;
+
+	if (stmt->prepared == NOT_YET_PREPARED ||
+		(stmt->prepared == PREPARED_TEMPORARILY && conn->unnamed_prepared_stmt != stmt))
+	{
+		SC_set_error(stmt, STMT_EXEC_ERROR, "about to execute a non-prepared statement", func);
+		return NULL;
+	}
+
+	/* 1. Bind every row */
+	prows = (PipelineRow *) calloc(stmt->pipeline_end_row - stmt->pipeline_start_row + 1, sizeof(PipelineRow));
+	if (NULL == prows)
+	{
+		SC_set_error(stmt, STMT_NO_MEMORY_ERROR, "Could not allocate the pipeline rows", func);
+		return NULL;
+	}
+	for (row = stmt->pipeline_start_row; row <= stmt->pipeline_end_row; row++)
+	{
+		if (apdopts->param_operation_ptr &&
+			SQL_PARAM_IGNORE == apdopts->param_operation_ptr[row])
+			continue;
+		prow = prows + nrows;
+		prow->row = stmt->exec_current_row = row;
+		if (!build_libpq_bind_params(stmt,
+									 &prow->nParams,
+									 &prow->paramTypes,
+									 &prow->paramValues,
+									 &prow->paramLengths, &prow->paramFormats,
+									 &prow->resultFormat))
+		{
+			stmt->exec_current_row = save_current_row;
+			if (SC_get_errornumber(stmt) <= 0)
+				SC_set_errornumber(stmt, STMT_NO_MEMORY_ERROR);
+			free_pipeline_rows(prows, nrows + 1);
+			return NULL;
+		}
+		nrows++;
+	}
+	stmt->exec_current_row = save_current_row;
+
+	/* 1.5 Prepare and Describe if needed, before entering the pipeline */
+	if (stmt->prepared == PREPARING_TEMPORARILY)
+	{
+		if (!stmt->processed_statements)
+		{
+			if (prepareParametersNoDesc(stmt, FALSE, EXEC_PARAM_CAST) == SQL_ERROR)
+				goto cleanup;
+		}
+		pstmt = stmt->processed_statements;
+	}
+	else
+	{
+		if (stmt->prepared == PREPARING_PERMANENTLY)
+		{
+			if (prepareParameters(stmt, FALSE) == SQL_ERROR)
+				goto cleanup;
+		}
+		plan_name = stmt->plan_name ? stmt->plan_name : NULL_STRING;
+	}
+
+	/* 2. Send every row and a sync */
+	CC_finish_prefetch(conn);
+	if (!PQenterPipelineMode(conn->pqconn))
+	{
+		SC_set_error(stmt, STMT_EXEC_ERROR, "Could not enter the pipeline mode", func);
+		goto cleanup;
+	}
+	for (i = 0; i < nrows; i++)
+	{
+		prow = prows + i;
+		if (pstmt)
+		{
+			QLOG(0, "PQsendQueryParams: %p '%s' nParams=%d row=" FORMAT_LEN "\n", conn->pqconn, pstmt->query, prow->nParams, prow->row);
+			log_params(prow->nParams, prow->paramTypes, (const UCHAR * const *) prow->paramValues, prow->paramLengths, prow->paramFormats, prow->resultFormat);
+			sent = PQsendQueryParams(conn->pqconn,
+									 pstmt->query,
+									 prow->nParams,
+									 prow->paramTypes,
+									 (const char **) prow->paramValues,
+									 prow->paramLengths,
+									 prow->paramFormats,
+									 prow->resultFormat);
+		}
+		else
+		{
+			QLOG(0, "PQsendQueryPrepared: %p plan=%s nParams=%d row=" FORMAT_LEN "\n", conn->pqconn, plan_name, prow->nParams, prow->row);
+			log_params(prow->nParams, prow->paramTypes, (const UCHAR * const *) prow->paramValues, prow->paramLengths, prow->paramFormats, prow->resultFormat);
+			sent = PQsendQueryPrepared(conn->pqconn,
+									   plan_name, 	/* portal name == plan name */
+									   prow->nParams,
+									   (const char **) prow->paramValues,
+									   prow->paramLengths,
+									   prow->paramFormats,
+									   prow->resultFormat);
+		}
+		if (!sent)
+			break;
+		nsent++;
+	}
+	if (nsent < nrows || !PQpipelineSync(conn->pqconn))
+	{
+		SC_set_error(stmt, STMT_EXEC_ERROR, PQerrorMessage(conn->pqconn), func);
+		CC_on_abort(conn, CONN_DEAD);
+		goto cleanup;
+	}
+
+	/* 3. Receive the results of the rows in order */
+	nrarg.conn = conn;
+	nrarg.comment = func;
+	nrarg.res = NULL;
+	nrarg.stmt = stmt;
+	PQsetNoticeReceiver(conn->pqconn, receive_libpq_notice, &nrarg);
+	for (i = 0; i < nsent; i++)
+	{
+		if (res = QR_Constructor(), NULL == res)
+		{
+			SC_set_error(stmt, STMT_NO_MEMORY_ERROR, "Out of memory while allocating result set", func);
+			break;
+		}
+		nrarg.res = res;
+		if (NULL == last)
+			first = res;
+		else
+			QR_concat(last, res);
+		last = res;
+
+		/* the results of each query are followed by a NULL */
+		while (pgres = PQgetResult(conn->pqconn), NULL != pgres)
+		{
+			if (!libpq_receive_result(stmt, res, &pgres))
+				QR_set_rstatus(res, PORES_NO_MEMORY_ERROR);
+			if (pgres)
+				PQclear(pgres);
+		}
+		if (NULL == failed && !QR_command_maybe_successful(res))
+			failed = res;
+	}
+	/* reset notice receiver */
+	PQsetNoticeReceiver(conn->pqconn, receive_libpq_notice, NULL);
+
+	/* skip the results of the rows not received (out of memory) */
+	for (; i < nsent; i++)
+	{
+		while (pgres = PQgetResult(conn->pqconn), NULL != pgres)
+			PQclear(pgres);
+	}
+	/* skip to the sync point and leave the pipeline mode */
+	while (pgres = PQgetResult(conn->pqconn), NULL != pgres &&
+		   PGRES_PIPELINE_SYNC != PQresultStatus(pgres))
+		PQclear(pgres);
+	if (pgres)
+		PQclear(pgres);
+	if (!PQexitPipelineMode(conn->pqconn))
+	{
+		SC_set_error_if_not_set(stmt, STMT_EXEC_ERROR, PQerrorMessage(conn->pqconn), func);
+		CC_on_abort(conn, CONN_DEAD);
+	}
+
+	/* the other rows were rolled back with the failed one, return the error only */
+	if (NULL != failed)
+	{
+		if (failed != first)
+		{
+			for (res = first; QR_nextr(res) != failed; res = QR_nextr(res))
+				;
+			QR_detach(res);
+			QR_Destructor(first);
+			first = failed;
+		}
+		if (NULL != QR_nextr(failed))
+		{
+			QR_Destructor(QR_nextr(failed));
+			QR_detach(failed);
+		}
+	}
+
+cleanup:
+	free_pipeline_rows(prows, nrows);
+
+	return first;
+}
+#endif /* HAVE_PQENTERPIPELINEMODE */
+
 static QResultClass *
 libpq_bind_and_exec(StatementClass *stmt)
 {
@@ -2559,16 +2957,18 @@ libpq_bind_and_exec(StatementClass *stmt)
 	int		   *paramFormats = NULL;
 	int			resultFormat;
 	PGresult   *pgres = NULL;
-	int			pgresstatus;
 	QResultClass	*newres = NULL;
 	QResultClass *res = NULL;
-	char	   *cmdtag;
-	char	   *rowcount;
 	notice_receiver_arg	nrarg;
 
 	if (!RequestStart(stmt, conn, func))
 		return NULL;
 
+#ifdef	HAVE_PQENTERPIPELINEMODE
+	if (PIPELINE_EXEC == stmt->exec_type)
+		return libpq_pipeline_bind_and_exec(stmt);
+#endif /* HAVE_PQENTERPIPELINEMODE */
+
 #ifdef	NOT_USED
 	if (CC_is_in_trans(conn) && !CC_started_rbpoint(conn))
 	{
@@ -2645,6 +3045,17 @@ libpq_bind_and_exec(StatementClass *stmt)
 		/* prepareParameters() set plan name, so don't fetch this earlier */
 		plan_name = stmt->plan_name ? stmt->plan_name : NULL_STRING;
 
+		/*
+		 * libpq applies the result format to all the columns, so receive
+		 * the result in binary only if copy_and_convert_field() is able to
+		 * decode every described column and no keyset is needed.
+		 */
+		if (stmt->binary_result &&
+			stmt->external &&
+			!SC_is_fetchcursor(stmt) &&
+			SQL_CONCUR_READ_ONLY == stmt->options.scroll_concurrency)
+			resultFormat = 1;
+
 		/* already prepared */
 		QLOG(0, "PQexecPrepared: %p plan=%s nParams=%d\n", conn->pqconn, plan_name, nParams);
 		log_params(nParams, paramTypes, (const UCHAR * const *) paramValues, paramLengths, paramFormats, resultFormat);
@@ -2666,59 +3077,11 @@ libpq_bind_and_exec(StatementClass *stmt)
 
 	/* 3. Receive results */
 MYLOG(DETAIL_LOG_LEVEL, "get_Result=%p %p %d\n", res, SC_get_Result(stmt), stmt->curr_param_result);
-	pgresstatus = PQresultStatus(pgres);
-	switch (pgresstatus)
-	{
-		case PGRES_COMMAND_OK:
-			/* portal query command, no tuples returned */
-			/* read in the return message from the backend */
-			cmdtag = PQcmdStatus(pgres);
-			QLOG(0, "\tok: - 'C' - %s\n", cmdtag);
-			QR_set_command(res, cmdtag);
-			if (QR_command_successful(res))
-				QR_set_rstatus(res, PORES_COMMAND_OK);
-
-			/* get rowcount */
-			rowcount = PQcmdTuples(pgres);
-			if (rowcount && rowcount[0])
-				res->recent_processed_row_count = atoi(rowcount);
-			else
-				res->recent_processed_row_count = -1;
-			break;
+	if (!libpq_receive_result(stmt, res, &pgres))
+		goto cleanup;
 
-		case PGRES_EMPTY_QUERY:
-			/* We return the empty query */
-			QR_set_rstatus(res, PORES_EMPTY_QUERY);
-			break;
-		case PGRES_NONFATAL_ERROR:
-			handle_pgres_error(conn, pgres, "libpq_bind_and_exec", res, FALSE);
-			break;
-
-		case PGRES_BAD_RESPONSE:
-		case PGRES_FATAL_ERROR:
-			handle_pgres_error(conn, pgres, "libpq_bind_and_exec", res, TRUE);
-			break;
-		case PGRES_TUPLES_OK:
-			if (!QR_from_PGresult(res, stmt, conn, NULL, &pgres))
-				goto cleanup;
-			if (res->rstatus == PORES_TUPLES_OK && res->notice)
-				QR_set_rstatus(res, PORES_NONFATAL_ERROR);
-			break;
-		case PGRES_COPY_OUT:
-		case PGRES_COPY_IN:
-		case PGRES_COPY_BOTH:
-		default:
-			/* skip the unexpected response if possible */
-			QR_set_rstatus(res, PORES_BAD_RESPONSE);
-			CC_set_error(conn, CONNECTION_BACKEND_CRAZY, "Unexpected protocol character from backend (send_query)", func);
-			CC_on_abort(conn, CONN_DEAD);
-
-			QLOG(0, "PQexecXxxx error: - (%d) - %s\n", pgresstatus, CC_get_errormsg(conn));
-			break;
-	}
-
-	if (res != newres && NULL != newres)
-		QR_Destructor(newres);
+	if (res != newres && NULL != newres)
+		QR_Destructor(newres);
 
 cleanup:
 	if (pgres)
@@ -2743,29 +3106,177 @@ cleanup:
 	return res;
 }
 
+#define	COPY_IN_CHUNK_SIZE	(64 * 1024)	/* flush unit of the COPY data */
+
 /*
- * Parse a query using libpq.
+ * Execute the parameter rows from start_row to end_row as the data of
+ * copy_query, a COPY ... FROM STDIN command equivalent to the INSERT
+ * statement of stmt. *nrows is set to the number of the rows sent.
  *
- * 'res' is only passed here for error reporting purposes. If an error is
- * encountered, it is set in 'res', and the function returns FALSE.
+ * The COPY succeeds or fails as a whole, so the rows are all inserted or
+ * none of them is.
  */
-static BOOL
-ParseWithLibpq(StatementClass *stmt, const char *plan_name,
-			   const char *query,
-			   Int2 num_params, const char *comment, QResultClass *res)
+RETCODE
+SC_execute_copy_in(StatementClass *self, const char *copy_query, SQLLEN start_row, SQLLEN end_row, SQLLEN *nrows)
 {
-	CSTR	func = "ParseWithLibpq";
-	ConnectionClass	*conn = SC_get_conn(stmt);
-	Int4		sta_pidx = -1, end_pidx = -1;
-	const char	*cstatus;
-	Oid		   *paramTypes = NULL;
-	BOOL		retval = FALSE;
+	CSTR		func = "SC_execute_copy_in";
+	ConnectionClass	*conn = SC_get_conn(self);
+	APDFields	*apdopts = SC_get_APDF(self);
+	SQLLEN		row, save_current_row = self->exec_current_row;
+	Int2		oldstatus;
+	int			func_cs_count = 0;
+	PQExpBufferData	buf = {0};
+	const char *errmsg = NULL;
 	PGresult   *pgres = NULL;
+	QResultClass	*res = NULL;
+	notice_receiver_arg	nrarg;
+	RETCODE		ret = SQL_ERROR;
+	Int8		start_usec = 0;
 
-	MYLOG(0, "entering plan_name=%s query=%s\n", plan_name, query);
-	if (!RequestStart(stmt, conn, func))
-		return FALSE;
+	*nrows = 0;
+#define	return	DONT_CALL_RETURN_FROM_HERE???
+	ENTER_INNER_CONN_CS(conn, func_cs_count);
+	oldstatus = conn->status;
+	if (CONN_EXECUTING == conn->status)
+	{
+		SC_set_error(self, STMT_SEQUENCE_ERROR, "Connection is already in use.", func);
+		goto cleanup;
+	}
+	if (!SC_SetExecuting(self, TRUE))
+	{
+		SC_set_error(self, STMT_OPERATION_CANCELLED, "Cancel Reuest Accepted", func);
+		goto cleanup;
+	}
+	conn->status = CONN_EXECUTING;
+	if (!RequestStart(self, conn, func))
+		goto cleanup;
+	if (res = QR_Constructor(), NULL == res)
+	{
+		SC_set_error(self, STMT_NO_MEMORY_ERROR, "Out of memory while allocating result set", func);
+		goto cleanup;
+	}
+	nrarg.conn = conn;
+	nrarg.comment = func;
+	nrarg.res = res;
+	nrarg.stmt = self;
+	PQsetNoticeReceiver(conn->pqconn, receive_libpq_notice, &nrarg);
+	if (start_usec = METRICS_START(conn), start_usec > 0)
+		CC_count_execute(conn, self);
+
+	/* 1. Start the COPY */
+	QLOG(0, "PQexec: %p '%s'\n", conn->pqconn, copy_query);
+	pgres = PQexec(conn->pqconn, copy_query);
+	if (PGRES_COPY_IN != PQresultStatus(pgres))
+	{
+		if (!libpq_receive_result(self, res, &pgres))
+			QR_set_rstatus(res, PORES_NO_MEMORY_ERROR);
+		goto receive_done;
+	}
+	PQclear(pgres);
+	pgres = NULL;
 
+	/* 2. Send the rows */
+	initPQExpBuffer(&buf);
+	for (row = start_row; row <= end_row; row++)
+	{
+		if (apdopts->param_operation_ptr &&
+			SQL_PARAM_IGNORE == apdopts->param_operation_ptr[row])
+			continue;
+		self->exec_current_row = row;
+		if (!build_copy_in_row(self, &buf))
+		{
+			errmsg = "could not convert the parameters";
+			break;
+		}
+		(*nrows)++;
+		if (buf.len >= COPY_IN_CHUNK_SIZE)
+		{
+			if (PQputCopyData(conn->pqconn, buf.data, (int) buf.len) <= 0)
+				break;
+			resetPQExpBuffer(&buf);
+		}
+	}
+	self->exec_current_row = save_current_row;
+	if (NULL == errmsg && row <= end_row)
+		;	/* PQputCopyData failed */
+	else if (NULL == errmsg && buf.len > 0 &&
+			 PQputCopyData(conn->pqconn, buf.data, (int) buf.len) <= 0)
+		;
+	/* 3. End the COPY, aborting it if a row couldn't be converted */
+	else if (PQputCopyEnd(conn->pqconn, errmsg) > 0)
+	{
+		while (pgres = PQgetResult(conn->pqconn), NULL != pgres)
+		{
+			if (!libpq_receive_result(self, res, &pgres))
+				QR_set_rstatus(res, PORES_NO_MEMORY_ERROR);
+			if (pgres)
+				PQclear(pgres);
+		}
+		goto receive_done;
+	}
+	SC_set_error(self, STMT_EXEC_ERROR, PQerrorMessage(conn->pqconn), func);
+	CC_on_abort(conn, CONN_DEAD);
+
+receive_done:
+	/* reset notice receiver */
+	PQsetNoticeReceiver(conn->pqconn, receive_libpq_notice, NULL);
+	if (start_usec > 0)
+	{
+		PG_Metrics	metrics = {0};
+
+		metrics.exec_usec = get_clock_usec() - start_usec;
+		CC_add_metrics(conn, self, &metrics);
+	}
+	if (0 >= SC_get_errornumber(self))
+	{
+		if (QR_command_successful(res))
+		{
+			if (self->has_notice)
+				SC_set_errornumber(self, STMT_INFO_ONLY);
+			ret = self->has_notice ? SQL_SUCCESS_WITH_INFO : SQL_SUCCESS;
+		}
+		else if (QR_command_nonfatal(res))
+		{
+			self->has_notice = 1;
+			SC_set_errornumber(self, STMT_INFO_ONLY);
+			ret = SQL_SUCCESS_WITH_INFO;
+		}
+		else
+			SC_set_errorinfo(self, res, 0);
+	}
+	SC_set_Result(self, res);
+	res = NULL;
+	self->status = STMT_FINISHED;
+
+cleanup:
+#undef	return
+	if (pgres)
+		PQclear(pgres);
+	if (buf.data)
+		termPQExpBuffer(&buf);
+	if (res)
+		QR_Destructor(res);
+	SC_SetExecuting(self, FALSE);
+	CLEANUP_FUNC_CONN_CS(func_cs_count, conn);
+	if (CONN_DOWN != conn->status)
+		conn->status = oldstatus;
+
+	return ret;
+}
+
+/*
+ * Get the types of the parameters to Parse a query with.
+ *
+ * Returns the number of the parameters, or -1 if out of memory. The
+ * caller must free *paramTypes.
+ */
+static int
+get_parse_param_types(StatementClass *stmt, Int2 num_params, Oid **paramTypes)
+{
+	ConnectionClass	*conn = SC_get_conn(stmt);
+	Int4		sta_pidx = -1, end_pidx = -1;
+
+	*paramTypes = NULL;
 	if (stmt->discard_output_params)
 		num_params = 0;
 	else if (num_params != 0)
@@ -2813,11 +3324,11 @@ MYLOG(0, "sta_pidx=%d end_pidx=%d num_p=%d\n", sta_pidx, end_pidx, num_params);
 		int j;
 		IPDFields	*ipdopts = SC_get_IPDF(stmt);
 
-		paramTypes = malloc(sizeof(Oid) * num_params);
-		if (paramTypes == NULL)
+		*paramTypes = malloc(sizeof(Oid) * num_params);
+		if (*paramTypes == NULL)
 		{
 			SC_set_errornumber(stmt, STMT_NO_MEMORY_ERROR);
-			goto cleanup;
+			return -1;
 		}
 
 		MYLOG(0, "ipdopts->allocated: %d\n", ipdopts->allocated);
@@ -2827,19 +3338,44 @@ MYLOG(0, "sta_pidx=%d end_pidx=%d num_p=%d\n", sta_pidx, end_pidx, num_params);
 			if (i < ipdopts->allocated)
 			{
 				if (SQL_PARAM_OUTPUT == ipdopts->parameters[i].paramType)
-					paramTypes[j++] = PG_TYPE_VOID;
+					(*paramTypes)[j++] = PG_TYPE_VOID;
 				else
-					paramTypes[j++] = sqltype_to_bind_pgtype(conn,
+					(*paramTypes)[j++] = sqltype_to_bind_pgtype(conn,
 															 ipdopts->parameters[i].SQLType);
 			}
 			else
 			{
 				/* Unknown type of parameter. Let the server decide */
-				paramTypes[j++] = 0;
+				(*paramTypes)[j++] = 0;
 			}
 		}
 	}
 
+	return num_params;
+}
+
+/*
+ * Parse a query using libpq.
+ *
+ * 'res' is only passed here for error reporting purposes. If an error is
+ * encountered, it is set in 'res', and the function returns FALSE.
+ */
+static BOOL
+ParseWithLibpq(StatementClass *stmt, const char *plan_name,
+			   const char *query,
+			   Int2 num_params, const Oid *paramTypes,
+			   const char *comment, QResultClass *res)
+{
+	CSTR	func = "ParseWithLibpq";
+	ConnectionClass	*conn = SC_get_conn(stmt);
+	const char	*cstatus;
+	BOOL		retval = FALSE;
+	PGresult   *pgres = NULL;
+
+	MYLOG(0, "entering plan_name=%s query=%s\n", plan_name, query);
+	if (!RequestStart(stmt, conn, func))
+		return FALSE;
+
 	if (plan_name == NULL || plan_name[0] == '\0')
 		conn->unnamed_prepared_stmt = NULL;
 
@@ -2864,9 +3400,6 @@ MYLOG(0, "sta_pidx=%d end_pidx=%d num_p=%d\n", sta_pidx, end_pidx, num_params);
 	retval = TRUE;
 
 cleanup:
-	if (paramTypes)
-		free(paramTypes);
-
 	if (pgres)
 		PQclear(pgres);
 
@@ -2875,24 +3408,13 @@ cleanup:
 
 
 /*
- * Parse and describe a query using libpq.
- *
- * Returns an empty result set that has the column information, or error code
- * and message, filled in. If 'res' is not NULL, it is the result set
- * returned, otherwise a new one is allocated.
- *
- * NB: The caller must set stmt->current_exec_param before calling this
- * function!
+ * Set the parameter and column information from the result of
+ * PQdescribePrepared() into the IPD of the statement and 'res'.
  */
-QResultClass *
-ParseAndDescribeWithLibpq(StatementClass *stmt, const char *plan_name,
-						  const char *query_param,
-						  Int2 num_params, const char *comment,
-						  QResultClass *res)
+static void
+read_described_result(StatementClass *stmt, PGresult *pgres, QResultClass *res)
 {
-	CSTR	func = "ParseAndDescribeWithLibpq";
 	ConnectionClass	*conn = SC_get_conn(stmt);
-	PGresult   *pgres = NULL;
 	int			num_p;
 	Int2		num_discard_params;
 	IPDFields	*ipdopts;
@@ -2901,51 +3423,6 @@ ParseAndDescribeWithLibpq(StatementClass *stmt, const char *plan_name,
 	Oid			oid;
 	SQLSMALLINT paramType;
 
-	MYLOG(0, "entering plan_name=%s query=%s\n", plan_name, query_param);
-	if (!RequestStart(stmt, conn, func))
-		return NULL;
-
-	if (!res)
-		res = QR_Constructor();
-	if (!res)
-	{
-		SC_set_error(stmt, STMT_NO_MEMORY_ERROR, "Couldn't allocate memory for query", func);
-		return NULL;
-	}
-
-	/*
-	 * We need to do Prepare + Describe as two different round-trips to the
-	 * server, while before we switched to use libpq, we used to send a Parse
-	 * and Describe message followed by a single Sync.
-	 */
-	if (!ParseWithLibpq(stmt, plan_name, query_param, num_params, comment, res))
-		goto cleanup;
-
-	/* Describe */
-	QLOG(0, "\tPQdescribePrepared: %p plan_name=%s\n", conn->pqconn, plan_name);
-
-	pgres = PQdescribePrepared(conn->pqconn, plan_name);
-	switch (PQresultStatus(pgres))
-	{
-		case PGRES_COMMAND_OK:
-			QLOG(0, "\tok: - 'C' - %s\n", PQcmdStatus(pgres));
-			/* expected */
-			break;
-		case PGRES_NONFATAL_ERROR:
-			handle_pgres_error(conn, pgres, "ParseAndDescribeWithLibpq", res, FALSE);
-			goto cleanup;
-		case PGRES_FATAL_ERROR:
-			handle_pgres_error(conn, pgres, "ParseAndDescribeWithLibpq", res, TRUE);
-			goto cleanup;
-		default:
-			/* skip the unexpected response if possible */
-			CC_set_error(conn, CONNECTION_BACKEND_CRAZY, "Unexpected result from PQdescribePrepared", func);
-			CC_on_abort(conn, CONN_DEAD);
-
-			MYLOG(0, "PQdescribePrepared: error - %s\n", CC_get_errormsg(conn));
-			goto cleanup;
-	}
-
 	/* Extract parameter information from the result set */
 	num_p = PQnparams(pgres);
 MYLOG(DETAIL_LOG_LEVEL, "num_params=%d info=%d\n", stmt->num_params, num_p);
@@ -3035,10 +3512,123 @@ MYLOG(DETAIL_LOG_LEVEL, "num_params=%d info=%d\n", stmt->num_params, num_p);
 			QR_set_message(res, "Error reading field information");
 		}
 	}
+}
+
+/*
+ * Parse and describe a query using libpq.
+ *
+ * Returns an empty result set that has the column information, or error code
+ * and message, filled in. If 'res' is not NULL, it is the result set
+ * returned, otherwise a new one is allocated.
+ *
+ * NB: The caller must set stmt->current_exec_param before calling this
+ * function!
+ */
+QResultClass *
+ParseAndDescribeWithLibpq(StatementClass *stmt, const char *plan_name,
+						  const char *query_param,
+						  Int2 num_params, const char *comment,
+						  QResultClass *res)
+{
+	CSTR	func = "ParseAndDescribeWithLibpq";
+	ConnectionClass	*conn = SC_get_conn(stmt);
+	PGresult   *pgres = NULL;
+	Oid		   *paramTypes = NULL;
+	PLAN_INFO  *plan;
+	BOOL		use_cache;
+	char		cache_plan_name[40];
+
+	MYLOG(0, "entering plan_name=%s query=%s\n", plan_name, query_param);
+	if (!RequestStart(stmt, conn, func))
+		return NULL;
+
+	if (!res)
+		res = QR_Constructor();
+	if (!res)
+	{
+		SC_set_error(stmt, STMT_NO_MEMORY_ERROR, "Couldn't allocate memory for query", func);
+		return NULL;
+	}
+
+	if (num_params = get_parse_param_types(stmt, num_params, &paramTypes), num_params < 0)
+	{
+		QR_set_rstatus(res, PORES_NO_MEMORY_ERROR);
+		QR_set_messageref(res, "Couldn't allocate memory for parameter types");
+		goto cleanup;
+	}
+
+	/*
+	 * A named plan of a single statement query may be shared with the
+	 * other statements of the connection through the plan cache.
+	 */
+	use_cache = (CC_caches_plans(conn) &&
+				 NULL != plan_name && '\0' != plan_name[0] &&
+				 NULL != stmt->processed_statements &&
+				 NULL == stmt->processed_statements->next);
+	if (use_cache)
+	{
+		if (plan = CC_lookup_plan(conn, query_param, num_params, paramTypes), NULL != plan)
+		{
+			SC_set_planname(stmt, plan->plan_name);
+			SC_set_prepared(stmt, PREPARED_PERMANENTLY);
+			stmt->plan_cached = TRUE;
+			QLOG(0, "\tplan cache hit: %p plan_name=%s\n", conn->pqconn, plan->plan_name);
+			read_described_result(stmt, plan->describe, res);
+			goto cleanup;
+		}
+		SPRINTF_FIXED(cache_plan_name, "_PLANC%p_%u", conn, ++conn->plan_seq);
+		SC_set_planname(stmt, cache_plan_name);
+		plan_name = stmt->plan_name;
+	}
+
+	/*
+	 * We need to do Prepare + Describe as two different round-trips to the
+	 * server, while before we switched to use libpq, we used to send a Parse
+	 * and Describe message followed by a single Sync.
+	 */
+	if (!ParseWithLibpq(stmt, plan_name, query_param, num_params, paramTypes, comment, res))
+		goto cleanup;
+
+	/* Describe */
+	QLOG(0, "\tPQdescribePrepared: %p plan_name=%s\n", conn->pqconn, plan_name);
+
+	pgres = PQdescribePrepared(conn->pqconn, plan_name);
+	switch (PQresultStatus(pgres))
+	{
+		case PGRES_COMMAND_OK:
+			QLOG(0, "\tok: - 'C' - %s\n", PQcmdStatus(pgres));
+			/* expected */
+			break;
+		case PGRES_NONFATAL_ERROR:
+			handle_pgres_error(conn, pgres, "ParseAndDescribeWithLibpq", res, FALSE);
+			goto cleanup;
+		case PGRES_FATAL_ERROR:
+			handle_pgres_error(conn, pgres, "ParseAndDescribeWithLibpq", res, TRUE);
+			goto cleanup;
+		default:
+			/* skip the unexpected response if possible */
+			CC_set_error(conn, CONNECTION_BACKEND_CRAZY, "Unexpected result from PQdescribePrepared", func);
+			CC_on_abort(conn, CONN_DEAD);
+
+			MYLOG(0, "PQdescribePrepared: error - %s\n", CC_get_errormsg(conn));
+			goto cleanup;
+	}
+
+	read_described_result(stmt, pgres, res);
+
+	if (use_cache && QR_command_maybe_successful(res) &&
+		NULL != CC_add_plan(conn, query_param, num_params, paramTypes, plan_name, pgres))
+	{
+		/* the plan cache owns the describe result from now on */
+		stmt->plan_cached = TRUE;
+		pgres = NULL;
+	}
 
 cleanup:
 	if (pgres)
 		PQclear(pgres);
+	if (paramTypes)
+		free(paramTypes);
 
 	return res;
 }
@@ -172,6 +172,7 @@ enum
 typedef enum {
 	DIRECT_EXEC,
 	DEFFERED_EXEC,
+	PIPELINE_EXEC,
 	LAST_EXEC
 } EXEC_TYPE;
 
@@ -242,6 +243,9 @@ struct StatementClass_
 	SQLLEN		last_fetch_count;	/* number of rows retrieved in
 						 * last fetch/extended fetch */
 	int		lobj_fd;		/* fd of the current large object */
+	char	   *lobj_wbuf;		/* SQLPutData data not yet written to
+					 * lobj_fd */
+	Int4		lobj_wbufused;	/* the length of the data in lobj_wbuf */
 
 	char	   *statement;		/* if non--null pointer to the SQL
 					 * statement that has been executed */
@@ -281,8 +285,17 @@ struct StatementClass_
 	po_ind_t	parse_method;	/* parse_statement is forced or ? */
 	po_ind_t	curr_param_result; /* current param result is set ? */
 	po_ind_t	has_notice; /* exec result contains notice messages ? */
+	po_ind_t	binary_result; /* result columns of the plan are all binary transferable ? */
+	po_ind_t	plan_cached; /* plan_name is shared through the plan cache of the connection ? */
+	po_ind_t	async_request; /* send the query of this call asynchronously ? */
+#ifdef	USE_ASYNC_NOTIFICATION
+	SQLPOINTER	async_callback;	/* SQL_ATTR_ASYNC_STMT_PCALLBACK */
+	SQLPOINTER	async_context;	/* SQL_ATTR_ASYNC_STMT_PCONTEXT */
+#endif /* USE_ASYNC_NOTIFICATION */
 	pgNAME		cursor_name;
 	char		*plan_name;
+	Int4		metrics_idx;	/* CollectMetrics, the entry of
+					 * conn->query_metrics or -1 */
 
 	char		*stmt_with_params;	/* statement after parameter
 							 * substitution */
@@ -307,6 +320,8 @@ struct StatementClass_
 	EXEC_TYPE	exec_type;
 	int		count_of_deffered;
 	PQExpBufferData	stmt_deffered;
+	SQLLEN		pipeline_start_row;	/* the parameter rows to send */
+	SQLLEN		pipeline_end_row;	/* in pipeline mode */
 	/* SQL_NEED_DATA Callback list */
 	StatementClass	*execute_delegate;
 	StatementClass	*execute_parent;
@@ -525,7 +540,9 @@ void		SC_set_rowset_start(StatementClass *self, SQLLEN, BOOL);
 void		SC_inc_rowset_start(StatementClass *self, SQLLEN);
 RETCODE		SC_initialize_stmts(StatementClass *self, BOOL);
 RETCODE		SC_execute(StatementClass *self);
+RETCODE		SC_execute_copy_in(StatementClass *self, const char *copy_query, SQLLEN start_row, SQLLEN end_row, SQLLEN *nrows);
 RETCODE		SC_fetch(StatementClass *self);
+RETCODE		SC_set_copy_result(StatementClass *self, int retval, const char *func);
 void		SC_free_params(StatementClass *self, char option);
 void		SC_log_error(const char *func, const char *desc, const StatementClass *self);
 time_t		SC_get_time(StatementClass *self);
@@ -559,6 +576,8 @@ void		cancelNeedDataState(StatementClass *self);
 int		StartRollbackState(StatementClass *self);
 RETCODE		SetStatementSvp(StatementClass *self, unsigned int option);
 RETCODE		DiscardStatementSvp(StatementClass *self, RETCODE, BOOL errorOnly);
+BOOL		StartAsyncExec(StatementClass *self);
+RETCODE		EndAsyncExec(StatementClass *self, RETCODE);
 
 QResultClass *ParseAndDescribeWithLibpq(StatementClass *stmt, const char *plan_name, const char *query_p, Int2 num_params, const char *comment, QResultClass *res);
 BOOL	CheckPgClassInfo(StatementClass *);
@@ -0,0 +1,75 @@
+/*
+ * Test sizing the FETCHes of declare/fetch cursors by the bytes per row
+ * (AdaptiveFetchBytes), with narrow, wide and mixed rows.
+ */
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "common.h"
+
+static void
+fetch_all(HSTMT hstmt, const char *sql)
+{
+	int			rc;
+	SQLINTEGER	id, prev = 0;
+	SQLLEN		len, total_len = 0;
+	char		buf[4096];
+	int			nrows = 0;
+	long long	sum = 0;
+
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) sql, SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	while (rc = SQLFetch(hstmt), SQL_SUCCEEDED(rc))
+	{
+		rc = SQLGetData(hstmt, 1, SQL_C_SLONG, &id, 0, NULL);
+		CHECK_STMT_RESULT(rc, "SQLGetData failed", hstmt);
+		rc = SQLGetData(hstmt, 2, SQL_C_CHAR, buf, sizeof(buf), &len);
+		CHECK_STMT_RESULT(rc, "SQLGetData failed", hstmt);
+		if (id != prev + 1)
+			printf("row %d follows row %d\n", (int) id, (int) prev);
+		prev = id;
+		nrows++;
+		sum += id;
+		total_len += len;
+	}
+	if (rc != SQL_NO_DATA)
+		CHECK_STMT_RESULT(rc, "SQLFetch failed", hstmt);
+	printf("%d rows, sum of ids %lld, total length %d\n", nrows, sum, (int) total_len);
+	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+}
+
+static void
+runTest(const char *extraparams)
+{
+	int			rc;
+	HSTMT		hstmt = SQL_NULL_HSTMT;
+
+	printf("-- %s\n", extraparams);
+	test_connect_ext((char *) extraparams);
+	rc = SQLAllocHandle(SQL_HANDLE_STMT, conn, &hstmt);
+	if (!SQL_SUCCEEDED(rc))
+	{
+		print_diag("failed to allocate stmt handle", SQL_HANDLE_DBC, conn);
+		exit(1);
+	}
+
+	/* narrow rows */
+	fetch_all(hstmt, "SELECT g, 'n' FROM generate_series(1, 3000) g");
+	/* wide rows */
+	fetch_all(hstmt, "SELECT g, repeat('w', 2000) FROM generate_series(1, 120) g");
+	/* rows getting wider */
+	fetch_all(hstmt, "SELECT g, repeat('m', g * 3) FROM generate_series(1, 1000) g");
+
+	test_disconnect();
+}
+
+int main(int argc, char **argv)
+{
+	runTest("UseDeclareFetch=1;Fetch=10");
+	runTest("UseDeclareFetch=1;Fetch=10;AdaptiveFetchBytes=20000;AdaptiveFetchMin=4;AdaptiveFetchMax=1000");
+	runTest("UseDeclareFetch=1;Fetch=10;AdaptiveFetchBytes=20000;FetchAhead=2");
+
+	return 0;
+}
@@ -0,0 +1,149 @@
+/*
+ * Test the asynchronous execution (SQL_ATTR_ASYNC_ENABLE) of SQLExecDirect
+ * and SQLExecute.
+ */
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "common.h"
+
+static int
+exec_async(HSTMT hstmt, const char *sql, int print_polled)
+{
+	int			rc, polls = 0;
+
+	while (rc = (sql ? SQLExecDirect(hstmt, (SQLCHAR *) sql, SQL_NTS) : SQLExecute(hstmt)), SQL_STILL_EXECUTING == rc)
+		polls++;
+	if (print_polled)
+		printf("went asynchronous: %s\n", polls > 0 ? "yes" : "no");
+	return rc;
+}
+
+static void
+exec_and_print(HSTMT hstmt, const char *sql, int print_polled)
+{
+	int			rc;
+	SQLSMALLINT	numcols;
+
+	printf("-- %s\n", sql);
+	rc = exec_async(hstmt, sql, print_polled);
+	if (!SQL_SUCCEEDED(rc))
+	{
+		print_diag("SQLExecDirect failed", SQL_HANDLE_STMT, hstmt);
+		return;
+	}
+	rc = SQLNumResultCols(hstmt, &numcols);
+	CHECK_STMT_RESULT(rc, "SQLNumResultCols failed", hstmt);
+	if (numcols > 0)
+		print_result(hstmt);
+	else
+		printf("ok\n");
+	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+}
+
+static HSTMT
+alloc_async_stmt(void)
+{
+	int			rc;
+	HSTMT		hstmt = SQL_NULL_HSTMT;
+	SQLULEN		async_enable = 0;
+
+	rc = SQLAllocHandle(SQL_HANDLE_STMT, conn, &hstmt);
+	if (!SQL_SUCCEEDED(rc))
+	{
+		print_diag("failed to allocate stmt handle", SQL_HANDLE_DBC, conn);
+		exit(1);
+	}
+	rc = SQLSetStmtAttr(hstmt, SQL_ATTR_ASYNC_ENABLE, (SQLPOINTER) SQL_ASYNC_ENABLE_ON, 0);
+	CHECK_STMT_RESULT(rc, "SQLSetStmtAttr failed", hstmt);
+	rc = SQLGetStmtAttr(hstmt, SQL_ATTR_ASYNC_ENABLE, &async_enable, 0, NULL);
+	CHECK_STMT_RESULT(rc, "SQLGetStmtAttr failed", hstmt);
+	printf("async enable: %d\n", (int) async_enable);
+	return hstmt;
+}
+
+static void
+exec_prepared(HSTMT hstmt)
+{
+	int			rc;
+	SQLINTEGER	param = 21;
+	SQLLEN		cbParam = sizeof(param);
+
+	rc = SQLPrepare(hstmt, (SQLCHAR *) "SELECT ?::int * 2 FROM pg_sleep(0.1)", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLPrepare failed", hstmt);
+	rc = SQLBindParameter(hstmt, 1, SQL_PARAM_INPUT, SQL_C_SLONG, SQL_INTEGER, 0, 0, &param, 0, &cbParam);
+	CHECK_STMT_RESULT(rc, "SQLBindParameter failed", hstmt);
+	printf("-- prepared\n");
+	rc = exec_async(hstmt, NULL, 1);
+	CHECK_STMT_RESULT(rc, "SQLExecute failed", hstmt);
+	print_result(hstmt);
+	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+	rc = SQLFreeStmt(hstmt, SQL_RESET_PARAMS);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+}
+
+static void
+exec_meanwhile(HSTMT hstmt)
+{
+	static const char *sql = "SELECT 'first' FROM pg_sleep(0.2)";
+	int			rc;
+	HSTMT		hstmt2 = SQL_NULL_HSTMT;
+
+	rc = SQLAllocHandle(SQL_HANDLE_STMT, conn, &hstmt2);
+	if (!SQL_SUCCEEDED(rc))
+	{
+		print_diag("failed to allocate stmt handle", SQL_HANDLE_DBC, conn);
+		exit(1);
+	}
+	printf("-- another statement meanwhile\n");
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) sql, SQL_NTS);
+	printf("went asynchronous: %s\n", SQL_STILL_EXECUTING == rc ? "yes" : "no");
+	rc = SQLExecDirect(hstmt2, (SQLCHAR *) "SELECT 'second'", SQL_NTS);
+	if (SQL_SUCCEEDED(rc))
+		printf("the other statement was executed\n");
+	else
+		print_diag("SQLExecDirect failed", SQL_HANDLE_STMT, hstmt2);
+	exec_and_print(hstmt, sql, 0);
+	rc = SQLFreeHandle(SQL_HANDLE_STMT, hstmt2);
+	CHECK_STMT_RESULT(rc, "SQLFreeHandle failed", hstmt2);
+}
+
+int main(int argc, char **argv)
+{
+	int			rc;
+	HSTMT		hstmt;
+
+	test_connect_ext("UseServerSidePrepare=0");
+	hstmt = alloc_async_stmt();
+
+	exec_and_print(hstmt, "SELECT 'slept' FROM pg_sleep(0.2)", 1);
+	exec_and_print(hstmt, "SELECT ('fail' || g)::int FROM generate_series(1, 1) g, pg_sleep(0.1)", 1);
+	exec_prepared(hstmt);
+	/* nothing else can be sent until the results are processed */
+	exec_meanwhile(hstmt);
+
+	/* statement rollback within a transaction */
+	rc = SQLSetConnectAttr(conn, SQL_ATTR_AUTOCOMMIT, (SQLPOINTER) SQL_AUTOCOMMIT_OFF, SQL_IS_UINTEGER);
+	CHECK_CONN_RESULT(rc, "SQLSetConnectAttr failed", conn);
+	exec_and_print(hstmt, "CREATE TEMPORARY TABLE asynctbl (id int4)", 0);
+	exec_and_print(hstmt, "INSERT INTO asynctbl SELECT g FROM generate_series(1, 3) g, pg_sleep(0.1)", 1);
+	exec_and_print(hstmt, "INSERT INTO asynctbl VALUES ('fail')", 0);
+	exec_and_print(hstmt, "SELECT count(*) FROM asynctbl", 0);
+	rc = SQLEndTran(SQL_HANDLE_DBC, conn, SQL_ROLLBACK);
+	CHECK_CONN_RESULT(rc, "SQLEndTran failed", conn);
+
+	rc = SQLFreeHandle(SQL_HANDLE_STMT, hstmt);
+	CHECK_STMT_RESULT(rc, "SQLFreeHandle failed", hstmt);
+	test_disconnect();
+
+	/* the server side prepared statement is executed synchronously */
+	test_connect_ext("UseServerSidePrepare=1");
+	hstmt = alloc_async_stmt();
+	exec_prepared(hstmt);
+	test_disconnect();
+
+	return 0;
+}
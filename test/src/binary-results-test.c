@@ -0,0 +1,106 @@
+/*
+ * Test receiving the results of prepared statements in binary format
+ * (BinaryResults=1).
+ */
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "common.h"
+
+static void
+runTest(HSTMT hstmt)
+{
+	int			rc;
+	SQLINTEGER	param;
+	SQLLEN		cbParam;
+	SQLSMALLINT	i2;
+	SQLINTEGER	i4;
+	SQLBIGINT	i8;
+	SQLDOUBLE	f8;
+	SQLLEN		cbI2, cbI4, cbI8, cbF8;
+	int			i;
+
+	rc = SQLPrepare(hstmt, (SQLCHAR *) "select 1::int2, ?::int4 + 1, 12345678901::int8, 1.5::float4, 0.1::float8, -1e100::float8, true, 123::oid", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLPrepare failed", hstmt);
+	rc = SQLBindParameter(hstmt, 1, SQL_PARAM_INPUT, SQL_C_SLONG, SQL_INTEGER, 0, 0, &param, 0, &cbParam);
+	CHECK_STMT_RESULT(rc, "SQLBindParameter failed", hstmt);
+
+	/**** Fetch the values as text ****/
+
+	for (i = 0; i < 2; i++)
+	{
+		param = 100 * (i + 1);
+		cbParam = sizeof(param);
+		rc = SQLExecute(hstmt);
+		CHECK_STMT_RESULT(rc, "SQLExecute failed", hstmt);
+		print_result(hstmt);
+		rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+		CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+	}
+
+	/**** Fetch the values into the matching C types ****/
+
+	param = -2;
+	cbParam = sizeof(param);
+	rc = SQLExecute(hstmt);
+	CHECK_STMT_RESULT(rc, "SQLExecute failed", hstmt);
+	rc = SQLBindCol(hstmt, 1, SQL_C_SSHORT, &i2, 0, &cbI2);
+	CHECK_STMT_RESULT(rc, "SQLBindCol failed", hstmt);
+	rc = SQLBindCol(hstmt, 2, SQL_C_SLONG, &i4, 0, &cbI4);
+	CHECK_STMT_RESULT(rc, "SQLBindCol failed", hstmt);
+	rc = SQLBindCol(hstmt, 3, SQL_C_SBIGINT, &i8, 0, &cbI8);
+	CHECK_STMT_RESULT(rc, "SQLBindCol failed", hstmt);
+	rc = SQLBindCol(hstmt, 5, SQL_C_DOUBLE, &f8, 0, &cbF8);
+	CHECK_STMT_RESULT(rc, "SQLBindCol failed", hstmt);
+	rc = SQLFetch(hstmt);
+	CHECK_STMT_RESULT(rc, "SQLFetch failed", hstmt);
+	printf("int2=%d int4=%d int8=%lld float8=%g\n",
+		   (int) i2, (int) i4, (long long) i8, f8);
+
+	rc = SQLFreeStmt(hstmt, SQL_UNBIND);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+
+	/**** Columns which can't be received in binary ****/
+
+	rc = SQLPrepare(hstmt, (SQLCHAR *) "select ?::int4, 'foo'::text", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLPrepare failed", hstmt);
+	param = 5;
+	cbParam = sizeof(param);
+	rc = SQLExecute(hstmt);
+	CHECK_STMT_RESULT(rc, "SQLExecute failed", hstmt);
+	print_result(hstmt);
+	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+}
+
+int main(int argc, char **argv)
+{
+	static char *connopts[] = {
+		"BinaryResults=0",
+		"BinaryResults=1"
+	};
+	int			rc, i;
+	HSTMT		hstmt = SQL_NULL_HSTMT;
+
+	for (i = 0; i < sizeof(connopts) / sizeof(connopts[0]); i++)
+	{
+		printf("-- %s\n", connopts[i]);
+		test_connect_ext(connopts[i]);
+
+		rc = SQLAllocHandle(SQL_HANDLE_STMT, conn, &hstmt);
+		if (!SQL_SUCCEEDED(rc))
+		{
+			print_diag("failed to allocate stmt handle", SQL_HANDLE_DBC, conn);
+			exit(1);
+		}
+		runTest(hstmt);
+
+		/* Clean up */
+		test_disconnect();
+	}
+
+	return 0;
+}
@@ -0,0 +1,137 @@
+/*
+ * Test converting bytea values of various lengths to and from hex digits,
+ * around the block sizes of the vectorised conversions.
+ */
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "common.h"
+
+#define MAX_LEN		300
+
+static const int lengths[] = {0, 1, 15, 16, 17, 31, 32, 33, 63, 64, 65, 100, 255, MAX_LEN};
+
+/* the bytes of the test value of length len, byte n is (n * 7 + len) % 256 */
+static unsigned char
+test_byte(int len, int n)
+{
+	return (unsigned char) ((n * 7 + len) % 256);
+}
+
+static void
+fetch_bytea(HSTMT hstmt, const char *bytea_output)
+{
+	int			rc, i, j;
+	char		sql[200];
+	char		charbuf[MAX_LEN * 2 + 1];
+	unsigned char binbuf[MAX_LEN];
+	SQLLEN		charind, binind;
+
+	printf("-- bytea_output = %s\n", bytea_output);
+	snprintf(sql, sizeof(sql), "SET bytea_output = %s", bytea_output);
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) sql, SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+
+	for (i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++)
+	{
+		int			len = lengths[i];
+		int			charok = 1, binok = 1;
+
+		snprintf(sql, sizeof(sql), "SELECT b, b FROM (SELECT decode(string_agg(lpad(to_hex((g * 7 + %d) %% 256), 2, '0'), '' ORDER BY g), 'hex') AS b FROM generate_series(0, %d - 1) g) s", len, len);
+		rc = SQLExecDirect(hstmt, (SQLCHAR *) sql, SQL_NTS);
+		CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+		rc = SQLFetch(hstmt);
+		CHECK_STMT_RESULT(rc, "SQLFetch failed", hstmt);
+		rc = SQLGetData(hstmt, 1, SQL_C_CHAR, charbuf, sizeof(charbuf), &charind);
+		CHECK_STMT_RESULT(rc, "SQLGetData failed", hstmt);
+		rc = SQLGetData(hstmt, 2, SQL_C_BINARY, binbuf, sizeof(binbuf), &binind);
+		CHECK_STMT_RESULT(rc, "SQLGetData failed", hstmt);
+
+		if (0 == len)
+		{
+			/* string_agg of no rows is NULL */
+			printf("length %d: %s\n", len, SQL_NULL_DATA == charind && SQL_NULL_DATA == binind ? "null" : "not null");
+		}
+		else
+		{
+			if (charind != len * 2 || binind != len)
+				charok = binok = 0;
+			for (j = 0; j < len && charok; j++)
+			{
+				char		hex[3];
+
+				snprintf(hex, sizeof(hex), "%02X", test_byte(len, j));
+				if (0 != strncmp(charbuf + j * 2, hex, 2))
+					charok = 0;
+			}
+			for (j = 0; j < len && binok; j++)
+			{
+				if (binbuf[j] != test_byte(len, j))
+					binok = 0;
+			}
+			printf("length %d: char %s, binary %s\n", len,
+				   charok ? "ok" : "mismatch", binok ? "ok" : "mismatch");
+		}
+		rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+		CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+	}
+}
+
+/* hex digits of mixed case as a parameter of bytea */
+static void
+send_hex(HSTMT hstmt)
+{
+	int			rc, i, j;
+	char		param[MAX_LEN * 2 + 1];
+	char		sql[300];
+	SQLLEN		cbParam = SQL_NTS;
+
+	printf("-- hex digits to bytea\n");
+	for (i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++)
+	{
+		int			len = lengths[i];
+
+		for (j = 0; j < len; j++)
+			snprintf(param + j * 2, 3, j % 2 ? "%02x" : "%02X", test_byte(len, j));
+		param[len * 2] = '\0';
+
+		snprintf(sql, sizeof(sql), "SELECT length(?::bytea) AS len, CASE WHEN ? = decode(coalesce(string_agg(lpad(to_hex((g * 7 + %d) %% 256), 2, '0'), '' ORDER BY g), ''), 'hex') THEN 'match' ELSE 'mismatch' END FROM generate_series(0, %d - 1) g", len, len);
+		rc = SQLPrepare(hstmt, (SQLCHAR *) sql, SQL_NTS);
+		CHECK_STMT_RESULT(rc, "SQLPrepare failed", hstmt);
+		rc = SQLBindParameter(hstmt, 1, SQL_PARAM_INPUT, SQL_C_CHAR, SQL_VARBINARY, MAX_LEN, 0, param, 0, &cbParam);
+		CHECK_STMT_RESULT(rc, "SQLBindParameter failed", hstmt);
+		rc = SQLBindParameter(hstmt, 2, SQL_PARAM_INPUT, SQL_C_CHAR, SQL_VARBINARY, MAX_LEN, 0, param, 0, &cbParam);
+		CHECK_STMT_RESULT(rc, "SQLBindParameter failed", hstmt);
+		rc = SQLExecute(hstmt);
+		CHECK_STMT_RESULT(rc, "SQLExecute failed", hstmt);
+		print_result(hstmt);
+		rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+		CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+	}
+}
+
+int main(int argc, char **argv)
+{
+	int			rc;
+	HSTMT		hstmt = SQL_NULL_HSTMT;
+
+	test_connect();
+
+	rc = SQLAllocHandle(SQL_HANDLE_STMT, conn, &hstmt);
+	if (!SQL_SUCCEEDED(rc))
+	{
+		print_diag("failed to allocate stmt handle", SQL_HANDLE_DBC, conn);
+		exit(1);
+	}
+
+	fetch_bytea(hstmt, "hex");
+	fetch_bytea(hstmt, "escape");
+	send_hex(hstmt);
+
+	test_disconnect();
+
+	return 0;
+}
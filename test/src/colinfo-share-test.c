@@ -0,0 +1,81 @@
+/*
+ * Test the column information of tables shared by the connections
+ * (ColumnInfoCacheTTL), and its invalidation by ALTER TABLE.
+ */
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "common.h"
+
+static void
+exec_sql(const char *sql, int print_meta)
+{
+	int			rc;
+	HSTMT		hstmt = SQL_NULL_HSTMT;
+
+	rc = SQLAllocHandle(SQL_HANDLE_STMT, conn, &hstmt);
+	if (!SQL_SUCCEEDED(rc))
+	{
+		print_diag("failed to allocate stmt handle", SQL_HANDLE_DBC, conn);
+		exit(1);
+	}
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) sql, SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	if (print_meta)
+		print_result_meta(hstmt);
+	rc = SQLFreeStmt(hstmt, SQL_DROP);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+}
+
+static void
+reconnect(const char *extraparams)
+{
+	int			rc;
+	char		dsn[1024];
+
+	printf("reconnecting\n");
+	rc = SQLDisconnect(conn);
+	if (!SQL_SUCCEEDED(rc))
+	{
+		print_diag("SQLDisconnect failed", SQL_HANDLE_DBC, conn);
+		exit(1);
+	}
+	snprintf(dsn, sizeof(dsn), "DSN=%s;%s", get_test_dsn(), extraparams);
+	rc = SQLDriverConnect(conn, NULL, (SQLCHAR *) dsn, SQL_NTS,
+						  NULL, 0, NULL, SQL_DRIVER_NOPROMPT);
+	if (!SQL_SUCCEEDED(rc))
+	{
+		print_diag("SQLDriverConnect failed", SQL_HANDLE_DBC, conn);
+		exit(1);
+	}
+}
+
+static void
+runTest(const char *extraparams)
+{
+	printf("-- %s\n", extraparams);
+	test_connect_ext((char *) extraparams);
+	exec_sql("CREATE TABLE coli_share_test (id int4 PRIMARY KEY, t varchar(20))", 0);
+	exec_sql("SELECT id, t FROM coli_share_test", 1);
+
+	/* a new connection may use the shared information */
+	reconnect(extraparams);
+	exec_sql("SELECT id, t FROM coli_share_test", 1);
+
+	/* which must be discarded when the table is altered */
+	exec_sql("ALTER TABLE coli_share_test ALTER COLUMN t SET NOT NULL", 0);
+	reconnect(extraparams);
+	exec_sql("SELECT id, t FROM coli_share_test", 1);
+
+	exec_sql("DROP TABLE coli_share_test", 0);
+	test_disconnect();
+}
+
+int main(int argc, char **argv)
+{
+	runTest("Parse=1;ColumnInfoCacheTTL=0");
+	runTest("Parse=1;ColumnInfoCacheTTL=600");
+
+	return 0;
+}
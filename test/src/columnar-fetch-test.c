@@ -0,0 +1,157 @@
+/*
+ * Test fetching rowsets into column-wise bound arrays, which converts
+ * the plain columns per rowset instead of per row.
+ */
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "common.h"
+
+#define ROWSET_SIZE	4
+
+static void
+fetch_text_rowsets(HSTMT hstmt)
+{
+	int			rc;
+	SQLULEN		nrows;
+	SQLINTEGER	i4[ROWSET_SIZE];
+	SQLBIGINT	i8[ROWSET_SIZE];
+	SQLDOUBLE	f8[ROWSET_SIZE];
+	char		txt[ROWSET_SIZE][8];
+	char		num[ROWSET_SIZE][8];
+	SQLSMALLINT	i2[ROWSET_SIZE];
+	SQLLEN		cbI4[ROWSET_SIZE], cbI8[ROWSET_SIZE], cbF8[ROWSET_SIZE],
+				cbTxt[ROWSET_SIZE], cbNum[ROWSET_SIZE], cbI2[ROWSET_SIZE];
+	int			i;
+
+	rc = SQLSetStmtAttr(hstmt, SQL_ATTR_ROW_ARRAY_SIZE, (SQLPOINTER) ROWSET_SIZE, 0);
+	CHECK_STMT_RESULT(rc, "SQLSetStmtAttr failed", hstmt);
+	rc = SQLSetStmtAttr(hstmt, SQL_ATTR_ROWS_FETCHED_PTR, &nrows, 0);
+	CHECK_STMT_RESULT(rc, "SQLSetStmtAttr failed", hstmt);
+
+	rc = SQLBindCol(hstmt, 1, SQL_C_SLONG, i4, 0, cbI4);
+	CHECK_STMT_RESULT(rc, "SQLBindCol failed", hstmt);
+	rc = SQLBindCol(hstmt, 2, SQL_C_SBIGINT, i8, 0, cbI8);
+	CHECK_STMT_RESULT(rc, "SQLBindCol failed", hstmt);
+	rc = SQLBindCol(hstmt, 3, SQL_C_DOUBLE, f8, 0, cbF8);
+	CHECK_STMT_RESULT(rc, "SQLBindCol failed", hstmt);
+	rc = SQLBindCol(hstmt, 4, SQL_C_CHAR, txt, sizeof(txt[0]), cbTxt);
+	CHECK_STMT_RESULT(rc, "SQLBindCol failed", hstmt);
+	rc = SQLBindCol(hstmt, 5, SQL_C_CHAR, num, sizeof(num[0]), cbNum);
+	CHECK_STMT_RESULT(rc, "SQLBindCol failed", hstmt);
+	/* this one is converted per row */
+	rc = SQLBindCol(hstmt, 6, SQL_C_SSHORT, i2, 0, cbI2);
+	CHECK_STMT_RESULT(rc, "SQLBindCol failed", hstmt);
+
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "SELECT g, g * 10000000000::int8, g / 4.0::float8, CASE WHEN g % 3 = 0 THEN NULL ELSE 'text ' || repeat('x', g % 4) END, (g * g)::int4, g::int2, 'unbound' FROM generate_series(1, 10) g", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	while (rc = SQLFetchScroll(hstmt, SQL_FETCH_NEXT, 0), SQL_SUCCEEDED(rc))
+	{
+		printf("fetch returns %d, %d rows\n", rc, (int) nrows);
+		for (i = 0; i < (int) nrows; i++)
+		{
+			printf("%d %lld %g ", (int) i4[i], (long long) i8[i], f8[i]);
+			if (cbTxt[i] == SQL_NULL_DATA)
+				printf("NULL");
+			else
+				printf("%s(%d)", txt[i], (int) cbTxt[i]);
+			printf(" %s(%d) %d\n", num[i], (int) cbNum[i], (int) i2[i]);
+		}
+	}
+	if (rc != SQL_NO_DATA)
+		CHECK_STMT_RESULT(rc, "SQLFetchScroll failed", hstmt);
+
+	rc = SQLFreeStmt(hstmt, SQL_UNBIND);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+}
+
+static void
+fetch_prepared_rowsets(HSTMT hstmt)
+{
+	int			rc;
+	SQLULEN		nrows;
+	SQLINTEGER	param;
+	SQLLEN		cbParam;
+	SQLINTEGER	i4[ROWSET_SIZE], sq[ROWSET_SIZE];
+	SQLBIGINT	i8[ROWSET_SIZE];
+	SQLDOUBLE	f8[ROWSET_SIZE];
+	SQLLEN		cbI4[ROWSET_SIZE], cbI8[ROWSET_SIZE], cbF8[ROWSET_SIZE],
+				cbSq[ROWSET_SIZE];
+	int			i;
+
+	rc = SQLSetStmtAttr(hstmt, SQL_ATTR_ROW_ARRAY_SIZE, (SQLPOINTER) ROWSET_SIZE, 0);
+	CHECK_STMT_RESULT(rc, "SQLSetStmtAttr failed", hstmt);
+	rc = SQLSetStmtAttr(hstmt, SQL_ATTR_ROWS_FETCHED_PTR, &nrows, 0);
+	CHECK_STMT_RESULT(rc, "SQLSetStmtAttr failed", hstmt);
+
+	rc = SQLPrepare(hstmt, (SQLCHAR *) "SELECT nullif(g, 3), g * 10000000000::int8, (g / 4.0)::float4, (g * g)::int2 FROM generate_series(1, ?) g", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLPrepare failed", hstmt);
+	rc = SQLBindParameter(hstmt, 1, SQL_PARAM_INPUT, SQL_C_SLONG, SQL_INTEGER, 0, 0, &param, 0, &cbParam);
+	CHECK_STMT_RESULT(rc, "SQLBindParameter failed", hstmt);
+	rc = SQLBindCol(hstmt, 1, SQL_C_SLONG, i4, 0, cbI4);
+	CHECK_STMT_RESULT(rc, "SQLBindCol failed", hstmt);
+	rc = SQLBindCol(hstmt, 2, SQL_C_SBIGINT, i8, 0, cbI8);
+	CHECK_STMT_RESULT(rc, "SQLBindCol failed", hstmt);
+	rc = SQLBindCol(hstmt, 3, SQL_C_DOUBLE, f8, 0, cbF8);
+	CHECK_STMT_RESULT(rc, "SQLBindCol failed", hstmt);
+	rc = SQLBindCol(hstmt, 4, SQL_C_SLONG, sq, 0, cbSq);
+	CHECK_STMT_RESULT(rc, "SQLBindCol failed", hstmt);
+
+	param = 5;
+	cbParam = sizeof(param);
+	rc = SQLExecute(hstmt);
+	CHECK_STMT_RESULT(rc, "SQLExecute failed", hstmt);
+	while (rc = SQLFetchScroll(hstmt, SQL_FETCH_NEXT, 0), SQL_SUCCEEDED(rc))
+	{
+		printf("fetch returns %d, %d rows\n", rc, (int) nrows);
+		for (i = 0; i < (int) nrows; i++)
+		{
+			if (cbI4[i] == SQL_NULL_DATA)
+				printf("NULL");
+			else
+				printf("%d", (int) i4[i]);
+			printf(" %lld %g %d\n", (long long) i8[i], f8[i], (int) sq[i]);
+		}
+	}
+	if (rc != SQL_NO_DATA)
+		CHECK_STMT_RESULT(rc, "SQLFetchScroll failed", hstmt);
+
+	rc = SQLFreeStmt(hstmt, SQL_UNBIND);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+	rc = SQLFreeStmt(hstmt, SQL_RESET_PARAMS);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+}
+
+int main(int argc, char **argv)
+{
+	static char *connopts[] = {
+		"BinaryResults=0",
+		"BinaryResults=1"
+	};
+	int			rc, i;
+	HSTMT		hstmt = SQL_NULL_HSTMT;
+
+	for (i = 0; i < sizeof(connopts) / sizeof(connopts[0]); i++)
+	{
+		printf("-- %s\n", connopts[i]);
+		test_connect_ext(connopts[i]);
+
+		rc = SQLAllocHandle(SQL_HANDLE_STMT, conn, &hstmt);
+		if (!SQL_SUCCEEDED(rc))
+		{
+			print_diag("failed to allocate stmt handle", SQL_HANDLE_DBC, conn);
+			exit(1);
+		}
+		fetch_text_rowsets(hstmt);
+		fetch_prepared_rowsets(hstmt);
+
+		test_disconnect();
+	}
+
+	return 0;
+}
@@ -0,0 +1,41 @@
+/*
+ * Test the settings sent at connection time, including ConnSettings.
+ */
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "common.h"
+
+static void
+runTest(char *extraparams)
+{
+	int			rc;
+	HSTMT		hstmt = SQL_NULL_HSTMT;
+
+	printf("-- %s\n", extraparams);
+	test_connect_ext(extraparams);
+
+	rc = SQLAllocHandle(SQL_HANDLE_STMT, conn, &hstmt);
+	if (!SQL_SUCCEEDED(rc))
+	{
+		print_diag("failed to allocate stmt handle", SQL_HANDLE_DBC, conn);
+		exit(1);
+	}
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "SELECT CASE WHEN current_setting('DateStyle') LIKE 'ISO%' THEN 'iso' ELSE 'not iso' END, current_setting('extra_float_digits'), current_setting('connset.val'), current_setting('application_name')", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	print_result(hstmt);
+	rc = SQLFreeStmt(hstmt, SQL_DROP);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+
+	test_disconnect();
+}
+
+int main(int argc, char **argv)
+{
+	runTest("ConnSettings={SET connset.val = 'a';SET application_name = 'connset'}");
+	/* a failing statement doesn't prevent the others */
+	runTest("ConnSettings={SET connset.val = 'b';SET work_mem = 'bogus';SET application_name = 'connset2'}");
+
+	return 0;
+}
@@ -0,0 +1,103 @@
+/*
+ * Test the driver side connection pool (ConnectionPoolSize).
+ */
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "common.h"
+
+static int
+get_backend_pid(void)
+{
+	int			rc;
+	HSTMT		hstmt = SQL_NULL_HSTMT;
+	SQLINTEGER	pid;
+
+	rc = SQLAllocHandle(SQL_HANDLE_STMT, conn, &hstmt);
+	if (!SQL_SUCCEEDED(rc))
+	{
+		print_diag("failed to allocate stmt handle", SQL_HANDLE_DBC, conn);
+		exit(1);
+	}
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "SELECT pg_backend_pid()", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	rc = SQLFetch(hstmt);
+	CHECK_STMT_RESULT(rc, "SQLFetch failed", hstmt);
+	rc = SQLGetData(hstmt, 1, SQL_C_SLONG, &pid, 0, NULL);
+	CHECK_STMT_RESULT(rc, "SQLGetData failed", hstmt);
+	rc = SQLFreeStmt(hstmt, SQL_DROP);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+
+	return pid;
+}
+
+static void
+exec_sql(const char *sql, int print)
+{
+	int			rc;
+	HSTMT		hstmt = SQL_NULL_HSTMT;
+
+	rc = SQLAllocHandle(SQL_HANDLE_STMT, conn, &hstmt);
+	if (!SQL_SUCCEEDED(rc))
+	{
+		print_diag("failed to allocate stmt handle", SQL_HANDLE_DBC, conn);
+		exit(1);
+	}
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) sql, SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	if (print)
+		print_result(hstmt);
+	rc = SQLFreeStmt(hstmt, SQL_DROP);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+}
+
+static void
+reconnect(const char *extraparams)
+{
+	int			rc;
+	char		dsn[1024];
+
+	printf("reconnecting\n");
+	rc = SQLDisconnect(conn);
+	if (!SQL_SUCCEEDED(rc))
+	{
+		print_diag("SQLDisconnect failed", SQL_HANDLE_DBC, conn);
+		exit(1);
+	}
+	snprintf(dsn, sizeof(dsn), "DSN=%s;%s", get_test_dsn(), extraparams);
+	rc = SQLDriverConnect(conn, NULL, (SQLCHAR *) dsn, SQL_NTS,
+						  NULL, 0, NULL, SQL_DRIVER_NOPROMPT);
+	if (!SQL_SUCCEEDED(rc))
+	{
+		print_diag("SQLDriverConnect failed", SQL_HANDLE_DBC, conn);
+		exit(1);
+	}
+}
+
+static void
+runTest(const char *extraparams)
+{
+	int			pid;
+
+	printf("-- %s\n", extraparams);
+	test_connect_ext((char *) extraparams);
+	pid = get_backend_pid();
+	exec_sql("CREATE TEMPORARY TABLE pool_test_tmp (id int4)", 0);
+	exec_sql("SET application_name = 'pool-test'", 0);
+
+	reconnect(extraparams);
+	printf("same backend: %s\n", pid == get_backend_pid() ? "yes" : "no");
+	/* the session state was reset */
+	exec_sql("SELECT count(*) FROM pg_class WHERE relname = 'pool_test_tmp' AND relpersistence = 't'", 1);
+	exec_sql("SELECT current_setting('application_name') = 'pool-test'", 1);
+	test_disconnect();
+}
+
+int main(int argc, char **argv)
+{
+	runTest("ConnectionPoolSize=0");
+	runTest("ConnectionPoolSize=1");
+
+	return 0;
+}
@@ -0,0 +1,163 @@
+/*
+ * Test executing an INSERT statement with arrays of parameters as a
+ * COPY FROM STDIN command (UseCopyInsert=1).
+ */
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "common.h"
+
+#define ARRAY_SIZE	5
+
+static void
+print_statuses(SQLRETURN rc, SQLULEN processed, SQLUSMALLINT status[])
+{
+	int			i;
+
+	printf("insert returns %d, %d rows processed\n", rc, (int) processed);
+	for (i = 0; i < ARRAY_SIZE; i++)
+	{
+		printf("row %d status=%s\n", i,
+			(status[i] == SQL_PARAM_SUCCESS ? "success" :
+			(status[i] == SQL_PARAM_UNUSED ? "unused" :
+			(status[i] == SQL_PARAM_ERROR ? "error" :
+			(status[i] == SQL_PARAM_SUCCESS_WITH_INFO ? "success_with_info" : "????")))));
+	}
+}
+
+static void
+print_table(HSTMT hstmt)
+{
+	int			rc;
+
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "SELECT id, replace(replace(t, E'\\t', '<tab>'), E'\\n', '<nl>'), length(t), d FROM test_copy ORDER BY id", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	print_result(hstmt);
+	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+}
+
+static void
+runTest(void)
+{
+	int			rc;
+	HSTMT		hstmt = SQL_NULL_HSTMT;
+	SQLINTEGER	ids[ARRAY_SIZE];
+	SQLCHAR		texts[ARRAY_SIZE][20] = { "foo", "tab\there", "back\\slash", "new\nline", "" };
+	SQLLEN		cbTexts[ARRAY_SIZE] = { SQL_NTS, SQL_NTS, SQL_NTS, SQL_NTS, SQL_NULL_DATA };
+	SQLUSMALLINT	status[ARRAY_SIZE];
+	SQLUSMALLINT	operations[ARRAY_SIZE] = { SQL_PARAM_PROCEED, SQL_PARAM_PROCEED, SQL_PARAM_PROCEED, SQL_PARAM_IGNORE, SQL_PARAM_PROCEED };
+	SQLULEN		processed;
+	int			i;
+
+	rc = SQLAllocHandle(SQL_HANDLE_STMT, conn, &hstmt);
+	if (!SQL_SUCCEEDED(rc))
+	{
+		print_diag("failed to allocate stmt handle", SQL_HANDLE_DBC, conn);
+		exit(1);
+	}
+
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "CREATE TEMPORARY TABLE test_copy (id int4 PRIMARY KEY, t text, d text DEFAULT 'default')", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+
+	for (i = 0; i < ARRAY_SIZE; i++)
+		ids[i] = i + 1;
+	rc = SQLSetStmtAttr(hstmt, SQL_ATTR_PARAMSET_SIZE, (SQLPOINTER) ARRAY_SIZE, 0);
+	CHECK_STMT_RESULT(rc, "SQLSetStmtAttr failed", hstmt);
+	rc = SQLSetStmtAttr(hstmt, SQL_ATTR_PARAM_STATUS_PTR, status, 0);
+	CHECK_STMT_RESULT(rc, "SQLSetStmtAttr failed", hstmt);
+	rc = SQLSetStmtAttr(hstmt, SQL_ATTR_PARAMS_PROCESSED_PTR, &processed, 0);
+	CHECK_STMT_RESULT(rc, "SQLSetStmtAttr failed", hstmt);
+	rc = SQLBindParameter(hstmt, 1, SQL_PARAM_INPUT, SQL_C_SLONG, SQL_INTEGER, 0, 0, ids, 0, NULL);
+	CHECK_STMT_RESULT(rc, "SQLBindParameter failed", hstmt);
+	rc = SQLBindParameter(hstmt, 2, SQL_PARAM_INPUT, SQL_C_CHAR, SQL_VARCHAR, 20, 0, texts, sizeof(texts[0]), cbTexts);
+	CHECK_STMT_RESULT(rc, "SQLBindParameter failed", hstmt);
+
+	/**** Insert the rows, including NULL and the characters to escape ****/
+
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "INSERT INTO test_copy (id, t) VALUES (?, ?)", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	print_statuses(rc, processed, status);
+
+	/**** Ignored rows ****/
+
+	for (i = 0; i < ARRAY_SIZE; i++)
+		ids[i] += ARRAY_SIZE;
+	rc = SQLSetStmtAttr(hstmt, SQL_ATTR_PARAM_OPERATION_PTR, operations, 0);
+	CHECK_STMT_RESULT(rc, "SQLSetStmtAttr failed", hstmt);
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "insert into test_copy(id,t) values(?,?);", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	print_statuses(rc, processed, status);
+	rc = SQLSetStmtAttr(hstmt, SQL_ATTR_PARAM_OPERATION_PTR, NULL, 0);
+	CHECK_STMT_RESULT(rc, "SQLSetStmtAttr failed", hstmt);
+
+	/**** A duplicate key fails all the rows ****/
+
+	for (i = 0; i < ARRAY_SIZE; i++)
+		ids[i] = i + 11;
+	ids[2] = 1;
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "INSERT INTO test_copy (id, t) VALUES (?, ?)", SQL_NTS);
+	print_statuses(rc, processed, status);
+
+	/**** Statements which COPY can't execute ****/
+
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "INSERT INTO test_copy (id, t) VALUES (?, ?) ON CONFLICT (id) DO UPDATE SET t = EXCLUDED.t || '-updated'", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	print_statuses(rc, processed, status);
+
+	/**** Views and INSERT rules are executed as INSERT ****/
+
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "CREATE TEMPORARY VIEW test_copy_v AS SELECT id, t FROM test_copy", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	for (i = 0; i < ARRAY_SIZE; i++)
+		ids[i] = i + 31;
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "INSERT INTO test_copy_v (id, t) VALUES (?, ?)", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	print_statuses(rc, processed, status);
+
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "CREATE TEMPORARY TABLE test_copy_r (id int4, t text)", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "CREATE RULE test_copy_r_rule AS ON INSERT TO test_copy_r DO INSTEAD INSERT INTO test_copy (id, t) VALUES (NEW.id, NEW.t || '-ruled')", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	for (i = 0; i < ARRAY_SIZE; i++)
+		ids[i] = i + 41;
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "INSERT INTO test_copy_r (id, t) VALUES (?, ?)", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	print_statuses(rc, processed, status);
+
+	/**** A quoted column name with a parenthesis ****/
+
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "CREATE TEMPORARY TABLE test_copy_q (id int4, \"odd)\"\"name\" text)", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "INSERT INTO test_copy_q (id, \"odd)\"\"name\") VALUES (?, ?)", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	print_statuses(rc, processed, status);
+
+	rc = SQLSetStmtAttr(hstmt, SQL_ATTR_PARAMSET_SIZE, (SQLPOINTER) 1, 0);
+	CHECK_STMT_RESULT(rc, "SQLSetStmtAttr failed", hstmt);
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "SELECT count(*), count(\"odd)\"\"name\") FROM test_copy_q", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	print_result(hstmt);
+	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+	print_table(hstmt);
+
+	rc = SQLFreeStmt(hstmt, SQL_DROP);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+}
+
+int main(int argc, char **argv)
+{
+	printf("-- UseCopyInsert=0\n");
+	test_connect();
+	runTest();
+	test_disconnect();
+
+	printf("-- UseCopyInsert=1\n");
+	test_connect_ext("UseCopyInsert=1");
+	runTest();
+	test_disconnect();
+
+	return 0;
+}
@@ -0,0 +1,166 @@
+/*
+ * Test reading ahead the blocks of declare/fetch cursors (FetchAhead),
+ * interleaving other queries and another cursor on the same connection.
+ * A block which fails to be read ahead must be reported only when the
+ * application reaches it.
+ */
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "common.h"
+
+static HSTMT
+alloc_stmt(void)
+{
+	int			rc;
+	HSTMT		hstmt = SQL_NULL_HSTMT;
+
+	rc = SQLAllocHandle(SQL_HANDLE_STMT, conn, &hstmt);
+	if (!SQL_SUCCEEDED(rc))
+	{
+		print_diag("failed to allocate stmt handle", SQL_HANDLE_DBC, conn);
+		exit(1);
+	}
+	return hstmt;
+}
+
+static int
+fetch_row(HSTMT hstmt, const char *label)
+{
+	int			rc;
+	char		buf[40];
+
+	rc = SQLFetch(hstmt);
+	if (rc == SQL_NO_DATA)
+	{
+		printf("%s: no more rows\n", label);
+		return 0;
+	}
+	CHECK_STMT_RESULT(rc, "SQLFetch failed", hstmt);
+	rc = SQLGetData(hstmt, 1, SQL_C_CHAR, buf, sizeof(buf), NULL);
+	CHECK_STMT_RESULT(rc, "SQLGetData failed", hstmt);
+	printf("%s: %s\n", label, buf);
+	return 1;
+}
+
+static void
+runTest(const char *extraparams)
+{
+	int			rc, i;
+	HSTMT		hstmt1, hstmt2, hstmt3;
+
+	printf("-- %s\n", extraparams);
+	test_connect_ext((char *) extraparams);
+	hstmt1 = alloc_stmt();
+	hstmt2 = alloc_stmt();
+	hstmt3 = alloc_stmt();
+
+	rc = SQLExecDirect(hstmt1, (SQLCHAR *) "SELECT 'a' || g FROM generate_series(1, 23) g", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt1);
+	rc = SQLExecDirect(hstmt2, (SQLCHAR *) "SELECT 'b' || g FROM generate_series(1, 12) g", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt2);
+
+	for (i = 0; fetch_row(hstmt1, "cursor 1"); i++)
+	{
+		/* other queries run between the blocks */
+		if (i % 4 == 3)
+		{
+			rc = SQLExecDirect(hstmt3, (SQLCHAR *) "SELECT 100 + 1", SQL_NTS);
+			CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt3);
+			print_result(hstmt3);
+			rc = SQLFreeStmt(hstmt3, SQL_CLOSE);
+			CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt3);
+		}
+		/* and so does another cursor */
+		if (i % 3 == 1)
+			fetch_row(hstmt2, "cursor 2");
+	}
+	while (fetch_row(hstmt2, "cursor 2"))
+		;
+
+	/* close a cursor while a block is read ahead */
+	rc = SQLFreeStmt(hstmt1, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt1);
+	rc = SQLExecDirect(hstmt1, (SQLCHAR *) "SELECT 'c' || g FROM generate_series(1, 100) g", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt1);
+	for (i = 0; i < 7; i++)
+		fetch_row(hstmt1, "cursor 3");
+	rc = SQLFreeStmt(hstmt1, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt1);
+
+	rc = SQLExecDirect(hstmt3, (SQLCHAR *) "SELECT 'still in sync'", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt3);
+	print_result(hstmt3);
+
+	test_disconnect();
+}
+
+static void
+runErrorTest(const char *extraparams)
+{
+	int			rc, i;
+	HSTMT		hstmt1, hstmt3;
+	char		sqlstate[32];
+	char		buf[40];
+
+	printf("-- %s\n", extraparams);
+	test_connect_ext((char *) extraparams);
+	rc = SQLSetConnectAttr(conn, SQL_AUTOCOMMIT, (SQLPOINTER) SQL_AUTOCOMMIT_OFF, 0);
+	if (!SQL_SUCCEEDED(rc))
+	{
+		print_diag("SQLSetConnectAttr failed", SQL_HANDLE_DBC, conn);
+		exit(1);
+	}
+	hstmt1 = alloc_stmt();
+	hstmt3 = alloc_stmt();
+
+	/* the 2nd block fails with division by zero at the 8th row */
+	rc = SQLExecDirect(hstmt1, (SQLCHAR *) "SELECT 10 / (8 - g) FROM generate_series(1, 20) g", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt1);
+	fetch_row(hstmt1, "cursor 1");
+	fetch_row(hstmt1, "cursor 1");
+
+	/* the transaction isn't aborted yet */
+	rc = SQLExecDirect(hstmt3, (SQLCHAR *) "SELECT 'between the blocks'", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt3);
+	print_result(hstmt3);
+	rc = SQLFreeStmt(hstmt3, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt3);
+
+	for (i = 0; i < 4; i++)
+	{
+		rc = SQLFetch(hstmt1);
+		if (!SQL_SUCCEEDED(rc))
+		{
+			SQLGetDiagRec(SQL_HANDLE_STMT, hstmt1, 1, (SQLCHAR *) sqlstate, NULL, NULL, 0, NULL);
+			printf("cursor 1: failed with %s\n", sqlstate);
+			break;
+		}
+		rc = SQLGetData(hstmt1, 1, SQL_C_CHAR, buf, sizeof(buf), NULL);
+		CHECK_STMT_RESULT(rc, "SQLGetData failed", hstmt1);
+		printf("cursor 1: %s\n", buf);
+	}
+
+	rc = SQLEndTran(SQL_HANDLE_DBC, conn, SQL_ROLLBACK);
+	if (!SQL_SUCCEEDED(rc))
+	{
+		print_diag("SQLEndTran failed", SQL_HANDLE_DBC, conn);
+		exit(1);
+	}
+	rc = SQLExecDirect(hstmt3, (SQLCHAR *) "SELECT 'still in sync'", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt3);
+	print_result(hstmt3);
+
+	test_disconnect();
+}
+
+int main(int argc, char **argv)
+{
+	runTest("UseDeclareFetch=1;Fetch=5;FetchAhead=0");
+	runTest("UseDeclareFetch=1;Fetch=5;FetchAhead=2");
+	runErrorTest("UseDeclareFetch=1;Fetch=5;FetchAhead=0");
+	runErrorTest("UseDeclareFetch=1;Fetch=5;FetchAhead=2");
+
+	return 0;
+}
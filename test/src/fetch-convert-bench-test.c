@@ -0,0 +1,224 @@
+/*
+ * Fetch many timestamp, float8 and numeric values converted to
+ * SQL_C_TYPE_TIMESTAMP and SQL_C_DOUBLE, and check them.  This works as a
+ * micro-benchmark of the conversions too, and the parsers of the driver
+ * are timed against the sscanf() and strtod() calls they replace; the CPU
+ * times are written to stderr, which isn't compared with the expected
+ * output.
+ */
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/* Must come before sql.h (declared in common.h) to suppress a warning */
+#include "../../canonical.h"
+
+#include "common.h"
+
+#define NUM_ROWS	100000
+#define ROWSET_SIZE	1000
+#define NUM_PARSES	1000000
+
+static void
+fetch_rows(HSTMT hstmt)
+{
+	static SQL_TIMESTAMP_STRUCT	tsval[ROWSET_SIZE];
+	static double	f8val[ROWSET_SIZE], numval[ROWSET_SIZE];
+	static SQLLEN	tsind[ROWSET_SIZE], f8ind[ROWSET_SIZE], numind[ROWSET_SIZE];
+	SQLULEN		nfetched, i;
+	int			rc, g = 0, mismatches = 0;
+	clock_t		start;
+
+	rc = SQLSetStmtAttr(hstmt, SQL_ATTR_ROW_ARRAY_SIZE, (SQLPOINTER) ROWSET_SIZE, 0);
+	CHECK_STMT_RESULT(rc, "SQLSetStmtAttr failed", hstmt);
+	rc = SQLSetStmtAttr(hstmt, SQL_ATTR_ROWS_FETCHED_PTR, (SQLPOINTER) &nfetched, 0);
+	CHECK_STMT_RESULT(rc, "SQLSetStmtAttr failed", hstmt);
+	rc = SQLBindCol(hstmt, 1, SQL_C_TYPE_TIMESTAMP, tsval, sizeof(tsval[0]), tsind);
+	CHECK_STMT_RESULT(rc, "SQLBindCol failed", hstmt);
+	rc = SQLBindCol(hstmt, 2, SQL_C_DOUBLE, f8val, sizeof(f8val[0]), f8ind);
+	CHECK_STMT_RESULT(rc, "SQLBindCol failed", hstmt);
+	rc = SQLBindCol(hstmt, 3, SQL_C_DOUBLE, numval, sizeof(numval[0]), numind);
+	CHECK_STMT_RESULT(rc, "SQLBindCol failed", hstmt);
+
+	/* g microseconds and g seconds after 2024-01-01 */
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "SELECT '2024-01-01'::timestamp + g * interval '1.000001 second', (g / 8.0)::float8, (g / 100.0)::numeric(12, 2) FROM generate_series(1, 100000) g", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+
+	start = clock();
+	while (rc = SQLFetch(hstmt), SQL_SUCCEEDED(rc))
+	{
+		for (i = 0; i < nfetched; i++)
+		{
+			long		sec;
+
+			g++;
+			sec = g + g / 1000000;
+			if (tsval[i].year != 2024 || tsval[i].month != 1 ||
+				tsval[i].day != 1 + sec / 86400 ||
+				tsval[i].hour != (sec % 86400) / 3600 ||
+				tsval[i].minute != (sec % 3600) / 60 ||
+				tsval[i].second != sec % 60 ||
+				tsval[i].fraction != (SQLUINTEGER) (g % 1000000) * 1000)
+				mismatches++;
+			if (f8val[i] != g / 8.0 || numval[i] != g / 100.0)
+				mismatches++;
+		}
+	}
+	if (rc != SQL_NO_DATA)
+		CHECK_STMT_RESULT(rc, "SQLFetch failed", hstmt);
+	fprintf(stderr, "converted %d rows in %.3f s of CPU time\n", g,
+			(double) (clock() - start) / CLOCKS_PER_SEC);
+	printf("%d rows, %d mismatches\n", g, mismatches);
+
+	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+}
+
+/*
+ * A date BC is returned with its positive year, as it always was.
+ */
+static void
+fetch_date_bc(HSTMT hstmt)
+{
+	DATE_STRUCT	dt;
+	SQLLEN		ind;
+	int			rc;
+
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "SELECT '0044-03-15 BC'::date", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	rc = SQLFetch(hstmt);
+	CHECK_STMT_RESULT(rc, "SQLFetch failed", hstmt);
+	rc = SQLGetData(hstmt, 1, SQL_C_TYPE_DATE, &dt, sizeof(dt), &ind);
+	CHECK_STMT_RESULT(rc, "SQLGetData failed", hstmt);
+	printf("0044-03-15 BC: %d-%d-%d\n", dt.year, dt.month, dt.day);
+
+	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+}
+
+/*
+ * The way the driver parsed a timestamp before parse_canonical_timestamp().
+ */
+static void
+sscanf_timestamp(const char *str, SIMPLE_TIME *st)
+{
+	char		rest[64];
+	const char *p;
+	int			i;
+
+	rest[0] = '\0';
+	sscanf(str, "%4d-%2d-%2d %2d:%2d:%2d%31s", &st->y, &st->m, &st->d, &st->hh, &st->mm, &st->ss, rest);
+	st->fr = 0;
+	if ('.' == rest[0])
+	{
+		/* in nanoseconds */
+		for (i = 0, p = rest + 1; i < 9; i++)
+		{
+			st->fr *= 10;
+			if (isdigit((unsigned char) *p))
+				st->fr += *p++ - '0';
+		}
+	}
+}
+
+/*
+ * Parse the same server output with the old and the new way, and time
+ * both of them.
+ */
+static void
+compare_parsers(void)
+{
+	static char	tsstr[NUM_PARSES / 100][32], dblstr[NUM_PARSES / 100][32];
+	SIMPLE_TIME	st_old, st_new;
+	BOOL		bZone;
+	int			zone, i, j, n = NUM_PARSES / 100, differences = 0;
+	double		dbl_old, dbl_new, sum_old = 0, sum_new = 0;
+	clock_t		start;
+	char	   *end;
+
+	for (i = 0; i < n; i++)
+	{
+		/* like the server, without the trailing zeros of the fraction */
+		snprintf(tsstr[i], sizeof(tsstr[i]), "2024-%02d-%02d %02d:%02d:%02d.%06d",
+				 1 + i % 12, 1 + i % 28, i % 24, i % 60, (i * 7) % 60, i * 37 % 1000000);
+		for (end = tsstr[i] + strlen(tsstr[i]) - 1; '0' == *end; end--)
+			*end = '\0';
+		if ('.' == *end)
+			*end = '\0';
+		snprintf(dblstr[i], sizeof(dblstr[i]), "%.15g", (i - n / 2) * (i % 2 ? 0.125 : 1e-7));
+	}
+	for (i = 0; i < n; i++)
+	{
+		memset(&st_old, 0, sizeof(st_old));
+		memset(&st_new, 0, sizeof(st_new));
+		sscanf_timestamp(tsstr[i], &st_old);
+		if (!parse_canonical_timestamp(tsstr[i], &st_new, &bZone, &zone) ||
+			memcmp(&st_old, &st_new, sizeof(st_old)) != 0)
+			differences++;
+		dbl_old = strtod(dblstr[i], NULL);
+		if (!parse_canonical_double(dblstr[i], &dbl_new) || dbl_old != dbl_new)
+			differences++;
+	}
+	printf("compared %d timestamps and %d doubles, %d differences\n", n, n, differences);
+
+	start = clock();
+	for (j = 0; j < 100; j++)
+		for (i = 0; i < n; i++)
+		{
+			sscanf_timestamp(tsstr[i], &st_old);
+			sum_old += st_old.fr;
+		}
+	fprintf(stderr, "sscanf: %d timestamps in %.3f s of CPU time\n", NUM_PARSES,
+			(double) (clock() - start) / CLOCKS_PER_SEC);
+	start = clock();
+	for (j = 0; j < 100; j++)
+		for (i = 0; i < n; i++)
+		{
+			parse_canonical_timestamp(tsstr[i], &st_new, &bZone, &zone);
+			sum_new += st_new.fr;
+		}
+	fprintf(stderr, "parse_canonical_timestamp: %d timestamps in %.3f s of CPU time\n", NUM_PARSES,
+			(double) (clock() - start) / CLOCKS_PER_SEC);
+	start = clock();
+	for (j = 0; j < 100; j++)
+		for (i = 0; i < n; i++)
+			sum_old += strtod(dblstr[i], NULL);
+	fprintf(stderr, "strtod: %d doubles in %.3f s of CPU time\n", NUM_PARSES,
+			(double) (clock() - start) / CLOCKS_PER_SEC);
+	start = clock();
+	for (j = 0; j < 100; j++)
+		for (i = 0; i < n; i++)
+		{
+			parse_canonical_double(dblstr[i], &dbl_new);
+			sum_new += dbl_new;
+		}
+	fprintf(stderr, "parse_canonical_double: %d doubles in %.3f s of CPU time\n", NUM_PARSES,
+			(double) (clock() - start) / CLOCKS_PER_SEC);
+	/* don't let the loops be optimized away */
+	if (sum_old != sum_new)
+		fprintf(stderr, "the sums differ\n");
+}
+
+int main(int argc, char **argv)
+{
+	int			rc;
+	HSTMT		hstmt = SQL_NULL_HSTMT;
+
+	test_connect();
+
+	rc = SQLAllocHandle(SQL_HANDLE_STMT, conn, &hstmt);
+	if (!SQL_SUCCEEDED(rc))
+	{
+		print_diag("failed to allocate stmt handle", SQL_HANDLE_DBC, conn);
+		exit(1);
+	}
+	fetch_rows(hstmt);
+	fetch_date_bc(hstmt);
+
+	test_disconnect();
+
+	compare_parsers();
+
+	return 0;
+}
@@ -0,0 +1,89 @@
+/*
+ * Test reloading the rowsets of a keyset-driven cursor in batches of
+ * KeysetReloadBatch rows.
+ */
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "common.h"
+
+#define ROWSET_SIZE	8
+
+static void
+fetch_rowset(HSTMT hstmt, SQLSMALLINT orientation, SQLLEN offset)
+{
+	int			rc;
+	SQLULEN		nrows;
+	SQLINTEGER	id[ROWSET_SIZE];
+	char		t[ROWSET_SIZE][20];
+	SQLLEN		cbId[ROWSET_SIZE], cbT[ROWSET_SIZE];
+	int			i;
+
+	rc = SQLSetStmtAttr(hstmt, SQL_ATTR_ROWS_FETCHED_PTR, &nrows, 0);
+	CHECK_STMT_RESULT(rc, "SQLSetStmtAttr failed", hstmt);
+	rc = SQLBindCol(hstmt, 1, SQL_C_SLONG, id, 0, cbId);
+	CHECK_STMT_RESULT(rc, "SQLBindCol failed", hstmt);
+	rc = SQLBindCol(hstmt, 2, SQL_C_CHAR, t, sizeof(t[0]), cbT);
+	CHECK_STMT_RESULT(rc, "SQLBindCol failed", hstmt);
+
+	rc = SQLFetchScroll(hstmt, orientation, offset);
+	CHECK_STMT_RESULT(rc, "SQLFetchScroll failed", hstmt);
+	printf("fetched %d rows:", (int) nrows);
+	for (i = 0; i < (int) nrows; i++)
+		printf(" %d:%s", (int) id[i], t[i]);
+	printf("\n");
+
+	rc = SQLFreeStmt(hstmt, SQL_UNBIND);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+}
+
+static void
+runTest(const char *extraparams)
+{
+	int			rc;
+	HSTMT		hstmt = SQL_NULL_HSTMT;
+
+	printf("-- %s\n", extraparams);
+	test_connect_ext((char *) extraparams);
+
+	rc = SQLAllocHandle(SQL_HANDLE_STMT, conn, &hstmt);
+	if (!SQL_SUCCEEDED(rc))
+	{
+		print_diag("failed to allocate stmt handle", SQL_HANDLE_DBC, conn);
+		exit(1);
+	}
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "CREATE TEMPORARY TABLE keyset_reload_test (id int4 PRIMARY KEY, t varchar(20))", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "INSERT INTO keyset_reload_test SELECT g, 'row ' || g FROM generate_series(1, 30) g", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+
+	rc = SQLSetStmtAttr(hstmt, SQL_ATTR_CONCURRENCY, (SQLPOINTER) SQL_CONCUR_ROWVER, 0);
+	CHECK_STMT_RESULT(rc, "SQLSetStmtAttr failed", hstmt);
+	rc = SQLSetStmtAttr(hstmt, SQL_ATTR_CURSOR_TYPE, (SQLPOINTER) SQL_CURSOR_KEYSET_DRIVEN, 0);
+	CHECK_STMT_RESULT(rc, "SQLSetStmtAttr failed", hstmt);
+	rc = SQLSetStmtAttr(hstmt, SQL_ATTR_ROW_ARRAY_SIZE, (SQLPOINTER) ROWSET_SIZE, 0);
+	CHECK_STMT_RESULT(rc, "SQLSetStmtAttr failed", hstmt);
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "SELECT id, t FROM keyset_reload_test ORDER BY id", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+
+	/* each of these reloads the rowset from the keyset */
+	fetch_rowset(hstmt, SQL_FETCH_ABSOLUTE, 20);
+	fetch_rowset(hstmt, SQL_FETCH_PRIOR, 0);
+	fetch_rowset(hstmt, SQL_FETCH_LAST, 0);
+	fetch_rowset(hstmt, SQL_FETCH_FIRST, 0);
+
+	rc = SQLFreeStmt(hstmt, SQL_DROP);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+	test_disconnect();
+}
+
+int main(int argc, char **argv)
+{
+	runTest("KeysetReloadBatch=512");
+	runTest("KeysetReloadBatch=3");
+
+	return 0;
+}
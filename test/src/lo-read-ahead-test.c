@@ -0,0 +1,102 @@
+/*
+ * Test reading a large object in small pieces with SQLGetData, with and
+ * without reading ahead (LOReadAheadSize).
+ */
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "common.h"
+
+#define LO_SIZE		100000
+
+static void
+read_lo(HSTMT hstmt, SQLSMALLINT ctype, SQLLEN buflen)
+{
+	int			rc;
+	char		buf[4001];
+	char		oidstr[20];
+	char		sql[100];
+	SQLLEN		ind, firstind = 0;
+	int			calls = 0, total = 0, mismatches = 0;
+	int			i, len;
+
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "WITH l AS (SELECT lo_from_bytea(0, decode(string_agg(lpad(to_hex(g % 251), 2, '0'), '' ORDER BY g), 'hex')) AS o FROM generate_series(0, 99999) g) SELECT o::lo, o FROM l", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	rc = SQLFetch(hstmt);
+	CHECK_STMT_RESULT(rc, "SQLFetch failed", hstmt);
+	rc = SQLGetData(hstmt, 2, SQL_C_CHAR, oidstr, sizeof(oidstr), NULL);
+	CHECK_STMT_RESULT(rc, "SQLGetData failed", hstmt);
+
+	while (rc = SQLGetData(hstmt, 1, ctype, buf, buflen, &ind), SQL_SUCCEEDED(rc))
+	{
+		if (0 == calls)
+			firstind = ind;
+		calls++;
+		if (SQL_C_CHAR == ctype)
+		{
+			len = (int) strlen(buf) / 2;
+			for (i = 0; i < len; i++)
+			{
+				unsigned int	byte;
+
+				sscanf(buf + i * 2, "%2x", &byte);
+				if (byte != (unsigned int) ((total + i) % 251))
+					mismatches++;
+			}
+		}
+		else
+		{
+			len = (ind == SQL_NO_TOTAL || ind > buflen) ? (int) buflen : (int) ind;
+			for (i = 0; i < len; i++)
+			{
+				if ((unsigned char) buf[i] != (total + i) % 251)
+					mismatches++;
+			}
+		}
+		total += len;
+	}
+	if (rc != SQL_NO_DATA)
+		CHECK_STMT_RESULT(rc, "SQLGetData failed", hstmt);
+	printf("%s: first length %d, %d calls, %d bytes, %d mismatches\n",
+		   SQL_C_CHAR == ctype ? "char" : "binary", (int) firstind, calls,
+		   total, mismatches);
+
+	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+	snprintf(sql, sizeof(sql), "SELECT lo_unlink(%s)", oidstr);
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) sql, SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+}
+
+int main(int argc, char **argv)
+{
+	static char *connopts[] = {
+		"LOReadAheadSize=0",
+		"LOReadAheadSize=10000",
+		"LOReadAheadSize=3000"
+	};
+	int			rc, i;
+	HSTMT		hstmt = SQL_NULL_HSTMT;
+
+	for (i = 0; i < sizeof(connopts) / sizeof(connopts[0]); i++)
+	{
+		printf("-- %s\n", connopts[i]);
+		test_connect_ext(connopts[i]);
+
+		rc = SQLAllocHandle(SQL_HANDLE_STMT, conn, &hstmt);
+		if (!SQL_SUCCEEDED(rc))
+		{
+			print_diag("failed to allocate stmt handle", SQL_HANDLE_DBC, conn);
+			exit(1);
+		}
+		read_lo(hstmt, SQL_C_BINARY, 4000);
+		read_lo(hstmt, SQL_C_CHAR, 4001);
+
+		test_disconnect();
+	}
+
+	return 0;
+}
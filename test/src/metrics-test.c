@@ -0,0 +1,129 @@
+/*
+ * Test the performance metrics (CollectMetrics and SQL_ATTR_PGOPT_METRICS).
+ */
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "common.h"
+
+#define SQL_ATTR_PGOPT_METRICS	65552
+
+/*
+ * Print the metrics report. The times vary from run to run, so they
+ * are masked.
+ */
+static void
+print_metrics(void)
+{
+	SQLRETURN	rc;
+	char		report[4096];
+	SQLINTEGER	len;
+	char	   *p;
+
+	rc = SQLGetConnectAttr(conn, SQL_ATTR_PGOPT_METRICS, report, sizeof(report), &len);
+	if (!SQL_SUCCEEDED(rc))
+	{
+		print_diag("SQLGetConnectAttr failed", SQL_HANDLE_DBC, conn);
+		exit(1);
+	}
+	printf("metrics:\n");
+	for (p = report; *p; p++)
+	{
+		if (strncmp(p, "_usec=", 6) == 0)
+		{
+			printf("_usec=?");
+			for (p += 6; *p >= '0' && *p <= '9'; p++)
+				;
+			p--;
+		}
+		else
+			putchar(*p);
+	}
+}
+
+int main(int argc, char **argv)
+{
+	SQLRETURN	rc;
+	HSTMT		hstmt = SQL_NULL_HSTMT;
+	SQLINTEGER	nrows;
+	SQLINTEGER	id;
+	char		buf[20];
+	SQLLEN		ind1, ind2;
+
+	test_connect_ext("CollectMetrics=1");
+
+	/* forget the queries issued while connecting */
+	rc = SQLSetConnectAttr(conn, SQL_ATTR_PGOPT_METRICS, (SQLPOINTER) 1, 0);
+	if (!SQL_SUCCEEDED(rc))
+	{
+		print_diag("SQLSetConnectAttr failed", SQL_HANDLE_DBC, conn);
+		exit(1);
+	}
+	print_metrics();
+
+	rc = SQLAllocHandle(SQL_HANDLE_STMT, conn, &hstmt);
+	if (!SQL_SUCCEEDED(rc))
+	{
+		print_diag("failed to allocate stmt handle", SQL_HANDLE_DBC, conn);
+		exit(1);
+	}
+
+	rc = SQLPrepare(hstmt, (SQLCHAR *) "SELECT g, 'row' || g\n  FROM generate_series(1, ?) g", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLPrepare failed", hstmt);
+	rc = SQLBindParameter(hstmt, 1, SQL_PARAM_INPUT, SQL_C_SLONG, SQL_INTEGER, 0, 0, &nrows, 0, NULL);
+	CHECK_STMT_RESULT(rc, "SQLBindParameter failed", hstmt);
+	rc = SQLBindCol(hstmt, 1, SQL_C_SLONG, &id, 0, &ind1);
+	CHECK_STMT_RESULT(rc, "SQLBindCol failed", hstmt);
+	rc = SQLBindCol(hstmt, 2, SQL_C_CHAR, buf, sizeof(buf), &ind2);
+	CHECK_STMT_RESULT(rc, "SQLBindCol failed", hstmt);
+
+	/* 3 rows of 1 + 4 bytes, and 5 rows of 1 + 4 bytes */
+	for (nrows = 3; nrows <= 5; nrows += 2)
+	{
+		rc = SQLExecute(hstmt);
+		CHECK_STMT_RESULT(rc, "SQLExecute failed", hstmt);
+		while (SQL_SUCCEEDED(rc = SQLFetch(hstmt)))
+			;
+		if (rc != SQL_NO_DATA)
+			CHECK_STMT_RESULT(rc, "SQLFetch failed", hstmt);
+		rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+		CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+	}
+	print_metrics();
+
+	/* the connection keeps the metrics of a freed statement */
+	rc = SQLFreeStmt(hstmt, SQL_DROP);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+	print_metrics();
+
+	/* the same query of another statement adds to the same line */
+	rc = SQLAllocHandle(SQL_HANDLE_STMT, conn, &hstmt);
+	if (!SQL_SUCCEEDED(rc))
+	{
+		print_diag("failed to allocate stmt handle", SQL_HANDLE_DBC, conn);
+		exit(1);
+	}
+	rc = SQLBindParameter(hstmt, 1, SQL_PARAM_INPUT, SQL_C_SLONG, SQL_INTEGER, 0, 0, &nrows, 0, NULL);
+	CHECK_STMT_RESULT(rc, "SQLBindParameter failed", hstmt);
+	nrows = 1;
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "SELECT g, 'row' || g FROM generate_series(1, ?) g", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	print_result(hstmt);
+	rc = SQLFreeStmt(hstmt, SQL_DROP);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+	print_metrics();
+
+	/* turn off and reset */
+	rc = SQLSetConnectAttr(conn, SQL_ATTR_PGOPT_METRICS, (SQLPOINTER) 0, 0);
+	if (!SQL_SUCCEEDED(rc))
+	{
+		print_diag("SQLSetConnectAttr failed", SQL_HANDLE_DBC, conn);
+		exit(1);
+	}
+	print_metrics();
+
+	test_disconnect();
+
+	return 0;
+}
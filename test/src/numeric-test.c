@@ -215,6 +215,10 @@ int main(int argc, char **argv)
 	test_numeric_result(hstmt, "0");
 	test_numeric_result(hstmt, "-7.70");
 	test_numeric_result(hstmt, "999999999999");
+	/* up to 19 digits are converted in 64 bits */
+	test_numeric_result(hstmt, "9999999999999999999");
+	test_numeric_result(hstmt, "0.0000000000000000001");
+	test_numeric_result(hstmt, "18446744073709551616");
 
 	/* Clean up */
 	test_disconnect();
@@ -0,0 +1,115 @@
+/*
+ * Test converting large column-wise bound rowsets by worker threads
+ * (ConvertThreads).
+ */
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "common.h"
+
+#define ROWSET_SIZE	10000
+
+static SQLINTEGER	i4[ROWSET_SIZE];
+static SQLBIGINT	i8[ROWSET_SIZE];
+static SQLDOUBLE	f8[ROWSET_SIZE];
+static char		txt[ROWSET_SIZE][8];
+static DATE_STRUCT	dt[ROWSET_SIZE];
+static SQLLEN		cbI4[ROWSET_SIZE], cbI8[ROWSET_SIZE], cbF8[ROWSET_SIZE],
+					cbTxt[ROWSET_SIZE], cbDt[ROWSET_SIZE];
+static SQLUSMALLINT	rowStatus[ROWSET_SIZE];
+
+static void
+fetch_rowsets(HSTMT hstmt)
+{
+	int			rc;
+	SQLULEN		nrows;
+	int			i, nulls, truncated, withinfo, errors;
+	long long	sumI4, sumI8, sumLen;
+	double		sumF8;
+
+	rc = SQLSetStmtAttr(hstmt, SQL_ATTR_ROW_ARRAY_SIZE, (SQLPOINTER) ROWSET_SIZE, 0);
+	CHECK_STMT_RESULT(rc, "SQLSetStmtAttr failed", hstmt);
+	rc = SQLSetStmtAttr(hstmt, SQL_ATTR_ROWS_FETCHED_PTR, &nrows, 0);
+	CHECK_STMT_RESULT(rc, "SQLSetStmtAttr failed", hstmt);
+	rc = SQLSetStmtAttr(hstmt, SQL_ATTR_ROW_STATUS_PTR, rowStatus, 0);
+	CHECK_STMT_RESULT(rc, "SQLSetStmtAttr failed", hstmt);
+
+	rc = SQLBindCol(hstmt, 1, SQL_C_SLONG, i4, 0, cbI4);
+	CHECK_STMT_RESULT(rc, "SQLBindCol failed", hstmt);
+	rc = SQLBindCol(hstmt, 2, SQL_C_SBIGINT, i8, 0, cbI8);
+	CHECK_STMT_RESULT(rc, "SQLBindCol failed", hstmt);
+	rc = SQLBindCol(hstmt, 3, SQL_C_DOUBLE, f8, 0, cbF8);
+	CHECK_STMT_RESULT(rc, "SQLBindCol failed", hstmt);
+	rc = SQLBindCol(hstmt, 4, SQL_C_CHAR, txt, sizeof(txt[0]), cbTxt);
+	CHECK_STMT_RESULT(rc, "SQLBindCol failed", hstmt);
+	/* not converted by a bulk kernel */
+	rc = SQLBindCol(hstmt, 5, SQL_C_TYPE_DATE, dt, sizeof(dt[0]), cbDt);
+	CHECK_STMT_RESULT(rc, "SQLBindCol failed", hstmt);
+
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "SELECT g, g * 10000000000::int8, g / 4.0::float8, CASE WHEN g % 1000 = 500 THEN NULL WHEN g % 7777 = 0 THEN 'truncated value' ELSE 'v' || g END, '2000-01-01'::date + g FROM generate_series(1, 25000) g", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	while (rc = SQLFetchScroll(hstmt, SQL_FETCH_NEXT, 0), SQL_SUCCEEDED(rc))
+	{
+		nulls = truncated = withinfo = errors = 0;
+		sumI4 = sumI8 = sumLen = 0;
+		sumF8 = 0;
+		for (i = 0; i < (int) nrows; i++)
+		{
+			sumI4 += i4[i];
+			sumI8 += i8[i];
+			sumF8 += f8[i];
+			if (rowStatus[i] == SQL_ROW_SUCCESS_WITH_INFO)
+				withinfo++;
+			else if (rowStatus[i] != SQL_ROW_SUCCESS)
+				errors++;
+			if (cbTxt[i] == SQL_NULL_DATA)
+				nulls++;
+			else
+			{
+				if (cbTxt[i] >= (SQLLEN) sizeof(txt[0]))
+					truncated++;
+				sumLen += strlen(txt[i]);
+			}
+		}
+		printf("fetch returns %d, %d rows: first %d %s last %d %s\n", rc, (int) nrows, (int) i4[0], txt[0], (int) i4[nrows - 1], txt[nrows - 1]);
+		printf("dates %04d-%02d-%02d .. %04d-%02d-%02d\n", dt[0].year, dt[0].month, dt[0].day, dt[nrows - 1].year, dt[nrows - 1].month, dt[nrows - 1].day);
+		printf("sums %lld %lld %.2f, text length %lld, %d nulls, %d truncated, %d with info, %d errors\n", sumI4, sumI8, sumF8, sumLen, nulls, truncated, withinfo, errors);
+	}
+	if (rc != SQL_NO_DATA)
+		CHECK_STMT_RESULT(rc, "SQLFetchScroll failed", hstmt);
+
+	rc = SQLFreeStmt(hstmt, SQL_UNBIND);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+}
+
+int main(int argc, char **argv)
+{
+	static char *connopts[] = {
+		"ConvertThreads=0",
+		"ConvertThreads=3",
+		"ConvertThreads=3;BinaryResults=1"
+	};
+	int			rc, i;
+	HSTMT		hstmt = SQL_NULL_HSTMT;
+
+	for (i = 0; i < sizeof(connopts) / sizeof(connopts[0]); i++)
+	{
+		printf("-- %s\n", connopts[i]);
+		test_connect_ext(connopts[i]);
+
+		rc = SQLAllocHandle(SQL_HANDLE_STMT, conn, &hstmt);
+		if (!SQL_SUCCEEDED(rc))
+		{
+			print_diag("failed to allocate stmt handle", SQL_HANDLE_DBC, conn);
+			exit(1);
+		}
+		fetch_rowsets(hstmt);
+
+		test_disconnect();
+	}
+
+	return 0;
+}
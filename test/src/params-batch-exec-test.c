@@ -72,13 +72,11 @@ static SQLRETURN	BatchExecute(HDBC conn, int batch_size)
 	return rc;
 }
 
-int main(int argc, char **argv)
+static void CreateTestObjects(void)
 {
 	SQLRETURN rc;
 	HSTMT hstmt = SQL_NULL_HSTMT;
 
-	test_connect();
-
 	rc = SQLAllocHandle(SQL_HANDLE_STMT, conn, &hstmt);
 	if (!SQL_SUCCEEDED(rc))
 	{
@@ -111,6 +109,25 @@ int main(int argc, char **argv)
 		, SQL_NTS);
 	CHECK_STMT_RESULT(rc, "create trigger failed", hstmt);
 
+	rc = SQLFreeStmt(hstmt, SQL_DROP);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+}
+
+int main(int argc, char **argv)
+{
+	SQLRETURN rc;
+	HSTMT hstmt = SQL_NULL_HSTMT;
+
+	test_connect();
+	CreateTestObjects();
+
+	rc = SQLAllocHandle(SQL_HANDLE_STMT, conn, &hstmt);
+	if (!SQL_SUCCEEDED(rc))
+	{
+		print_diag("failed to allocate stmt handle", SQL_HANDLE_DBC, conn);
+		exit(1);
+	}
+
 	/* 1 by 1 executiton */
 	printf("one by one execution\n");
 	BatchExecute(conn, 1);
@@ -124,5 +141,17 @@ int main(int argc, char **argv)
 	/* Clean up */
 	test_disconnect();
 
+	/*
+	 * pipelined executiton batch_size=2, the results are the same as the
+	 * batch execution
+	 */
+	test_connect_ext("UsePipeline=1");
+	CreateTestObjects();
+	printf("pipelined execution\n");
+	BatchExecute(conn, 2);
+
+	/* Clean up */
+	test_disconnect();
+
 	return 0;
 }
@@ -0,0 +1,102 @@
+/*
+ * Test sharing the server side prepared statements among the statement
+ * handles of a connection (PlanCacheSize).
+ */
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "common.h"
+
+static HSTMT
+prepare_and_execute(const char *sql, SQLINTEGER param)
+{
+	int			rc;
+	HSTMT		hstmt = SQL_NULL_HSTMT;
+	SQLLEN		cbParam = sizeof(param);
+	SQLINTEGER	result;
+
+	rc = SQLAllocHandle(SQL_HANDLE_STMT, conn, &hstmt);
+	if (!SQL_SUCCEEDED(rc))
+	{
+		print_diag("failed to allocate stmt handle", SQL_HANDLE_DBC, conn);
+		exit(1);
+	}
+	rc = SQLPrepare(hstmt, (SQLCHAR *) sql, SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLPrepare failed", hstmt);
+	rc = SQLBindParameter(hstmt, 1, SQL_PARAM_INPUT, SQL_C_SLONG, SQL_INTEGER, 0, 0, &param, 0, &cbParam);
+	CHECK_STMT_RESULT(rc, "SQLBindParameter failed", hstmt);
+	rc = SQLExecute(hstmt);
+	CHECK_STMT_RESULT(rc, "SQLExecute failed", hstmt);
+	rc = SQLFetch(hstmt);
+	CHECK_STMT_RESULT(rc, "SQLFetch failed", hstmt);
+	rc = SQLGetData(hstmt, 1, SQL_C_SLONG, &result, 0, NULL);
+	CHECK_STMT_RESULT(rc, "SQLGetData failed", hstmt);
+	printf("result: %d\n", (int) result);
+	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+
+	return hstmt;
+}
+
+static void
+drop_stmt(HSTMT hstmt)
+{
+	int			rc;
+
+	rc = SQLFreeStmt(hstmt, SQL_DROP);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+}
+
+static void
+print_prepared_statements(const char *label)
+{
+	int			rc;
+	HSTMT		hstmt = SQL_NULL_HSTMT;
+
+	printf("%s\n", label);
+	rc = SQLAllocHandle(SQL_HANDLE_STMT, conn, &hstmt);
+	if (!SQL_SUCCEEDED(rc))
+	{
+		print_diag("failed to allocate stmt handle", SQL_HANDLE_DBC, conn);
+		exit(1);
+	}
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "SELECT count(*), count(*) FILTER (WHERE name LIKE '\\_PLANC%') FROM pg_prepared_statements", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	print_result(hstmt);
+	drop_stmt(hstmt);
+}
+
+static void
+runTest(const char *extraparams)
+{
+	HSTMT		hstmt1, hstmt2;
+
+	printf("-- %s\n", extraparams);
+	test_connect_ext((char *) extraparams);
+
+	hstmt1 = prepare_and_execute("SELECT 1 + ?::int4", 1);
+	hstmt2 = prepare_and_execute("SELECT 1 + ?::int4", 2);
+	print_prepared_statements("two handles preparing the same query");
+
+	drop_stmt(hstmt1);
+	drop_stmt(hstmt2);
+	print_prepared_statements("after dropping the handles");
+
+	/* fill the cache with other queries */
+	hstmt1 = prepare_and_execute("SELECT 2 + ?::int4", 1);
+	drop_stmt(hstmt1);
+	hstmt1 = prepare_and_execute("SELECT 3 + ?::int4", 1);
+	drop_stmt(hstmt1);
+	print_prepared_statements("after preparing two other queries");
+
+	test_disconnect();
+}
+
+int main(int argc, char **argv)
+{
+	runTest("UseServerSidePrepare=1;PlanCacheSize=0");
+	runTest("UseServerSidePrepare=1;PlanCacheSize=2");
+
+	return 0;
+}
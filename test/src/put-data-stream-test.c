@@ -0,0 +1,144 @@
+/*
+ * Test sending large data-at-execution parameters by many SQLPutData
+ * calls, to a large object and to a bytea column.
+ */
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "common.h"
+
+#define DATA_SIZE	2500000
+
+static char data[DATA_SIZE];
+
+/* md5 of the first len bytes of data[] */
+#define MD5_OF_DATA(len) "(SELECT md5(decode(string_agg(lpad(to_hex(g % 251), 2, '0'), '' ORDER BY g), 'hex')) FROM generate_series(0, " len " - 1) g)"
+
+/*
+ * Execute sql with a data-at-execution parameter, given by the pieces of
+ * the chunk sizes in chunks[].
+ */
+static void
+put_data(HSTMT hstmt, const char *sql, SQLSMALLINT sqltype, SQLLEN lenind, const int *chunks)
+{
+	int			rc;
+	SQLPOINTER	pParamId = NULL;
+	int			pos = 0, calls = 0;
+
+	rc = SQLPrepare(hstmt, (SQLCHAR *) sql, SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLPrepare failed", hstmt);
+	rc = SQLBindParameter(hstmt, 1, SQL_PARAM_INPUT, SQL_C_BINARY, sqltype,
+						  0, 0, data, 0, &lenind);
+	CHECK_STMT_RESULT(rc, "SQLBindParameter failed", hstmt);
+
+	rc = SQLExecute(hstmt);
+	if (SQL_NEED_DATA != rc)
+	{
+		print_diag("SQLExecute didn't return SQL_NEED_DATA as expected",
+				   SQL_HANDLE_STMT, hstmt);
+		exit(1);
+	}
+	rc = SQLParamData(hstmt, &pParamId);
+	if (SQL_NEED_DATA != rc)
+	{
+		print_diag("SQLParamData didn't return SQL_NEED_DATA as expected",
+				   SQL_HANDLE_STMT, hstmt);
+		exit(1);
+	}
+	/* chunks[] is a list of (count, size) terminated by 0 */
+	for (; chunks[0] > 0; chunks += 2)
+	{
+		int		i;
+
+		for (i = 0; i < chunks[0]; i++, calls++)
+		{
+			rc = SQLPutData(hstmt, (char *) pParamId + pos, chunks[1]);
+			CHECK_STMT_RESULT(rc, "SQLPutData failed", hstmt);
+			pos += chunks[1];
+		}
+	}
+	rc = SQLParamData(hstmt, &pParamId);
+	CHECK_STMT_RESULT(rc, "SQLParamData failed", hstmt);
+	printf("sent %d bytes by %d calls\n", pos, calls);
+
+	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+}
+
+static void
+exec_and_print(HSTMT hstmt, const char *sql)
+{
+	int			rc;
+
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) sql, SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	print_result(hstmt);
+	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+}
+
+static void
+test_bytea(HSTMT hstmt)
+{
+	static const int chunks[] = {300, 1000, 0};
+	int			rc;
+
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "CREATE TEMPORARY TABLE putdatatbl (id int4, b bytea)", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+
+	/* with and without the total length */
+	put_data(hstmt, "INSERT INTO putdatatbl VALUES (1, ?)", SQL_VARBINARY, SQL_LEN_DATA_AT_EXEC(300000), chunks);
+	put_data(hstmt, "INSERT INTO putdatatbl VALUES (2, ?)", SQL_VARBINARY, SQL_DATA_AT_EXEC, chunks);
+	exec_and_print(hstmt, "SELECT id, length(b), CASE WHEN md5(b) = " MD5_OF_DATA("300000") " THEN 'match' ELSE 'mismatch' END FROM putdatatbl ORDER BY id");
+
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "DROP TABLE putdatatbl", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+}
+
+static void
+test_lo(HSTMT hstmt)
+{
+	/* small pieces, a piece larger than the write buffer, small pieces */
+	static const int chunks[] = {1000, 1000, 1, 1200000, 100, 3000, 0};
+	int			rc;
+
+	put_data(hstmt, "INSERT INTO lo_test_tab VALUES (301, ?)", SQL_LONGVARBINARY, SQL_DATA_AT_EXEC, chunks);
+	exec_and_print(hstmt, "SELECT id, length(lo_get(large_data)), CASE WHEN md5(lo_get(large_data)) = " MD5_OF_DATA("2500000") " THEN 'match' ELSE 'mismatch' END FROM lo_test_tab WHERE id = 301");
+	exec_and_print(hstmt, "SELECT lo_unlink(large_data) FROM lo_test_tab WHERE id = 301");
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "DELETE FROM lo_test_tab WHERE id = 301", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+}
+
+int main(int argc, char **argv)
+{
+	int			rc, i;
+	HSTMT		hstmt = SQL_NULL_HSTMT;
+
+	for (i = 0; i < DATA_SIZE; i++)
+		data[i] = (char) (i % 251);
+
+	test_connect();
+	rc = SQLAllocHandle(SQL_HANDLE_STMT, conn, &hstmt);
+	if (!SQL_SUCCEEDED(rc))
+	{
+		print_diag("failed to allocate stmt handle", SQL_HANDLE_DBC, conn);
+		exit(1);
+	}
+	test_lo(hstmt);
+	test_bytea(hstmt);
+	test_disconnect();
+
+	printf("-- UseServerSidePrepare=0\n");
+	test_connect_ext("UseServerSidePrepare=0");
+	rc = SQLAllocHandle(SQL_HANDLE_STMT, conn, &hstmt);
+	if (!SQL_SUCCEEDED(rc))
+	{
+		print_diag("failed to allocate stmt handle", SQL_HANDLE_DBC, conn);
+		exit(1);
+	}
+	test_bytea(hstmt);
+	test_disconnect();
+
+	return 0;
+}
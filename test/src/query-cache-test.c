@@ -0,0 +1,108 @@
+/*
+ * Test executing the same statements again with the query cache
+ * (QueryCacheSize) when the parameters are substituted on the driver
+ * side.
+ */
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "common.h"
+
+static HSTMT
+alloc_stmt(void)
+{
+	int			rc;
+	HSTMT		hstmt = SQL_NULL_HSTMT;
+
+	rc = SQLAllocHandle(SQL_HANDLE_STMT, conn, &hstmt);
+	if (!SQL_SUCCEEDED(rc))
+	{
+		print_diag("failed to allocate stmt handle", SQL_HANDLE_DBC, conn);
+		exit(1);
+	}
+	return hstmt;
+}
+
+static void
+execute_with(HSTMT hstmt, const char *sql, const char *param1, SQLINTEGER param2)
+{
+	int			rc;
+	SQLLEN		cbParam1 = param1 ? SQL_NTS : SQL_NULL_DATA;
+	SQLLEN		cbParam2 = sizeof(param2);
+
+	rc = SQLBindParameter(hstmt, 1, SQL_PARAM_INPUT, SQL_C_CHAR, SQL_VARCHAR, 20, 0, (SQLPOINTER) param1, 0, &cbParam1);
+	CHECK_STMT_RESULT(rc, "SQLBindParameter failed", hstmt);
+	rc = SQLBindParameter(hstmt, 2, SQL_PARAM_INPUT, SQL_C_SLONG, SQL_INTEGER, 0, 0, &param2, 0, &cbParam2);
+	CHECK_STMT_RESULT(rc, "SQLBindParameter failed", hstmt);
+	if (sql)
+		rc = SQLExecDirect(hstmt, (SQLCHAR *) sql, SQL_NTS);
+	else
+		rc = SQLExecute(hstmt);
+	CHECK_STMT_RESULT(rc, "SQLExecute failed", hstmt);
+	print_result(hstmt);
+	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+}
+
+static void
+exec_sql(HSTMT hstmt, const char *sql)
+{
+	int			rc;
+
+	rc = SQLFreeStmt(hstmt, SQL_RESET_PARAMS);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) sql, SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+}
+
+static void
+runTest(const char *extraparams)
+{
+	static const char *sql = "SELECT ? || '?', /* ? */ {fn LCASE('XY')}, ? + 1 -- ?\n";
+	static const char *escsql = "SELECT {fn UCASE(?)}, ? * 2";
+	static const char *idsql = "SELECT @@identity, ? || '', ?";
+	int			rc;
+	HSTMT		hstmt1, hstmt2;
+
+	printf("-- %s\n", extraparams);
+	test_connect_ext((char *) extraparams);
+	hstmt1 = alloc_stmt();
+	hstmt2 = alloc_stmt();
+
+	rc = SQLPrepare(hstmt1, (SQLCHAR *) sql, SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLPrepare failed", hstmt1);
+	execute_with(hstmt1, NULL, "first", 1);
+	execute_with(hstmt1, NULL, "it's", 2);
+	execute_with(hstmt1, NULL, NULL, 3);
+	/* another statement handle */
+	execute_with(hstmt2, sql, "other", 4);
+
+	/* a parameter in an escape */
+	execute_with(hstmt2, escsql, "esc", 5);
+	execute_with(hstmt2, escsql, "again", 6);
+
+	/* evict the first one */
+	execute_with(hstmt2, "SELECT ? || '-', ?", "evict", 7);
+	execute_with(hstmt1, NULL, "back", 8);
+
+	/* @@identity follows the table of the last insert */
+	exec_sql(hstmt2, "CREATE TEMPORARY TABLE qc_a (id serial, t text)");
+	exec_sql(hstmt2, "CREATE TEMPORARY TABLE qc_b (id serial, t text)");
+	exec_sql(hstmt2, "INSERT INTO qc_a (t) VALUES ('a')");
+	execute_with(hstmt2, idsql, "a", 9);
+	exec_sql(hstmt2, "INSERT INTO qc_b (t) VALUES ('b'), ('b'), ('b')");
+	execute_with(hstmt2, idsql, "b", 10);
+
+	test_disconnect();
+}
+
+int main(int argc, char **argv)
+{
+	runTest("UseServerSidePrepare=0;QueryCacheSize=0");
+	runTest("UseServerSidePrepare=0;QueryCacheSize=1");
+
+	return 0;
+}
@@ -0,0 +1,77 @@
+/*
+ * Test reading query results with the various ResultChunkSize settings.
+ */
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "common.h"
+
+static void
+runTest(HSTMT hstmt)
+{
+	int			rc;
+	SQLINTEGER	id;
+	SQLLEN		cbId;
+	int			rows = 0;
+	long		total = 0;
+
+	/**** A small result set including a NULL value ****/
+
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "select g, case when g = 3 then null else 'foo' || g end from generate_series(1, 5) as g", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	print_result(hstmt);
+
+	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+
+	/**** A result set spanning many chunks ****/
+
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "select g from generate_series(1, 1000) as g", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	rc = SQLBindCol(hstmt, 1, SQL_C_SLONG, &id, 0, &cbId);
+	CHECK_STMT_RESULT(rc, "SQLBindCol failed", hstmt);
+	while (rc = SQLFetch(hstmt), SQL_SUCCEEDED(rc))
+	{
+		rows++;
+		total += id;
+	}
+	if (SQL_NO_DATA != rc)
+		CHECK_STMT_RESULT(rc, "SQLFetch failed", hstmt);
+	printf("fetched %d rows, total %ld\n", rows, total);
+
+	rc = SQLFreeStmt(hstmt, SQL_UNBIND);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+}
+
+int main(int argc, char **argv)
+{
+	static char *connopts[] = {
+		"ResultChunkSize=0",
+		"ResultChunkSize=1",
+		"ResultChunkSize=7"
+	};
+	int			rc, i;
+	HSTMT		hstmt = SQL_NULL_HSTMT;
+
+	for (i = 0; i < sizeof(connopts) / sizeof(connopts[0]); i++)
+	{
+		printf("-- %s\n", connopts[i]);
+		test_connect_ext(connopts[i]);
+
+		rc = SQLAllocHandle(SQL_HANDLE_STMT, conn, &hstmt);
+		if (!SQL_SUCCEEDED(rc))
+		{
+			print_diag("failed to allocate stmt handle", SQL_HANDLE_DBC, conn);
+			exit(1);
+		}
+		runTest(hstmt);
+
+		/* Clean up */
+		test_disconnect();
+	}
+
+	return 0;
+}
@@ -0,0 +1,149 @@
+/*
+ * Test converting long UTF-16 strings to and from UTF-8, which go through
+ * the vectorised ASCII fast paths, mixed with non-ASCII characters.
+ */
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "common.h"
+
+#define	TEXT_LEN	300
+
+static int
+make_text(SQLWCHAR *wstr, int ascii_only)
+{
+	const char *ascii = "The quick brown fox jumps over the lazy dog. ";
+	int			len = 0, i;
+
+	for (i = 0; i < 100; i++)
+		wstr[len++] = ascii[i % strlen(ascii)];
+	if (!ascii_only)
+	{
+		wstr[len++] = 0x00e9;	/* 2 bytes in UTF-8 */
+		wstr[len++] = 0x20ac;	/* 3 bytes */
+		wstr[len++] = 0xd83d;	/* a surrogate pair, 4 bytes */
+		wstr[len++] = 0xde00;
+		wstr[len++] = '\n';
+	}
+	for (i = 0; i < 40; i++)
+		wstr[len++] = 'a' + i % 26;
+	wstr[len] = 0;
+
+	return len;
+}
+
+static void
+round_trip(HSTMT hstmt, int ascii_only)
+{
+	int			rc, len, i;
+	SQLWCHAR	text[TEXT_LEN], fetched[TEXT_LEN], chunk[21];
+	SQLLEN		cbText, cbFetched, cbChunk;
+	SQLINTEGER	nchars, nbytes;
+	SQLWCHAR	query[200];
+	const char *sql = "SELECT t, length(t), octet_length(t) FROM (SELECT ?::text AS t) AS s";
+
+	len = make_text(text, ascii_only);
+	for (i = 0; sql[i]; i++)
+		query[i] = sql[i];
+	query[i] = 0;
+
+	cbText = len * sizeof(SQLWCHAR);
+	rc = SQLBindParameter(hstmt, 1, SQL_PARAM_INPUT, SQL_C_WCHAR, SQL_WVARCHAR, TEXT_LEN, 0, text, sizeof(text), &cbText);
+	CHECK_STMT_RESULT(rc, "SQLBindParameter failed", hstmt);
+	rc = SQLExecDirectW(hstmt, query, SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirectW failed", hstmt);
+	rc = SQLFetch(hstmt);
+	CHECK_STMT_RESULT(rc, "SQLFetch failed", hstmt);
+	rc = SQLGetData(hstmt, 2, SQL_C_SLONG, &nchars, 0, NULL);
+	CHECK_STMT_RESULT(rc, "SQLGetData failed", hstmt);
+	rc = SQLGetData(hstmt, 3, SQL_C_SLONG, &nbytes, 0, NULL);
+	CHECK_STMT_RESULT(rc, "SQLGetData failed", hstmt);
+	printf("length %d, octet_length %d\n", (int) nchars, (int) nbytes);
+
+	/* fetch the whole text at once */
+	rc = SQLGetData(hstmt, 1, SQL_C_WCHAR, fetched, sizeof(fetched), &cbFetched);
+	CHECK_STMT_RESULT(rc, "SQLGetData failed", hstmt);
+	printf("whole: %s\n",
+		   cbFetched == len * sizeof(SQLWCHAR) && memcmp(fetched, text, (len + 1) * sizeof(SQLWCHAR)) == 0 ? "ok" : "differs");
+	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+
+	/* and in pieces smaller than the vector blocks */
+	rc = SQLExecDirectW(hstmt, query, SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirectW failed", hstmt);
+	rc = SQLFetch(hstmt);
+	CHECK_STMT_RESULT(rc, "SQLFetch failed", hstmt);
+	i = 0;
+	while (rc = SQLGetData(hstmt, 1, SQL_C_WCHAR, chunk, sizeof(chunk), &cbChunk), SQL_SUCCEEDED(rc))
+	{
+		int		n = (int) (sizeof(chunk) / sizeof(SQLWCHAR)) - 1;
+
+		if (rc == SQL_SUCCESS)
+			n = (int) (cbChunk / sizeof(SQLWCHAR));
+		if (i + n < TEXT_LEN)
+			memcpy(fetched + i, chunk, n * sizeof(SQLWCHAR));
+		i += n;
+	}
+	if (rc != SQL_NO_DATA)
+		CHECK_STMT_RESULT(rc, "SQLGetData failed", hstmt);
+	printf("pieces: %s\n",
+		   i == len && memcmp(fetched, text, len * sizeof(SQLWCHAR)) == 0 ? "ok" : "differs");
+
+	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+	rc = SQLFreeStmt(hstmt, SQL_RESET_PARAMS);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+}
+
+/*
+ * Fetch into a bound column, which is converted into the application
+ * buffer directly unless it's too small.
+ */
+static void
+bound_rows(HSTMT hstmt)
+{
+	int			rc, i;
+	SQLWCHAR	buf[32];
+	SQLLEN		ind;
+
+	rc = SQLBindCol(hstmt, 1, SQL_C_WCHAR, buf, sizeof(buf), &ind);
+	CHECK_STMT_RESULT(rc, "SQLBindCol failed", hstmt);
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "SELECT repeat('x', g * 7) || chr(233) FROM generate_series(1, 6) g", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	while (rc = SQLFetch(hstmt), SQL_SUCCEEDED(rc))
+	{
+		for (i = 0; buf[i]; i++)
+			;
+		printf("fetch returns %d, %d chars, %d in buffer, last U+%04X\n",
+			   rc, (int) (ind / sizeof(SQLWCHAR)), i, i > 0 ? buf[i - 1] : 0);
+	}
+	if (rc != SQL_NO_DATA)
+		CHECK_STMT_RESULT(rc, "SQLFetch failed", hstmt);
+	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+	rc = SQLFreeStmt(hstmt, SQL_UNBIND);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+}
+
+int main(int argc, char **argv)
+{
+	int			rc;
+	HSTMT		hstmt = SQL_NULL_HSTMT;
+
+	test_connect_ext("LFConversion=0");
+	rc = SQLAllocHandle(SQL_HANDLE_STMT, conn, &hstmt);
+	if (!SQL_SUCCEEDED(rc))
+	{
+		print_diag("failed to allocate stmt handle", SQL_HANDLE_DBC, conn);
+		exit(1);
+	}
+
+	round_trip(hstmt, 1);
+	round_trip(hstmt, 0);
+	bound_rows(hstmt);
+
+	test_disconnect();
+
+	return 0;
+}
@@ -0,0 +1,122 @@
+/*
+ * Test serving the fetched values straight from the PGresults
+ * (ZeroCopyFetch), with and without declare/fetch cursors.
+ */
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "common.h"
+
+static void
+fetch_bound(HSTMT hstmt)
+{
+	int			rc;
+	SQLINTEGER	id;
+	char		txt[16];
+	SQLLEN		cbId, cbTxt;
+
+	rc = SQLBindCol(hstmt, 1, SQL_C_SLONG, &id, 0, &cbId);
+	CHECK_STMT_RESULT(rc, "SQLBindCol failed", hstmt);
+	rc = SQLBindCol(hstmt, 2, SQL_C_CHAR, txt, sizeof(txt), &cbTxt);
+	CHECK_STMT_RESULT(rc, "SQLBindCol failed", hstmt);
+
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "SELECT g, CASE WHEN g % 4 = 0 THEN NULL ELSE 'row ' || g END FROM generate_series(1, 12) g", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	while (rc = SQLFetch(hstmt), SQL_SUCCEEDED(rc))
+	{
+		if (cbTxt == SQL_NULL_DATA)
+			printf("%d NULL\n", (int) id);
+		else
+			printf("%d %s(%d)\n", (int) id, txt, (int) cbTxt);
+	}
+	if (rc != SQL_NO_DATA)
+		CHECK_STMT_RESULT(rc, "SQLFetch failed", hstmt);
+
+	rc = SQLFreeStmt(hstmt, SQL_UNBIND);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+}
+
+static void
+fetch_in_pieces(HSTMT hstmt)
+{
+	int			rc;
+	char		buf[11];
+	SQLLEN		ind;
+
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "SELECT repeat(chr(ascii('a') + g), 25) FROM generate_series(0, 2) g", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	while (rc = SQLFetch(hstmt), SQL_SUCCEEDED(rc))
+	{
+		while (rc = SQLGetData(hstmt, 1, SQL_C_CHAR, buf, sizeof(buf), &ind), SQL_SUCCEEDED(rc))
+			printf("piece: %s(%d)\n", buf, (int) ind);
+		if (rc != SQL_NO_DATA)
+			CHECK_STMT_RESULT(rc, "SQLGetData failed", hstmt);
+	}
+	if (rc != SQL_NO_DATA)
+		CHECK_STMT_RESULT(rc, "SQLFetch failed", hstmt);
+
+	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+}
+
+static void
+fetch_scrollable(HSTMT hstmt)
+{
+	int			rc;
+	char		buf[16];
+
+	/* the values of scrollable cursors are copied as before */
+	rc = SQLSetStmtAttr(hstmt, SQL_ATTR_CURSOR_TYPE, (SQLPOINTER) SQL_CURSOR_STATIC, 0);
+	CHECK_STMT_RESULT(rc, "SQLSetStmtAttr failed", hstmt);
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "SELECT 'scroll ' || g FROM generate_series(1, 7) g", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	rc = SQLFetchScroll(hstmt, SQL_FETCH_LAST, 0);
+	CHECK_STMT_RESULT(rc, "SQLFetchScroll failed", hstmt);
+	rc = SQLGetData(hstmt, 1, SQL_C_CHAR, buf, sizeof(buf), NULL);
+	CHECK_STMT_RESULT(rc, "SQLGetData failed", hstmt);
+	printf("last: %s\n", buf);
+	rc = SQLFetchScroll(hstmt, SQL_FETCH_ABSOLUTE, 2);
+	CHECK_STMT_RESULT(rc, "SQLFetchScroll failed", hstmt);
+	rc = SQLGetData(hstmt, 1, SQL_C_CHAR, buf, sizeof(buf), NULL);
+	CHECK_STMT_RESULT(rc, "SQLGetData failed", hstmt);
+	printf("absolute 2: %s\n", buf);
+
+	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+	rc = SQLSetStmtAttr(hstmt, SQL_ATTR_CURSOR_TYPE, (SQLPOINTER) SQL_CURSOR_FORWARD_ONLY, 0);
+	CHECK_STMT_RESULT(rc, "SQLSetStmtAttr failed", hstmt);
+}
+
+int main(int argc, char **argv)
+{
+	static char *connopts[] = {
+		"ZeroCopyFetch=0",
+		"ZeroCopyFetch=1",
+		"ZeroCopyFetch=1;UseDeclareFetch=1;Fetch=5"
+	};
+	int			rc, i;
+	HSTMT		hstmt = SQL_NULL_HSTMT;
+
+	for (i = 0; i < sizeof(connopts) / sizeof(connopts[0]); i++)
+	{
+		printf("-- %s\n", connopts[i]);
+		test_connect_ext(connopts[i]);
+
+		rc = SQLAllocHandle(SQL_HANDLE_STMT, conn, &hstmt);
+		if (!SQL_SUCCEEDED(rc))
+		{
+			print_diag("failed to allocate stmt handle", SQL_HANDLE_DBC, conn);
+			exit(1);
+		}
+		fetch_bound(hstmt);
+		fetch_in_pieces(hstmt);
+		fetch_scrollable(hstmt);
+
+		test_disconnect();
+	}
+
+	return 0;
+}
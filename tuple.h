@@ -19,6 +19,8 @@
 struct TupleField_
 {
 	Int4	len;		/* PG length of the current Tuple */
+	char	pooled;		/* value is carved out of the tuple pool of
+				 * the owning QResultClass, never free() it */
 	void	*value;		/* an array representing the value */
 };
 
@@ -10,6 +10,7 @@
 #ifdef	UNICODE_SUPPORT
 
 #include "unicode_support.h"
+#include "misc.h"
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
@@ -121,6 +122,194 @@ int get_convtype(void)
 
 static int little_endian = -1;
 
+/*
+ * Vectorised fast paths for runs of ASCII characters.
+ *
+ * The blocks of 16 (SSE2) or 32 (AVX2) code units which are all in
+ * 0x01 - 0x7f are converted at once, anything else is left to the
+ * scalar code. AVX2 is used only if the CPU supports it at runtime.
+ * A NULL destination just counts the code units.
+ */
+#ifdef	USE_SSE2
+#include <emmintrin.h>
+#ifdef	USE_AVX2
+#include <immintrin.h>
+#endif /* USE_AVX2 */
+
+/* pack 16 UTF-16 code units to bytes, FALSE unless all are in 0x01 - 0x7f */
+static BOOL ascii_pack_16(const SQLWCHAR *src, __m128i *packed)
+{
+	__m128i	p = _mm_packus_epi16(_mm_loadu_si128((const __m128i *) src),
+				     _mm_loadu_si128((const __m128i *) (src + 8)));
+
+	/* 0x80 - 0x7fff keep the high bit, 0x8000 - 0xffff saturate to 0 */
+	if (0 != _mm_movemask_epi8(_mm_or_si128(p, _mm_cmpeq_epi8(p, _mm_setzero_si128()))))
+		return FALSE;
+	*packed = p;
+	return TRUE;
+}
+
+static __m128i ascii_lower_16(__m128i p)
+{
+	__m128i	upper = _mm_and_si128(_mm_cmpgt_epi8(p, _mm_set1_epi8('A' - 1)),
+				      _mm_cmplt_epi8(p, _mm_set1_epi8('Z' + 1)));
+
+	return _mm_add_epi8(p, _mm_and_si128(upper, _mm_set1_epi8(0x20)));
+}
+
+#ifdef	USE_AVX2
+AVX2_TARGET
+static SQLLEN ucs2_ascii_to_utf8_avx2(const SQLWCHAR *src, SQLLEN ilen, char *dst, BOOL lower_identifier)
+{
+	SQLLEN	i;
+
+	for (i = 0; i + 32 <= ilen; i += 32)
+	{
+		__m256i	p = _mm256_packus_epi16(_mm256_loadu_si256((const __m256i *) (src + i)),
+						_mm256_loadu_si256((const __m256i *) (src + i + 16)));
+
+		if (0 != _mm256_movemask_epi8(_mm256_or_si256(p, _mm256_cmpeq_epi8(p, _mm256_setzero_si256()))))
+			break;
+		if (NULL == dst)
+			continue;
+		/* packus works per 128-bit lane */
+		p = _mm256_permute4x64_epi64(p, 0xd8);
+		if (lower_identifier)
+		{
+			__m256i	upper = _mm256_and_si256(_mm256_cmpgt_epi8(p, _mm256_set1_epi8('A' - 1)),
+							 _mm256_cmpgt_epi8(_mm256_set1_epi8('Z' + 1), p));
+
+			p = _mm256_add_epi8(p, _mm256_and_si256(upper, _mm256_set1_epi8(0x20)));
+		}
+		_mm256_storeu_si256((__m256i *) (dst + i), p);
+	}
+	return i;
+}
+
+AVX2_TARGET
+static SQLLEN utf8_ascii_to_ucs2_avx2(const UCHAR *src, SQLLEN ilen, BOOL lfconv, SQLWCHAR *dst)
+{
+	SQLLEN	i;
+	const __m256i	zero = _mm256_setzero_si256(), lf = _mm256_set1_epi8(PG_LINEFEED);
+
+	for (i = 0; i + 32 <= ilen; i += 32)
+	{
+		__m256i	p = _mm256_loadu_si256((const __m256i *) (src + i));
+		__m256i	stop = _mm256_or_si256(p, _mm256_cmpeq_epi8(p, zero));
+
+		if (lfconv)
+			stop = _mm256_or_si256(stop, _mm256_cmpeq_epi8(p, lf));
+		if (0 != _mm256_movemask_epi8(stop))
+			break;
+		if (NULL == dst)
+			continue;
+		_mm256_storeu_si256((__m256i *) (dst + i), _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *) (src + i))));
+		_mm256_storeu_si256((__m256i *) (dst + i + 16), _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *) (src + i + 16))));
+	}
+	return i;
+}
+#endif /* USE_AVX2 */
+
+/*
+ * Convert the leading ASCII blocks of a UTF-16 string to UTF-8 and return
+ * the number of code units converted (0 if the first block isn't ASCII).
+ */
+static SQLLEN ucs2_ascii_to_utf8(const SQLWCHAR *src, SQLLEN ilen, char *dst, BOOL lower_identifier)
+{
+	SQLLEN	i = 0;
+	__m128i	p;
+
+	if (sizeof(SQLWCHAR) != 2)
+		return 0;
+#ifdef	USE_AVX2
+	if (ilen >= 32 && get_simd_level() >= 2)
+		i = ucs2_ascii_to_utf8_avx2(src, ilen, dst, lower_identifier);
+#endif /* USE_AVX2 */
+	for (; i + 16 <= ilen && ascii_pack_16(src + i, &p); i += 16)
+	{
+		if (NULL == dst)
+			continue;
+		if (lower_identifier)
+			p = ascii_lower_16(p);
+		_mm_storeu_si128((__m128i *) (dst + i), p);
+	}
+	return i;
+}
+
+/*
+ * Convert the leading ASCII blocks of a UTF-8 string to UTF-16 and return
+ * the number of bytes converted. The line feeds are left to the caller
+ * if lfconv.
+ */
+static SQLLEN utf8_ascii_to_ucs2(const UCHAR *src, SQLLEN ilen, BOOL lfconv, SQLWCHAR *dst)
+{
+	SQLLEN	i = 0;
+	const __m128i	zero = _mm_setzero_si128(), lf = _mm_set1_epi8(PG_LINEFEED);
+
+	if (sizeof(SQLWCHAR) != 2)
+		return 0;
+#ifdef	USE_AVX2
+	if (ilen >= 32 && get_simd_level() >= 2)
+		i = utf8_ascii_to_ucs2_avx2(src, ilen, lfconv, dst);
+#endif /* USE_AVX2 */
+	for (; i + 16 <= ilen; i += 16)
+	{
+		__m128i	p = _mm_loadu_si128((const __m128i *) (src + i));
+		__m128i	stop = _mm_or_si128(p, _mm_cmpeq_epi8(p, zero));
+
+		if (lfconv)
+			stop = _mm_or_si128(stop, _mm_cmpeq_epi8(p, lf));
+		if (0 != _mm_movemask_epi8(stop))
+			break;
+		if (NULL == dst)
+			continue;
+		_mm_storeu_si128((__m128i *) (dst + i), _mm_unpacklo_epi8(p, zero));
+		_mm_storeu_si128((__m128i *) (dst + i + 8), _mm_unpackhi_epi8(p, zero));
+	}
+	return i;
+}
+#else
+#define	ucs2_ascii_to_utf8(src, ilen, dst, lower_identifier)	0
+#define	utf8_ascii_to_ucs2(src, ilen, lfconv, dst)	0
+#endif /* USE_SSE2 */
+
+/*
+ * The length of the UTF-8 string ucs2_to_utf8() makes.
+ */
+static SQLLEN ucs2_utf8_length(const SQLWCHAR *ucs2str, SQLLEN ilen)
+{
+	SQLLEN	i, len = 0, run;
+	const SQLWCHAR	*wstr;
+
+	for (i = 0, wstr = ucs2str; i < ilen; i++, wstr++)
+	{
+		if (!*wstr)
+			break;
+		else if (0 == (*wstr & 0xffffff80)) /* ASCII */
+		{
+			if (run = ucs2_ascii_to_utf8(wstr, ilen - i, NULL, FALSE), run > 0)
+			{
+				len += run;
+				i += run - 1;
+				wstr += run - 1;
+			}
+			else
+				len++;
+		}
+		else if ((*wstr & byte3check) == 0)
+			len += 2;
+		else if (surrog1_bits == (*wstr & surrog_check))
+		{
+			wstr++;
+			i++;
+			len += 4;
+		}
+		else
+			len += 3;
+	}
+	return len;
+}
+
 SQLULEN	ucs2strlen(const SQLWCHAR *ucs2str)
 {
 	SQLULEN	len;
@@ -148,10 +337,10 @@ MYLOG(0, "%p ilen=" FORMAT_LEN " ", ucs2str, ilen);
 	if (ilen < 0)
 		ilen = ucs2strlen(ucs2str);
 MYPRINTF(0, " newlen=" FORMAT_LEN, ilen);
-	utf8str = (char *) malloc(ilen * 4 + 1);
+	utf8str = (char *) malloc(ucs2_utf8_length(ucs2str, ilen) + 1);
 	if (utf8str)
 	{
-		int	i = 0;
+		SQLLEN	i = 0, run;
 		UInt2	byte2code;
 		Int4	byte4code, surrd1, surrd2;
 		const SQLWCHAR	*wstr;
@@ -162,7 +351,13 @@ MYPRINTF(0, " newlen=" FORMAT_LEN, ilen);
 				break;
 			else if (0 == (*wstr & 0xffffff80)) /* ASCII */
 			{
-				if (lower_identifier)
+				if (run = ucs2_ascii_to_utf8(wstr, ilen - i, utf8str + len, lower_identifier), run > 0)
+				{
+					len += (int) run;
+					i += run - 1;
+					wstr += run - 1;
+				}
+				else if (lower_identifier)
 					utf8str[len++] = (char) tolower(*wstr);
 				else
 					utf8str[len++] = (char) *wstr;
@@ -259,7 +454,7 @@ SQLULEN
 utf8_to_ucs2_lf(const char *utf8str, SQLLEN ilen, BOOL lfconv,
 				SQLWCHAR *ucs2str, SQLULEN bufcount, BOOL errcheck)
 {
-	int			i;
+	SQLLEN		i, run;
 	SQLULEN		rtn, ocount, wcode;
 	const UCHAR *str;
 
@@ -278,6 +473,17 @@ MYPRINTF(DETAIL_LOG_LEVEL, " string=%s", utf8str);
 	{
 		if ((*str & 0x80) == 0)
 		{
+			/* convert an ASCII run up to the buffer end, count the rest */
+			run = ilen - i;
+			if (ocount < bufcount && bufcount - ocount < (SQLULEN) run)
+				run = (SQLLEN) (bufcount - ocount);
+			if (run = utf8_ascii_to_ucs2(str, run, lfconv, ocount < bufcount ? ucs2str + ocount : NULL), run > 0)
+			{
+				ocount += run;
+				i += run;
+				str += run;
+				continue;
+			}
 			if (lfconv && PG_LINEFEED == *str &&
 			    (i == 0 || PG_CARRIAGE_RETURN != str[-1]))
 			{